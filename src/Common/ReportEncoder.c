@@ -0,0 +1,109 @@
+#include "ReportEncoder.h"
+
+/** Checks whether a scancode is one of the first \c Count entries of a keycode list. */
+static bool ReportEncoder_HasKey(const uint8_t* const KeyCode, const uint8_t Count, const uint8_t Key)
+{
+	for (uint8_t i = 0; i < Count; i++)
+	{
+		if (KeyCode[i] == Key)
+		  return true;
+	}
+
+	return false;
+}
+
+/** Counts the keys held in a report; the encoder always fills the keycode slots from the first one. */
+static uint8_t ReportEncoder_HeldKeys(const USB_KeyboardReport_Data_t* const KeyboardReport)
+{
+	uint8_t HeldKeys = 0;
+
+	while ((HeldKeys < REPORT_ENCODER_MAX_KEYS) && KeyboardReport->KeyCode[HeldKeys])
+	  HeldKeys++;
+
+	return HeldKeys;
+}
+
+/** Clears the typing throughput counters of an encoder.
+ *
+ *  \param[out] Encoder  Encoder whose counters are to be cleared
+ */
+void ReportEncoder_ClearCounters(ReportEncoder_t* const Encoder)
+{
+	Encoder->TypedKeys    = 0;
+	Encoder->TypedReports = 0;
+}
+
+/** Checks whether a report releases all keys.
+ *
+ *  \param[in] KeyboardReport  Report to check
+ *
+ *  \return Boolean \c true if no keys are held by the report
+ */
+bool ReportEncoder_IsReleased(const USB_KeyboardReport_Data_t* const KeyboardReport)
+{
+	return (KeyboardReport->KeyCode[0] == 0);
+}
+
+/** Builds the next keyboard report from a key stream, packing as many keys into it as can be pressed
+ *  together. Keys are taken in stream order while they share the modifier of the first key, were not held
+ *  in the previous report and have a higher scancode than the key before them. Hosts report the keys of a
+ *  single report either in the order of its keycode slots or in scancode order; keeping the two the same
+ *  preserves typing order on both.
+ *
+ *  Distinct keys follow each other directly, without an empty report in between. A key that was held in
+ *  the previous report cannot be pressed again until it has been released, and some hosts apply a changed
+ *  modifier to keys that are still held, so in those two cases the report is left empty to release the
+ *  previous keys first.
+ *
+ *  The previous report is the one last handed to the HID class driver, i.e. the one the host currently
+ *  holds. The report built is only worth sending when it differs from it; otherwise the class driver is
+ *  left to resend it once the host-requested idle period expires.
+ *
+ *  \param[in,out] Encoder             Encoder state
+ *  \param[in,out] Stream              Stream the keys are taken from
+ *  \param[in]     PrevKeyboardReport  Report last handed to the HID class driver
+ *  \param[out]    KeyboardReport      Zeroed report to fill
+ *
+ *  \return Boolean \c true if the report built differs from the previous report
+ */
+bool ReportEncoder_CreateReport(ReportEncoder_t* const Encoder,
+                                SecretStream_t* const Stream,
+                                const USB_KeyboardReport_Data_t* const PrevKeyboardReport,
+                                USB_KeyboardReport_Data_t* const KeyboardReport)
+{
+	uint8_t PrevKeyCodes = ReportEncoder_HeldKeys(PrevKeyboardReport);
+	uint8_t UsedKeyCodes = 0;
+	key_t   CurrentKey;
+
+	while ((UsedKeyCodes < REPORT_ENCODER_MAX_KEYS) && SecretStream_Peek(Stream, &CurrentKey))
+	{
+		#if defined(REPORT_ENCODER_ALWAYS_RELEASE)
+		if (PrevKeyCodes)
+		  break;
+		#endif
+
+		if (PrevKeyCodes && (CurrentKey.mod != PrevKeyboardReport->Modifier))
+		  break;
+
+		if (UsedKeyCodes && (CurrentKey.mod != KeyboardReport->Modifier))
+		  break;
+
+		if (UsedKeyCodes && (CurrentKey.key <= KeyboardReport->KeyCode[UsedKeyCodes - 1]))
+		  break;
+
+		if (ReportEncoder_HasKey(PrevKeyboardReport->KeyCode, PrevKeyCodes, CurrentKey.key))
+		  break;
+
+		SecretStream_Read(Stream, &CurrentKey);
+
+		KeyboardReport->Modifier = CurrentKey.mod;
+		KeyboardReport->KeyCode[UsedKeyCodes++] = CurrentKey.key;
+	}
+
+	if (!(UsedKeyCodes || PrevKeyCodes))
+	  return false;
+
+	Encoder->TypedKeys += UsedKeyCodes;
+	Encoder->TypedReports++;
+	return true;
+}
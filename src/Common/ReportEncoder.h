@@ -0,0 +1,56 @@
+/** \file
+ *
+ *  Header file for ReportEncoder.c.
+ */
+
+#ifndef _REPORTENCODER_H_
+#define _REPORTENCODER_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include "SecretStream.h"
+
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Macros: */
+		/** Maximum number of keys pressed together in a single keyboard report. This may not exceed the six
+		 *  keycode slots of the boot protocol report declared by \c HID_DESCRIPTOR_KEYBOARD() in Descriptors.c,
+		 *  and can be lowered to one for hosts which drop keys that arrive in the same report.
+		 */
+		#if !defined(REPORT_ENCODER_MAX_KEYS)
+			#define REPORT_ENCODER_MAX_KEYS   6
+		#endif
+
+		#if (REPORT_ENCODER_MAX_KEYS < 1) || (REPORT_ENCODER_MAX_KEYS > 6)
+			#error REPORT_ENCODER_MAX_KEYS must be between 1 and 6.
+		#endif
+
+		/** Define to send an empty report after every keystroke report, as the original typing path did, rather
+		 *  than moving straight on to the next keys. Only useful to measure the gain of release elision.
+		 */
+		#if defined(__DOXYGEN__)
+			#define REPORT_ENCODER_ALWAYS_RELEASE
+		#endif
+
+	/* Type Defines: */
+		/** Type define for the state of a report encoder, which turns a stream of keys into a sequence of
+		 *  keyboard reports. The keys held by the host are not kept here, but read back from the previous
+		 *  report buffer which the HID class driver already maintains.
+		 */
+		typedef struct
+		{
+			uint16_t TypedKeys;    /**< Number of keys typed since the counters were cleared */
+			uint16_t TypedReports; /**< Number of reports spent typing them, releases included */
+		} ReportEncoder_t;
+
+	/* Function Prototypes: */
+		void ReportEncoder_ClearCounters(ReportEncoder_t* const Encoder);
+		bool ReportEncoder_IsReleased(const USB_KeyboardReport_Data_t* const KeyboardReport);
+		bool ReportEncoder_CreateReport(ReportEncoder_t* const Encoder,
+		                                SecretStream_t* const Stream,
+		                                const USB_KeyboardReport_Data_t* const PrevKeyboardReport,
+		                                USB_KeyboardReport_Data_t* const KeyboardReport);
+#endif
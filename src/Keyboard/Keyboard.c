@@ -40,18 +40,15 @@
 #define LED_EN      (DDRD  |= 0b01100000) // enable leds as output
 #define HWBIN_EN    (DDRD  &= 0b01111111) // make hwb an input
 
-uint16_t SecLength;
-uint16_t SecCounter;
-
 extern void led_red(char);
 extern void led_blue(char);
 extern char hwb_is_pressed(void);
 
-/** Circular buffer to hold data from the keystorage before it is sent to the device via the HID. */
-static RingBuffer_t Secret2USB_Buffer;
+/** Read cursor over the stored secret, advanced as keys are typed via the HID interface. */
+static SecretStream_t SecretStream;
 
-/** Underlying data buffer for \ref Secret2USB_Buffer, where the stored bytes are located. */
-static uint8_t      Secret2USB_Buffer_Data[128];
+/** Encoder packing the keys of \ref SecretStream into keyboard reports. */
+static ReportEncoder_t SecretEncoder;
 
 /** Buffer to hold the previously generated Keyboard HID report, for comparison purposes inside the HID class driver. */
 static uint8_t PrevKeyboardHIDReportBuffer[sizeof(USB_KeyboardReport_Data_t)];
@@ -85,17 +82,7 @@ int main(void)
 	SetupHardware();
 	led_red(1);
 
-	SecLength = sizeof(secret) / sizeof(secret[0]);
-	SecCounter = 0;
-
-	RingBuffer_InitBuffer(&Secret2USB_Buffer, Secret2USB_Buffer_Data, sizeof(Secret2USB_Buffer_Data));
-	uint16_t SecLen = sizeof(secret) / sizeof(secret[0]);
-	uint16_t SecCnt = SecLen;
-
-	while (SecCnt--) {
-		key_t currentKey = (key_t)secret[SecLen-SecCnt];
-		RingBuffer_Insert(&Secret2USB_Buffer, currentKey.key);
-	}
+	SecretStream_Open(&SecretStream, secret, SECRET_LENGTH);
 
 	GlobalInterruptEnable();
 
@@ -103,7 +90,7 @@ int main(void)
 	{
 		HID_Device_USBTask(&Keyboard_HID_Interface);
 		USB_USBTask();
-		if (SecLength == SecCnt)
+		if (SecretStream_IsEmpty(&SecretStream))
 		{
 			led_blue(1);
 			led_red(0);
@@ -179,15 +166,19 @@ bool CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDIn
                                          uint16_t* const ReportSize)
 {
 	USB_KeyboardReport_Data_t* KeyboardReport = (USB_KeyboardReport_Data_t*)ReportData;
-	uint8_t UsedKeyCodes = 0;
 
-	if (SecCounter < SecLength && hwb_is_pressed()) {
-		key_t currentKey = (key_t)secret[SecCounter++];
-		KeyboardReport->Modifier = currentKey.mod;
-		KeyboardReport->KeyCode[UsedKeyCodes++] = currentKey.key;
+	bool ReportChanged = false;
+
+	if (hwb_is_pressed())
+	{
+		ReportChanged = ReportEncoder_CreateReport(&SecretEncoder, &SecretStream,
+		                                           (USB_KeyboardReport_Data_t*)PrevKeyboardHIDReportBuffer, KeyboardReport);
 	}
+
 	*ReportSize = sizeof(USB_KeyboardReport_Data_t);
-	return true;
+
+	/* Only force a send when the keys changed; the class driver resends unchanged reports when the idle period expires */
+	return ReportChanged;
 }
 
 /** HID class driver callback function for the processing of HID reports from the host.
@@ -45,6 +45,7 @@
 		#include <string.h>
 
 		#include "Descriptors.h"
+		#include "ReportEncoder.h"
 		#include "Secret.h"
 
 		#include <LUFA/Drivers/Board/LEDs.h>
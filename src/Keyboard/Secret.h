@@ -1,14 +1,9 @@
 #ifndef _SECRET_H
 #define _SECRET_H
 
-typedef struct {
-	uint8_t key;
-	uint8_t mod;
-} key_t;
+#include "SecretStream.h"
 
-#define HID_KEYBOARD_MODIFIER_NONE 0
-
-static const key_t secret[] =
+static const key_t secret[] PROGMEM =
 {
   {HID_KEYBOARD_SC_S, HID_KEYBOARD_MODIFIER_NONE},
   {HID_KEYBOARD_SC_E, HID_KEYBOARD_MODIFIER_NONE},
@@ -18,4 +13,6 @@ static const key_t secret[] =
   {HID_KEYBOARD_SC_T, HID_KEYBOARD_MODIFIER_NONE}
 };
 
+#define SECRET_LENGTH (sizeof(secret) / sizeof(secret[0]))
+
 #endif
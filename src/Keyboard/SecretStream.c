@@ -0,0 +1,58 @@
+#include "SecretStream.h"
+
+/** Points a stream at the start of a secret table.
+ *
+ *  \param[out] Stream  Stream to open
+ *  \param[in]  Keys    First key of the secret table, in FLASH memory
+ *  \param[in]  Count   Number of keys in the secret table
+ */
+void SecretStream_Open(SecretStream_t* const Stream, const key_t* const Keys, const uint16_t Count)
+{
+	Stream->Keys     = Keys;
+	Stream->Position = 0;
+	Stream->Length   = Count;
+}
+
+/** Fetches the next key of the secret without advancing the stream, so that the caller can decide whether
+ *  the key fits into the report currently being built.
+ *
+ *  \param[in]  Stream  Stream to read from
+ *  \param[out] Key     Location where the key and its modifier are stored
+ *
+ *  \return Boolean \c true if a key was read, \c false if the end of the secret has been reached
+ */
+bool SecretStream_Peek(const SecretStream_t* const Stream, key_t* const Key)
+{
+	if (Stream->Position == Stream->Length)
+	  return false;
+
+	*Key = Secret_ReadKey_P(Stream->Keys, Stream->Position);
+	return true;
+}
+
+/** Fetches the next key of the secret and advances the stream past it.
+ *
+ *  \param[in,out] Stream  Stream to read from
+ *  \param[out]    Key     Location where the key and its modifier are stored
+ *
+ *  \return Boolean \c true if a key was read, \c false if the end of the secret has been reached
+ */
+bool SecretStream_Read(SecretStream_t* const Stream, key_t* const Key)
+{
+	if (Stream->Position == Stream->Length)
+	  return false;
+
+	*Key = Secret_ReadKey_P(Stream->Keys, Stream->Position++);
+	return true;
+}
+
+/** Checks whether every key of the secret has been read.
+ *
+ *  \param[in] Stream  Stream to check
+ *
+ *  \return Boolean \c true if no keys remain in the stream
+ */
+bool SecretStream_IsEmpty(const SecretStream_t* const Stream)
+{
+	return (Stream->Position == Stream->Length);
+}
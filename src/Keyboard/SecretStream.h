@@ -0,0 +1,57 @@
+/** \file
+ *
+ *  Header file for SecretStream.c.
+ */
+
+#ifndef _SECRETSTREAM_H_
+#define _SECRETSTREAM_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+
+	/* Macros: */
+		/** Modifier value for a key which is typed without any modifier keys held. */
+		#define HID_KEYBOARD_MODIFIER_NONE 0
+
+	/* Type Defines: */
+		/** Type define for a single stored keystroke, as a HID scancode and the modifier mask it is typed with. */
+		typedef struct {
+			uint8_t key;
+			uint8_t mod;
+		} key_t;
+
+		/** Type define for a read cursor over a stored secret. Keys are fetched from the FLASH secret table one
+		 *  at a time as HID reports are built, so the RAM cost is that of the cursor whatever the secret length.
+		 */
+		typedef struct
+		{
+			const key_t* Keys;     /**< Secret table being read, in FLASH memory */
+			uint16_t     Position; /**< Index of the next key to be returned from the table */
+			uint16_t     Length;   /**< Number of keys in the table */
+		} SecretStream_t;
+
+	/* Inline Functions: */
+		/** Reads a single key from a secret table located in FLASH memory. Each \ref key_t is two bytes wide, so
+		 *  the scancode and its modifier are fetched together with a single \c pgm_read_word().
+		 *
+		 *  \param[in] Keys   Secret table in FLASH memory
+		 *  \param[in] Index  Index of the key to read
+		 *
+		 *  \return The key at the given index of the table
+		 */
+		static inline key_t Secret_ReadKey_P(const key_t* const Keys, const uint16_t Index)
+		{
+			uint16_t Word = pgm_read_word(&Keys[Index]);
+			key_t    Key  = {.key = (Word & 0xFF), .mod = (Word >> 8)};
+
+			return Key;
+		}
+
+	/* Function Prototypes: */
+		void SecretStream_Open(SecretStream_t* const Stream, const key_t* const Keys, const uint16_t Count);
+		bool SecretStream_Peek(const SecretStream_t* const Stream, key_t* const Key);
+		bool SecretStream_Read(SecretStream_t* const Stream, key_t* const Key);
+		bool SecretStream_IsEmpty(const SecretStream_t* const Stream);
+#endif
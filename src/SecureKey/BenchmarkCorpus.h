@@ -0,0 +1,68 @@
+#ifndef _BENCHMARK_CORPUS_H
+#define _BENCHMARK_CORPUS_H
+
+#include "SecretStream.h"
+
+/* "The quick brown fox jumps over the lazy dog 1234567890" followed by Enter; must match the corpus in Tools/typing-bench.py */
+static const uint8_t BenchmarkCorpus[] PROGMEM =
+{
+  SECRET_PACKED_SHIFTED(HID_KEYBOARD_SC_T),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_H),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_E),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_Q),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_U),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_I),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_C),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_K),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_B),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_R),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_O),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_W),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_N),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_F),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_O),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_X),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_J),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_U),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_M),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_P),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_S),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_O),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_V),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_E),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_R),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_T),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_H),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_E),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_L),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_A),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_Z),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_Y),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_D),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_O),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_G),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_SPACE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_1_AND_EXCLAMATION),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_2_AND_AT),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_3_AND_HASHMARK),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_4_AND_DOLLAR),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_5_AND_PERCENTAGE),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_6_AND_CARET),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_7_AND_AMPERSAND),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_8_AND_ASTERISK),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_9_AND_OPENING_PARENTHESIS),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_0_AND_CLOSING_PARENTHESIS),
+  SECRET_PACKED_KEY(HID_KEYBOARD_SC_ENTER)
+};
+
+#define BENCHMARK_CORPUS_LENGTH sizeof(BenchmarkCorpus)
+
+#endif
@@ -0,0 +1,100 @@
+/** \file
+ *
+ *  Byte sources, reading the bytes of a secret from wherever it is held: a run of FLASH memory or EEPROM, or a ring
+ *  buffer which another task fills as the bytes arrive. Only the cursor is kept in RAM, whatever the length of the
+ *  data.
+ */
+
+#include "ByteSource.h"
+
+/** Opens a source over bytes in FLASH memory.
+ *
+ *  \param[out] Source  Source to open
+ *  \param[in]  Data    Data in FLASH memory
+ *  \param[in]  Length  Length of the data in bytes
+ */
+void ByteSource_Open(ByteSource_t* const Source, const uint8_t* const Data, const uint16_t Length)
+{
+	Source->Data     = Data;
+	Source->Position = 0;
+	Source->Length   = Length;
+	Source->Queue    = NULL;
+	Source->Mode     = BYTESOURCE_MODE_FLASH;
+}
+
+/** Opens a source over bytes in EEPROM.
+ *
+ *  \param[out] Source  Source to open
+ *  \param[in]  Data    Data in EEPROM
+ *  \param[in]  Length  Length of the data in bytes
+ */
+void ByteSource_OpenEEPROM(ByteSource_t* const Source, const uint8_t* const Data, const uint16_t Length)
+{
+	ByteSource_Open(Source, Data, Length);
+	Source->Mode = BYTESOURCE_MODE_EEPROM;
+}
+
+/** Opens a source over bytes queued into a ring buffer by another task. The source runs dry whenever the buffer is
+ *  empty, and reads on from where it left off once more bytes have been queued.
+ *
+ *  \param[out] Source  Source to open
+ *  \param[in]  Queue   Ring buffer holding the bytes
+ */
+void ByteSource_OpenQueue(ByteSource_t* const Source, RingBuffer_t* const Queue)
+{
+	ByteSource_Open(Source, NULL, 0);
+	Source->Queue = Queue;
+	Source->Mode  = BYTESOURCE_MODE_Queue;
+}
+
+/** Reads the next byte from a source.
+ *
+ *  \param[in,out] Source  Source to read from
+ *  \param[out]    Byte    Location where the byte is stored
+ *
+ *  \return Boolean \c true if a byte was read, \c false at the end of the data or while the queue is empty
+ */
+bool ByteSource_ReadByte(ByteSource_t* const Source, uint8_t* const Byte)
+{
+	if (Source->Mode == BYTESOURCE_MODE_Queue)
+	{
+		if (RingBuffer_IsEmpty(Source->Queue))
+		  return false;
+
+		*Byte = RingBuffer_Remove(Source->Queue);
+		return true;
+	}
+
+	if (Source->Position >= Source->Length)
+	  return false;
+
+	if (Source->Mode == BYTESOURCE_MODE_EEPROM)
+	  *Byte = eeprom_read_byte(&Source->Data[Source->Position++]);
+	else
+	  *Byte = pgm_read_byte(&Source->Data[Source->Position++]);
+
+	return true;
+}
+
+/** Retrieves the number of bytes which can be read from a source without it running dry.
+ *
+ *  \param[in] Source  Source to check
+ *
+ *  \return Number of bytes left in the data, or queued in the ring buffer
+ */
+uint16_t ByteSource_GetRemaining(const ByteSource_t* const Source)
+{
+	if (Source->Mode == BYTESOURCE_MODE_Queue)
+	  return RingBuffer_GetCount(Source->Queue);
+
+	return (Source->Length - Source->Position);
+}
+
+/** Moves a source over data in FLASH memory or EEPROM to the end of its data, so that nothing more is read from it.
+ *
+ *  \param[in,out] Source  Source to close
+ */
+void ByteSource_Close(ByteSource_t* const Source)
+{
+	Source->Position = Source->Length;
+}
@@ -0,0 +1,47 @@
+/** \file
+ *
+ *  Header file for ByteSource.c.
+ */
+
+#ifndef _BYTESOURCE_H_
+#define _BYTESOURCE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/eeprom.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+		#include <stddef.h>
+
+		#include <LUFA/Drivers/Misc/RingBuffer.h>
+
+	/* Enums: */
+		/** Enum for the memory a byte source reads from. */
+		enum ByteSourceModes_t
+		{
+			BYTESOURCE_MODE_FLASH,  /**< Bytes are read from FLASH memory */
+			BYTESOURCE_MODE_EEPROM, /**< Bytes are read from EEPROM */
+			BYTESOURCE_MODE_Queue,  /**< Bytes are taken from a ring buffer as they arrive */
+		};
+
+	/* Type Defines: */
+		/** Type define for a read cursor over a run of bytes in FLASH memory or EEPROM, or over a ring buffer which
+		 *  another task queues bytes into.
+		 */
+		typedef struct
+		{
+			const uint8_t* Data;     /**< Bytes to read, in FLASH memory or EEPROM */
+			uint16_t       Position; /**< Offset of the next byte of \c Data to read */
+			uint16_t       Length;   /**< Length of \c Data in bytes */
+			RingBuffer_t*  Queue;    /**< Ring buffer the bytes are taken from, if queued */
+			uint8_t        Mode;     /**< Memory the bytes are read from, a \ref ByteSourceModes_t value */
+		} ByteSource_t;
+
+	/* Function Prototypes: */
+		void     ByteSource_Open(ByteSource_t* const Source, const uint8_t* const Data, const uint16_t Length);
+		void     ByteSource_OpenEEPROM(ByteSource_t* const Source, const uint8_t* const Data, const uint16_t Length);
+		void     ByteSource_OpenQueue(ByteSource_t* const Source, RingBuffer_t* const Queue);
+		bool     ByteSource_ReadByte(ByteSource_t* const Source, uint8_t* const Byte);
+		uint16_t ByteSource_GetRemaining(const ByteSource_t* const Source);
+		void     ByteSource_Close(ByteSource_t* const Source);
+#endif
@@ -0,0 +1,123 @@
+/** \file
+ *
+ *  Block transfers between the CDC data endpoints and ring buffers. Unlike \c CDC_Device_ReceiveByte() and
+ *  \c CDC_Device_SendByte(), which select the endpoint and check its state for every byte, each call here
+ *  selects the endpoint once and moves a whole packet.
+ */
+
+#include "CDCPipe.h"
+
+/** Checks whether the CDC interface is ready for data transfers, following the same rule as the CDC class driver. */
+static bool CDCPipe_IsReady(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	return ((USB_DeviceState == DEVICE_STATE_Configured) && CDCInterfaceInfo->State.LineEncoding.BaudRateBPS);
+}
+
+/** Drains the CDC data OUT endpoint into a ring buffer. A packet is only acknowledged to the host once all of its
+ *  bytes have been taken, so while the buffer is full the remainder stays in the endpoint and the host is held
+ *  off by NAKs until there is room again.
+ *
+ *  \param[in,out] CDCInterfaceInfo  Pointer to the CDC class interface configuration structure being referenced
+ *  \param[in,out] Buffer            Ring buffer where the received bytes are stored
+ */
+void CDCPipe_Receive(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, RingBuffer_t* const Buffer)
+{
+	if (!(CDCPipe_IsReady(CDCInterfaceInfo)))
+	  return;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataOUTEndpoint.Address);
+
+	if (!(Endpoint_IsOUTReceived()))
+	  return;
+
+	uint16_t BytesInEndpoint = Endpoint_BytesInEndpoint();
+	uint16_t FreeCount       = RingBuffer_GetFreeCount(Buffer);
+
+	while (BytesInEndpoint && FreeCount)
+	{
+		RingBuffer_Insert(Buffer, Endpoint_Read_8());
+
+		BytesInEndpoint--;
+		FreeCount--;
+	}
+
+	if (!(BytesInEndpoint))
+	  Endpoint_ClearOUT();
+}
+
+/** Sends the contents of a ring buffer through the CDC data IN endpoint, a full packet at a time where the buffer
+ *  holds enough data. Nothing is sent while the endpoint bank is still busy with the previous packet. A transfer
+ *  which ends on a full packet is terminated with a zero length packet on the next call, for the host to complete
+ *  its read.
+ *
+ *  \param[in,out] CDCInterfaceInfo  Pointer to the CDC class interface configuration structure being referenced
+ *  \param[in,out] Pipe              State of the data path of the interface
+ *  \param[in,out] Buffer            Ring buffer holding the bytes to send
+ */
+void CDCPipe_Send(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, CDCPipe_t* const Pipe,
+                  RingBuffer_t* const Buffer)
+{
+	if (!(CDCPipe_IsReady(CDCInterfaceInfo)))
+	  return;
+
+	uint16_t Count = RingBuffer_GetCount(Buffer);
+
+	if (!(Count || Pipe->ZLPPending))
+	  return;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+
+	if (!(Endpoint_IsINReady()))
+	  return;
+
+	uint16_t PacketSize = CDCInterfaceInfo->Config.DataINEndpoint.Size;
+	uint16_t BytesToSend = (Count < PacketSize) ? Count : PacketSize;
+
+	for (uint16_t i = 0; i < BytesToSend; i++)
+	  Endpoint_Write_8(RingBuffer_Remove(Buffer));
+
+	Endpoint_ClearIN();
+
+	Pipe->ZLPPending = ((BytesToSend == PacketSize) && (Count == PacketSize));
+}
+
+/** Queues a string from RAM for sending through \ref CDCPipe_Send(). This never waits for the host: a string that
+ *  does not fit into the free space of the buffer is dropped whole, so that the host never sees half a message.
+ *
+ *  \param[in,out] Buffer  Ring buffer holding the bytes to send
+ *  \param[in]     String  Null terminated string to queue
+ *
+ *  \return Boolean \c true if the string was queued, \c false if it was dropped
+ */
+bool CDCPipe_QueueString(RingBuffer_t* const Buffer, const char* const String)
+{
+	uint16_t Length = strlen(String);
+
+	if (Length > RingBuffer_GetFreeCount(Buffer))
+	  return false;
+
+	for (uint16_t i = 0; i < Length; i++)
+	  RingBuffer_Insert(Buffer, String[i]);
+
+	return true;
+}
+
+/** Queues a string from FLASH for sending through \ref CDCPipe_Send(), in the same way as \ref CDCPipe_QueueString().
+ *
+ *  \param[in,out] Buffer  Ring buffer holding the bytes to send
+ *  \param[in]     String  Null terminated string to queue, in FLASH memory
+ *
+ *  \return Boolean \c true if the string was queued, \c false if it was dropped
+ */
+bool CDCPipe_QueueString_P(RingBuffer_t* const Buffer, const char* const String)
+{
+	uint16_t Length = strlen_P(String);
+
+	if (Length > RingBuffer_GetFreeCount(Buffer))
+	  return false;
+
+	for (uint16_t i = 0; i < Length; i++)
+	  RingBuffer_Insert(Buffer, pgm_read_byte(&String[i]));
+
+	return true;
+}
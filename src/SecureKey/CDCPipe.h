@@ -0,0 +1,34 @@
+/** \file
+ *
+ *  Header file for CDCPipe.c.
+ */
+
+#ifndef _CDCPIPE_H_
+#define _CDCPIPE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include <LUFA/Drivers/Misc/RingBuffer.h>
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Type Defines: */
+		/** Type define for the state of the data path of a CDC interface, one per interface, kept by the caller
+		 *  beside the class driver interface structure.
+		 */
+		typedef struct
+		{
+			bool ZLPPending; /**< Last packet sent was full and ended the data, so a zero length packet is owed */
+		} CDCPipe_t;
+
+	/* Function Prototypes: */
+		void CDCPipe_Receive(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, RingBuffer_t* const Buffer);
+		void CDCPipe_Send(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, CDCPipe_t* const Pipe,
+		                  RingBuffer_t* const Buffer);
+
+		bool CDCPipe_QueueString(RingBuffer_t* const Buffer, const char* const String);
+		bool CDCPipe_QueueString_P(RingBuffer_t* const Buffer, const char* const String);
+#endif
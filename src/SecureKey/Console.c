@@ -0,0 +1,256 @@
+/** \file
+ *
+ *  Line based command console over a pair of ring buffers. Typed characters are echoed with simple line editing,
+ *  and complete lines are looked up in a command table in FLASH memory. Input is only taken while there is room
+ *  for its echo, and commands only run while there is room for their output, so the console never blocks and
+ *  the host is held off by the input buffer filling up.
+ */
+
+#include "Console.h"
+
+/** Built in command handler listing the command table. */
+static bool Console_Help(Console_t* const Console, RingBuffer_t* const Output)
+{
+	ConsoleCommand_t Command;
+	char             Message[CONSOLE_OUTPUT_RESERVE];
+
+	if (Console->Step >= Console->CommandCount)
+	  return true;
+
+	memcpy_P(&Command, &Console->Commands[Console->Step], sizeof(ConsoleCommand_t));
+
+	snprintf_P(Message, sizeof(Message), PSTR("%-8s%s\r\n"), Command.Name, Command.Help);
+	CDCPipe_QueueString(Output, Message);
+
+	return ((Console->Step + 1) >= Console->CommandCount);
+}
+
+/** Built in command handler for a line which names no command. */
+static bool Console_Unknown(Console_t* const Console, RingBuffer_t* const Output)
+{
+	Console_QueueMessage_P(Output, PSTR("Unknown command, try help"));
+	return true;
+}
+
+/** Splits a complete line into its command and arguments, and starts the command. */
+static void Console_Execute(Console_t* const Console)
+{
+	char* Name = Console->Line;
+
+	Console->Line[Console->LineLength] = '\0';
+	Console->LineLength = 0;
+
+	while (*Name == ' ')
+	  Name++;
+
+	if (!(*Name))
+	{
+		Console->PromptPending = true;
+		return;
+	}
+
+	char* Args = Name;
+
+	while (*Args && (*Args != ' '))
+	  Args++;
+
+	if (*Args)
+	  *(Args++) = '\0';
+
+	while (*Args == ' ')
+	  Args++;
+
+	Console->Args    = Args;
+	Console->Step    = 0;
+	Console->Running = Console_Unknown;
+
+	if (!(strcmp_P(Name, PSTR("help"))))
+	{
+		Console->Running = Console_Help;
+		return;
+	}
+
+	for (uint8_t Index = 0; Index < Console->CommandCount; Index++)
+	{
+		if (!(strcmp_P(Name, Console->Commands[Index].Name)))
+		{
+			Console->Running = (ConsoleHandler_t)pgm_read_ptr(&Console->Commands[Index].Run);
+			return;
+		}
+	}
+}
+
+/** Sets up a console with a command table. The prompt is queued on the first run of \ref Console_Task().
+ *
+ *  \param[out] Console       Console to set up
+ *  \param[in]  Commands      Command table in FLASH memory
+ *  \param[in]  CommandCount  Number of entries in the command table
+ */
+void Console_Init(Console_t* const Console, const ConsoleCommand_t* const Commands, const uint8_t CommandCount)
+{
+	memset(Console, 0, sizeof(Console_t));
+
+	Console->Commands      = Commands;
+	Console->CommandCount  = CommandCount;
+	Console->PromptPending = true;
+}
+
+/** Runs the console for as long as it can make progress: the running command is stepped once per call while there is
+ *  room for its output, so that a command waiting on other tasks lets them run, and input characters are taken and
+ *  echoed while there is room for the echo.
+ *
+ *  \param[in,out] Console  Console to run
+ *  \param[in,out] Input    Ring buffer of characters typed by the host
+ *  \param[in,out] Output   Ring buffer of characters for the host
+ */
+void Console_Task(Console_t* const Console, RingBuffer_t* const Input, RingBuffer_t* const Output)
+{
+	for (;;)
+	{
+		if (Console->Running != NULL)
+		{
+			if (RingBuffer_GetFreeCount(Output) < CONSOLE_OUTPUT_RESERVE)
+			  return;
+
+			if (!(Console->Running(Console, Output)))
+			{
+				/* Commands waiting on other tasks may run for many steps, which must never wrap back to the first */
+				if (Console->Step != 0xFF)
+				  Console->Step++;
+
+				return;
+			}
+
+			Console->Running       = NULL;
+			Console->PromptPending = true;
+		}
+
+		if (Console->PromptPending)
+		{
+			if (!(CDCPipe_QueueString_P(Output, PSTR("> "))))
+			  return;
+
+			Console->PromptPending = false;
+		}
+
+		/* Leave room for the longest echo, the erasure of a character */
+		if (RingBuffer_IsEmpty(Input) || (RingBuffer_GetFreeCount(Output) < 3))
+		  return;
+
+		uint8_t Character = RingBuffer_Remove(Input);
+		bool    LastWasCR = Console->LastWasCR;
+
+		Console->LastWasCR = (Character == '\r');
+
+		if ((Character == '\r') || (Character == '\n'))
+		{
+			/* A CR LF pair ends a single line */
+			if ((Character == '\n') && LastWasCR)
+			  continue;
+
+			CDCPipe_QueueString_P(Output, PSTR("\r\n"));
+			Console_Execute(Console);
+		}
+		else if ((Character == '\b') || (Character == 0x7F))
+		{
+			if (Console->LineLength)
+			{
+				Console->LineLength--;
+				CDCPipe_QueueString_P(Output, PSTR("\b \b"));
+			}
+		}
+		else if ((Character >= ' ') && (Character < 0x7F) && (Console->LineLength < (CONSOLE_LINE_SIZE - 1)))
+		{
+			Console->Line[Console->LineLength++] = Character;
+			RingBuffer_Insert(Output, Character);
+		}
+	}
+}
+
+/** Decodes a string of hexadecimal digit pairs into bytes in place, over the start of the string.
+ *
+ *  \param[in,out] Text    String of hex digits, overwritten with the decoded bytes
+ *  \param[out]    Length  Number of decoded bytes
+ *
+ *  \return Boolean \c true if the string held only whole pairs of hex digits, \c false otherwise
+ */
+bool Console_DecodeHex(char* const Text, uint8_t* const Length)
+{
+	uint8_t Count = 0;
+
+	for (const char* Digits = Text; *Digits; Digits += 2)
+	{
+		uint8_t Byte = 0;
+
+		for (uint8_t Nibble = 0; Nibble < 2; Nibble++)
+		{
+			char Digit = Digits[Nibble];
+
+			if ((Digit >= '0') && (Digit <= '9'))
+			  Byte = (Byte << 4) | (Digit - '0');
+			else if ((Digit >= 'a') && (Digit <= 'f'))
+			  Byte = (Byte << 4) | (Digit - 'a' + 10);
+			else if ((Digit >= 'A') && (Digit <= 'F'))
+			  Byte = (Byte << 4) | (Digit - 'A' + 10);
+			else
+			  return false;
+		}
+
+		Text[Count++] = Byte;
+	}
+
+	*Length = Count;
+	return true;
+}
+
+/** Parses a decimal number at the start of the arguments of a command. The number must be followed by a space or
+ *  the end of the arguments, and saturates at 65535 rather than wrapping, so that callers range checking the value
+ *  never see a large number alias a small one.
+ *
+ *  \param[in]  Text   Arguments to parse
+ *  \param[out] Value  Parsed number
+ *
+ *  \return Pointer to the argument after the number, past its spaces, or \c NULL if the text does not start with a
+ *          number
+ */
+const char* Console_ParseNumber(const char* Text, uint16_t* const Value)
+{
+	uint32_t Number = 0;
+
+	if ((*Text < '0') || (*Text > '9'))
+	  return NULL;
+
+	while ((*Text >= '0') && (*Text <= '9'))
+	{
+		if (Number <= UINT16_MAX)
+		  Number = (Number * 10) + (*Text - '0');
+
+		Text++;
+	}
+
+	if (*Text && (*Text != ' '))
+	  return NULL;
+
+	while (*Text == ' ')
+	  Text++;
+
+	*Value = (Number > UINT16_MAX) ? UINT16_MAX : Number;
+	return Text;
+}
+
+/** Queues a message from FLASH memory followed by a line ending, for command handlers with a fixed reply.
+ *
+ *  \param[in,out] Output   Ring buffer for the message
+ *  \param[in]     Message  Message in FLASH memory
+ *
+ *  \return Boolean \c true if the message was queued, \c false if there was no room for it
+ */
+bool Console_QueueMessage_P(RingBuffer_t* const Output, const char* const Message)
+{
+	if (RingBuffer_GetFreeCount(Output) < (strlen_P(Message) + 2))
+	  return false;
+
+	CDCPipe_QueueString_P(Output, Message);
+	CDCPipe_QueueString_P(Output, PSTR("\r\n"));
+	return true;
+}
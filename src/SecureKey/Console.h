@@ -0,0 +1,70 @@
+/** \file
+ *
+ *  Header file for Console.c.
+ */
+
+#ifndef _CONSOLE_H_
+#define _CONSOLE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+		#include <stdio.h>
+		#include <string.h>
+
+		#include <LUFA/Drivers/Misc/RingBuffer.h>
+
+		#include "CDCPipe.h"
+
+	/* Macros: */
+		/** Size of the console line buffer, including the terminator. */
+		#define CONSOLE_LINE_SIZE          72
+
+		/** Free space needed in the output buffer before a command is run, which bounds the output of each step of
+		 *  a command.
+		 */
+		#define CONSOLE_OUTPUT_RESERVE     48
+
+	/* Type Defines: */
+		typedef struct Console Console_t;
+
+		/** Type define for a console command handler. A handler is run in steps, each with room for
+		 *  \ref CONSOLE_OUTPUT_RESERVE bytes of output, so that long output never waits for the host to read.
+		 *
+		 *  \param[in,out] Console  Console running the command, whose \c Args and \c Step fields are for the handler
+		 *  \param[in,out] Output   Ring buffer for the output of the step
+		 *
+		 *  \return Boolean \c true once the command has finished, \c false to be run again with the next step
+		 */
+		typedef bool (*ConsoleHandler_t)(Console_t* const Console, RingBuffer_t* const Output);
+
+		/** Type define for an entry of a console command table. Command tables are located in FLASH memory. */
+		typedef struct
+		{
+			char             Name[8];  /**< Command name, as typed */
+			char             Help[32]; /**< Single line description, listed by the built in \c help command */
+			ConsoleHandler_t Run;      /**< Command handler */
+		} ConsoleCommand_t;
+
+		/** Type define for the state of a line based console. */
+		struct Console
+		{
+			const ConsoleCommand_t* Commands;                /**< Command table, in FLASH memory */
+			uint8_t                 CommandCount;            /**< Number of entries in the command table */
+			char                    Line[CONSOLE_LINE_SIZE]; /**< Line being typed, or the line of the running command */
+			uint8_t                 LineLength;              /**< Number of characters in \c Line */
+			bool                    LastWasCR;               /**< Flag set when the last character ended a line with CR */
+			bool                    PromptPending;           /**< Flag set when the prompt is still to be queued */
+			ConsoleHandler_t        Running;                 /**< Handler of the running command, or \c NULL */
+			const char*             Args;                    /**< Arguments of the running command, within \c Line */
+			uint8_t                 Step;                    /**< Step of the running command, counting from zero and stopping at 255 */
+		};
+
+	/* Function Prototypes: */
+		void Console_Init(Console_t* const Console, const ConsoleCommand_t* const Commands, const uint8_t CommandCount);
+		void Console_Task(Console_t* const Console, RingBuffer_t* const Input, RingBuffer_t* const Output);
+		bool Console_DecodeHex(char* const Text, uint8_t* const Length);
+		const char* Console_ParseNumber(const char* Text, uint16_t* const Value);
+		bool Console_QueueMessage_P(RingBuffer_t* const Output, const char* const Message);
+#endif
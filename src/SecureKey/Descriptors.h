@@ -97,6 +97,16 @@
 		/** Size in bytes of the Keyboard HID reporting IN endpoint. */
 		#define KEYBOARD_EPSIZE              8
 
+		/** Interval in milliseconds at which the host polls the Keyboard HID reporting IN endpoint. One key change
+		 *  is typed per poll at most, so define \c KEYBOARD_FAST_POLLING to have the host poll every frame for the
+		 *  fastest typing; some hosts and KVM switches do not keep up with it.
+		 */
+		#if defined(KEYBOARD_FAST_POLLING)
+			#define KEYBOARD_POLLING_INTERVAL_MS 1
+		#else
+			#define KEYBOARD_POLLING_INTERVAL_MS 5
+		#endif
+
 		/** Endpoint address of the CDC device-to-host notification IN endpoint. */
 		#define CDC_NOTIFICATION_EPADDR        (ENDPOINT_DIR_IN  | 2)
 
@@ -109,8 +119,54 @@
 		/** Size in bytes of the CDC device-to-host notification IN endpoint. */
 		#define CDC_NOTIFICATION_EPSIZE        8
 
-		/** Size in bytes of the CDC data IN and OUT endpoints. */
-		#define CDC_TXRX_EPSIZE                16
+		/** Number of banks of the Keyboard HID reporting IN endpoint. With two banks the next report can be written
+		 *  while the host has yet to collect the previous one.
+		 */
+		#define KEYBOARD_EPBANKS               2
+
+		/** Number of banks of the CDC notification IN endpoint, which carries no traffic of note. */
+		#define CDC_NOTIFICATION_EPBANKS       1
+
+		/** Size in bytes of the endpoint DPRAM of the USB controller, shared by all endpoint banks. */
+		#if defined(USB_SERIES_2_AVR)
+			#define ENDPOINT_DPRAM_SIZE        176
+		#elif defined(USB_SERIES_4_AVR) || defined(USB_SERIES_6_AVR) || defined(USB_SERIES_7_AVR)
+			#define ENDPOINT_DPRAM_SIZE        832
+		#else
+			/* XMEGA endpoint banks live in SRAM, so only the largest layout below is considered */
+			#define ENDPOINT_DPRAM_SIZE        1024
+		#endif
+
+		/** DPRAM taken by the control endpoint and the fixed HID and CDC notification endpoints. */
+		#define ENDPOINT_DPRAM_FIXED           (FIXED_CONTROL_ENDPOINT_SIZE + \
+		                                        (KEYBOARD_EPSIZE * KEYBOARD_EPBANKS) + \
+		                                        (CDC_NOTIFICATION_EPSIZE * CDC_NOTIFICATION_EPBANKS))
+
+		/** DPRAM taken by the CDC data IN and OUT endpoints for a given endpoint size and bank count. */
+		#define ENDPOINT_DPRAM_CDC_DATA(Size, Banks) (2 * (Size) * (Banks))
+
+		/* Endpoint planner: the CDC data endpoints get the remaining DPRAM, preferring double banking over larger
+		   single banked endpoints, as a second bank is what lets the host and the firmware work on a packet each */
+		#if ((ENDPOINT_DPRAM_FIXED + ENDPOINT_DPRAM_CDC_DATA(64, 2)) <= ENDPOINT_DPRAM_SIZE)
+			#define CDC_TXRX_EPSIZE            64
+			#define CDC_TXRX_EPBANKS           2
+		#elif ((ENDPOINT_DPRAM_FIXED + ENDPOINT_DPRAM_CDC_DATA(32, 2)) <= ENDPOINT_DPRAM_SIZE)
+			#define CDC_TXRX_EPSIZE            32
+			#define CDC_TXRX_EPBANKS           2
+		#elif ((ENDPOINT_DPRAM_FIXED + ENDPOINT_DPRAM_CDC_DATA(16, 2)) <= ENDPOINT_DPRAM_SIZE)
+			#define CDC_TXRX_EPSIZE            16
+			#define CDC_TXRX_EPBANKS           2
+		#else
+			#define CDC_TXRX_EPSIZE            16
+			#define CDC_TXRX_EPBANKS           1
+		#endif
+
+		/** Total DPRAM taken by the planned endpoint layout. */
+		#define ENDPOINT_DPRAM_USED            (ENDPOINT_DPRAM_FIXED + ENDPOINT_DPRAM_CDC_DATA(CDC_TXRX_EPSIZE, CDC_TXRX_EPBANKS))
+
+		#if (ENDPOINT_DPRAM_USED > ENDPOINT_DPRAM_SIZE)
+			#error Endpoint layout does not fit in the endpoint DPRAM of the target.
+		#endif
 
 	/* Function Prototypes: */
 		uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
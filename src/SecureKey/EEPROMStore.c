@@ -0,0 +1,549 @@
+/** \file
+ *
+ *  Secret store in EEPROM, kept as a journal of records which each hold a whole slot. An update never touches the
+ *  record it replaces: the new record is written to the next run of free blocks after the last one written, with its
+ *  commit byte last, and only then takes over its slot. Writes thus walk around the whole EEPROM rather than wearing
+ *  out the blocks of a single slot, and a write cut short by a reset leaves the previous record in place.
+ *
+ *  The journal is indexed by a single scan at start up, and records are written a byte at a time from a scheduler
+ *  task, whenever the EEPROM has finished the previous byte, so that no write ever waits on the EEPROM.
+ *
+ *  Secrets must not outlive their slot, so once a record has been replaced or erased its blocks are scrubbed back to
+ *  the erased state in the same way, a byte per pass of the task, starting with the commit byte of the old record.
+ *  The blocks are only reused once they have been scrubbed. Any block outside the live records which is not erased
+ *  at start up, left by a reset during a write or a scrub, is scrubbed as well.
+ */
+
+#include "EEPROMStore.h"
+
+#if (EEPROM_STORE_BLOCKS > 32)
+	#error The live block mask of the EEPROM store only covers 32 blocks, use a larger EEPROM_STORE_BLOCK_SIZE.
+#endif
+
+/** First block of the live record of each slot, or \ref EEPROM_STORE_NO_BLOCK. */
+static uint8_t  EEPROMStore_SlotBlock[EEPROM_STORE_MAX_SLOTS];
+
+/** Number of blocks taken by the live record of each slot, so that a record can be replaced without reading back the
+ *  one it replaces.
+ */
+static uint8_t  EEPROMStore_SlotBlocks[EEPROM_STORE_MAX_SLOTS];
+
+/** Mask of the slots whose live record is empty, which have been erased from the store. */
+static uint16_t EEPROMStore_ErasedSlots;
+
+/** Mask of the blocks taken by live records, which allocation must skip. */
+static uint32_t EEPROMStore_LiveBlocks;
+
+/** Mask of the blocks still to be scrubbed, which allocation must also skip. */
+static uint32_t EEPROMStore_ScrubBlocks;
+
+/** Next byte to scrub within the lowest block of \ref EEPROMStore_ScrubBlocks. */
+static uint8_t  EEPROMStore_ScrubPosition;
+
+/** Block from which the next allocation searches for free blocks. */
+static uint8_t  EEPROMStore_NextBlock;
+
+/** Sequence number of the next record to write. */
+static uint16_t EEPROMStore_Sequence;
+
+/** Header of the record being written, whose CRC is accumulated as the data is written. */
+static EEPROMStoreHeader_t EEPROMStore_WriteHeader;
+
+/** Data of the record being written, which the caller keeps in place until the write completes, or \c NULL if the
+ *  data is streamed in through \ref EEPROMStore_Append().
+ */
+static const uint8_t* EEPROMStore_WriteData;
+
+/** First block of the record being written. */
+static uint8_t  EEPROMStore_WriteBlock;
+
+/** Next byte of the record to write. The commit byte is cleared at position 0, before anything else is written,
+ *  then come the slot, sequence and length fields and the data, the CRC once the data is complete, and lastly the
+ *  commit byte once the position has passed the CRC.
+ */
+static uint16_t EEPROMStore_WritePosition;
+
+/** Flag set while a record is being written. */
+static bool     EEPROMStore_Writing;
+
+/** Returns the EEPROM address of the start of a block. */
+static inline uint8_t* EEPROMStore_BlockAddress(const uint8_t Block)
+{
+	return (uint8_t*)(uintptr_t)((uint16_t)Block * EEPROM_STORE_BLOCK_SIZE);
+}
+
+/** Returns the number of blocks taken by a record with the given data length. */
+static inline uint8_t EEPROMStore_BlockCount(const uint16_t Length)
+{
+	return ((EEPROM_STORE_HEADER_SIZE + Length + (EEPROM_STORE_BLOCK_SIZE - 1)) / EEPROM_STORE_BLOCK_SIZE);
+}
+
+/** Returns the mask of a run of blocks. */
+static inline uint32_t EEPROMStore_BlockMask(const uint8_t Block, const uint8_t Count)
+{
+	return ((Count >= 32) ? 0xFFFFFFFF : ((((uint32_t)1 << Count) - 1) << Block));
+}
+
+/** Reads the header of the record at a block, checking its commit byte, slot and CRC.
+ *
+ *  \param[in]  Block   Block to read
+ *  \param[out] Header  Location where the header is stored
+ *
+ *  \return Boolean \c true if a complete record starts at the block, \c false otherwise
+ */
+static bool EEPROMStore_ReadRecord(const uint8_t Block, EEPROMStoreHeader_t* const Header)
+{
+	const uint8_t* Address = EEPROMStore_BlockAddress(Block);
+	uint8_t        Bytes[EEPROM_STORE_HEADER_SIZE];
+	uint8_t        CRC = 0;
+
+	for (uint8_t Index = 0; Index < EEPROM_STORE_HEADER_SIZE; Index++)
+	  Bytes[Index] = eeprom_read_byte(&Address[Index]);
+
+	Header->Commit   = Bytes[0];
+	Header->Slot     = Bytes[1];
+	Header->Sequence = (Bytes[2] | ((uint16_t)Bytes[3] << 8));
+	Header->Length   = (Bytes[4] | ((uint16_t)Bytes[5] << 8));
+	Header->CRC      = Bytes[6];
+
+	if ((Header->Commit != EEPROM_STORE_COMMITTED) || (Header->Slot >= EEPROM_STORE_MAX_SLOTS) ||
+	    (((uint16_t)Block * EEPROM_STORE_BLOCK_SIZE + EEPROM_STORE_HEADER_SIZE + Header->Length) > (E2END + 1)))
+	{
+		return false;
+	}
+
+	for (uint8_t Index = 1; Index < (EEPROM_STORE_HEADER_SIZE - 1); Index++)
+	  CRC = _crc8_ccitt_update(CRC, Bytes[Index]);
+
+	for (uint16_t Index = 0; Index < Header->Length; Index++)
+	  CRC = _crc8_ccitt_update(CRC, eeprom_read_byte(&Address[EEPROM_STORE_HEADER_SIZE + Index]));
+
+	return (CRC == Header->CRC);
+}
+
+/** Rebuilds the slot index from the records in EEPROM. Each block is read once: a complete record is taken as the
+ *  live one of its slot if it is newer than any seen so far, and the scan then skips over its data.
+ */
+void EEPROMStore_Init(void)
+{
+	uint16_t SlotSequence[EEPROM_STORE_MAX_SLOTS];
+	uint16_t Newest = 0;
+	bool     Found  = false;
+
+	memset(EEPROMStore_SlotBlock, EEPROM_STORE_NO_BLOCK, sizeof(EEPROMStore_SlotBlock));
+	EEPROMStore_ErasedSlots   = 0;
+	EEPROMStore_LiveBlocks    = 0;
+	EEPROMStore_ScrubBlocks   = 0;
+	EEPROMStore_ScrubPosition = 0;
+	EEPROMStore_NextBlock     = 0;
+	EEPROMStore_Writing       = false;
+
+	for (uint8_t Block = 0; Block < EEPROM_STORE_BLOCKS; )
+	{
+		EEPROMStoreHeader_t Header;
+
+		if (!(EEPROMStore_ReadRecord(Block, &Header)))
+		{
+			Block++;
+			continue;
+		}
+
+		uint8_t Slot = Header.Slot;
+
+		/* Sequence numbers are compared modulo 2^16, so the journal keeps working after they wrap */
+		if ((EEPROMStore_SlotBlock[Slot] == EEPROM_STORE_NO_BLOCK) || ((int16_t)(Header.Sequence - SlotSequence[Slot]) > 0))
+		{
+			EEPROMStore_SlotBlock[Slot] = Block;
+			SlotSequence[Slot]          = Header.Sequence;
+		}
+
+		if (!(Found) || ((int16_t)(Header.Sequence - Newest) > 0))
+		{
+			Newest = Header.Sequence;
+			EEPROMStore_NextBlock = (Block + EEPROMStore_BlockCount(Header.Length)) % EEPROM_STORE_BLOCKS;
+			Found  = true;
+		}
+
+		Block += EEPROMStore_BlockCount(Header.Length);
+	}
+
+	for (uint8_t Slot = 0; Slot < EEPROM_STORE_MAX_SLOTS; Slot++)
+	{
+		EEPROMStoreHeader_t Header;
+		uint8_t             Block = EEPROMStore_SlotBlock[Slot];
+
+		if (Block == EEPROM_STORE_NO_BLOCK)
+		  continue;
+
+		EEPROMStore_ReadRecord(Block, &Header);
+		EEPROMStore_SlotBlocks[Slot] = EEPROMStore_BlockCount(Header.Length);
+		EEPROMStore_LiveBlocks      |= EEPROMStore_BlockMask(Block, EEPROMStore_SlotBlocks[Slot]);
+
+		if (!(Header.Length))
+		  EEPROMStore_ErasedSlots |= (1U << Slot);
+	}
+
+	for (uint8_t Block = 0; Block < EEPROM_STORE_BLOCKS; Block++)
+	{
+		const uint8_t* Address = EEPROMStore_BlockAddress(Block);
+
+		if (EEPROMStore_LiveBlocks & ((uint32_t)1 << Block))
+		  continue;
+
+		for (uint8_t Index = 0; Index < EEPROM_STORE_BLOCK_SIZE; Index++)
+		{
+			if (eeprom_read_byte(&Address[Index]) != 0xFF)
+			{
+				EEPROMStore_ScrubBlocks |= ((uint32_t)1 << Block);
+				break;
+			}
+		}
+	}
+
+	EEPROMStore_Sequence = (Newest + 1);
+}
+
+/** Finds a run of free blocks for a record, searching from the block after the last record written and wrapping
+ *  around once.
+ *
+ *  \param[in] Count  Number of blocks needed
+ *
+ *  \return First block of the run, or \ref EEPROM_STORE_NO_BLOCK if there is none
+ */
+static uint8_t EEPROMStore_Allocate(const uint8_t Count)
+{
+	for (uint8_t Tried = 0; Tried < EEPROM_STORE_BLOCKS; Tried++)
+	{
+		uint8_t Block = ((EEPROMStore_NextBlock + Tried) % EEPROM_STORE_BLOCKS);
+
+		if ((Block + Count) > EEPROM_STORE_BLOCKS)
+		  continue;
+
+		if (!((EEPROMStore_LiveBlocks | EEPROMStore_ScrubBlocks) & EEPROMStore_BlockMask(Block, Count)))
+		  return Block;
+	}
+
+	return EEPROM_STORE_NO_BLOCK;
+}
+
+/** Starts writing a record for a slot in the background, whose data is then streamed in a byte at a time through
+ *  \ref EEPROMStore_Append(). An empty record erases the slot.
+ *
+ *  \param[in] Slot    Slot to write
+ *  \param[in] Length  Length of the data in bytes
+ *
+ *  \return Result of the request, a value from \ref EEPROMStoreWriteResults_t
+ */
+uint8_t EEPROMStore_Begin(const uint8_t Slot, const uint16_t Length)
+{
+	if (EEPROMStore_IsBusy())
+	  return EEPROM_STORE_WRITE_Busy;
+
+	if (Slot >= EEPROM_STORE_MAX_SLOTS)
+	  return EEPROM_STORE_WRITE_BadSlot;
+
+	uint8_t Block = (Length <= EEPROM_STORE_MAX_LENGTH) ? EEPROMStore_Allocate(EEPROMStore_BlockCount(Length))
+	                                                    : EEPROM_STORE_NO_BLOCK;
+
+	if (Block == EEPROM_STORE_NO_BLOCK)
+	  return EEPROM_STORE_WRITE_Full;
+
+	uint8_t CRC = 0;
+
+	CRC = _crc8_ccitt_update(CRC, Slot);
+	CRC = _crc8_ccitt_update(CRC, (EEPROMStore_Sequence & 0xFF));
+	CRC = _crc8_ccitt_update(CRC, (EEPROMStore_Sequence >> 8));
+	CRC = _crc8_ccitt_update(CRC, (Length & 0xFF));
+	CRC = _crc8_ccitt_update(CRC, (Length >> 8));
+
+	EEPROMStore_WriteHeader.Commit   = EEPROM_STORE_COMMITTED;
+	EEPROMStore_WriteHeader.Slot     = Slot;
+	EEPROMStore_WriteHeader.Sequence = EEPROMStore_Sequence;
+	EEPROMStore_WriteHeader.Length   = Length;
+	EEPROMStore_WriteHeader.CRC      = CRC;
+
+	EEPROMStore_WriteData     = NULL;
+	EEPROMStore_WriteBlock    = Block;
+	EEPROMStore_WritePosition = 0;
+	EEPROMStore_Writing       = true;
+
+	return EEPROM_STORE_WRITE_Started;
+}
+
+/** Starts writing a whole record for a slot in the background. An empty record erases the slot.
+ *
+ *  \param[in] Slot    Slot to write
+ *  \param[in] Data    Packed keys of the slot, which must stay in place until \ref EEPROMStore_IsBusy() is \c false
+ *  \param[in] Length  Length of the data in bytes
+ *
+ *  \return Result of the request, a value from \ref EEPROMStoreWriteResults_t
+ */
+uint8_t EEPROMStore_Write(const uint8_t Slot, const uint8_t* const Data, const uint16_t Length)
+{
+	uint8_t Result = EEPROMStore_Begin(Slot, Length);
+
+	if (Result == EEPROM_STORE_WRITE_Started)
+	  EEPROMStore_WriteData = Data;
+
+	return Result;
+}
+
+/** Returns the header byte of the record being written at the given position, in the layout of
+ *  \ref EEPROMStoreHeader_t.
+ */
+static uint8_t EEPROMStore_WriteByte(const uint16_t Position)
+{
+	switch (Position)
+	{
+		case 0:
+			/* Clear the commit byte of whatever the block held, so that no old record can be read over the new one */
+			return 0xFF;
+		case 1:
+			return EEPROMStore_WriteHeader.Slot;
+		case 2:
+			return (EEPROMStore_WriteHeader.Sequence & 0xFF);
+		case 3:
+			return (EEPROMStore_WriteHeader.Sequence >> 8);
+		case 4:
+			return (EEPROMStore_WriteHeader.Length & 0xFF);
+		default:
+			return (EEPROMStore_WriteHeader.Length >> 8);
+	}
+}
+
+/** Writes the next data byte of the record being written, which the EEPROM must be ready for, adding it to the CRC. */
+static void EEPROMStore_WriteDataByte(const uint8_t Byte)
+{
+	uint16_t Position = EEPROMStore_WritePosition;
+
+	/* Data positions start at the CRC field, which is written after the data */
+	eeprom_update_byte(&EEPROMStore_BlockAddress(EEPROMStore_WriteBlock)[Position + 1], Byte);
+	EEPROMStore_WriteHeader.CRC = _crc8_ccitt_update(EEPROMStore_WriteHeader.CRC, Byte);
+	EEPROMStore_WritePosition   = (Position + 1);
+}
+
+/** Commits a record once all of its other bytes are written, and makes it the live record of its slot. The record
+ *  it replaces is handed over to be scrubbed by later passes of the task, as the EEPROM is busy with the commit byte.
+ */
+static void EEPROMStore_Commit(void)
+{
+	uint8_t Slot     = EEPROMStore_WriteHeader.Slot;
+	uint8_t OldBlock = EEPROMStore_SlotBlock[Slot];
+	uint8_t Count    = EEPROMStore_BlockCount(EEPROMStore_WriteHeader.Length);
+
+	eeprom_write_byte(EEPROMStore_BlockAddress(EEPROMStore_WriteBlock), EEPROM_STORE_COMMITTED);
+
+	if (OldBlock != EEPROM_STORE_NO_BLOCK)
+	{
+		uint32_t OldMask = EEPROMStore_BlockMask(OldBlock, EEPROMStore_SlotBlocks[Slot]);
+
+		EEPROMStore_LiveBlocks  &= ~OldMask;
+		EEPROMStore_ScrubBlocks |=  OldMask;
+	}
+
+	if (EEPROMStore_WriteHeader.Length)
+	  EEPROMStore_ErasedSlots &= ~(1U << Slot);
+	else
+	  EEPROMStore_ErasedSlots |= (1U << Slot);
+
+	EEPROMStore_SlotBlock[Slot]  = EEPROMStore_WriteBlock;
+	EEPROMStore_SlotBlocks[Slot] = Count;
+	EEPROMStore_LiveBlocks      |= EEPROMStore_BlockMask(EEPROMStore_WriteBlock, Count);
+	EEPROMStore_NextBlock       = ((EEPROMStore_WriteBlock + Count) % EEPROM_STORE_BLOCKS);
+	EEPROMStore_Sequence++;
+	EEPROMStore_Writing         = false;
+}
+
+/** Scrubs the next byte of the lowest block waiting to be scrubbed which is not yet erased, which the EEPROM must be
+ *  ready for. Erased bytes are passed over within the same call, so that each call starts at most one write.
+ */
+static void EEPROMStore_ScrubNext(void)
+{
+	uint8_t Block = 0;
+
+	while (!(EEPROMStore_ScrubBlocks & ((uint32_t)1 << Block)))
+	  Block++;
+
+	uint8_t* Address = EEPROMStore_BlockAddress(Block);
+
+	while (EEPROMStore_ScrubPosition < EEPROM_STORE_BLOCK_SIZE)
+	{
+		uint8_t* Byte = &Address[EEPROMStore_ScrubPosition++];
+
+		if (eeprom_read_byte(Byte) != 0xFF)
+		{
+			eeprom_write_byte(Byte, 0xFF);
+			return;
+		}
+	}
+
+	EEPROMStore_ScrubPosition = 0;
+	EEPROMStore_ScrubBlocks  &= ~((uint32_t)1 << Block);
+}
+
+/** Writes the next byte of the record in progress, or scrubs the next byte of a replaced record, if the EEPROM has
+ *  finished the previous one. This must be run regularly by the scheduler while \ref EEPROMStore_IsBusy() is
+ *  \c true.
+ */
+void EEPROMStore_Task(void)
+{
+	uint16_t Position = EEPROMStore_WritePosition;
+	uint16_t DataEnd  = ((EEPROM_STORE_HEADER_SIZE - 1) + EEPROMStore_WriteHeader.Length);
+
+	if (!(EEPROMStore_IsBusy()) || !(eeprom_is_ready()))
+	  return;
+
+	if (!(EEPROMStore_Writing))
+	{
+		EEPROMStore_ScrubNext();
+		return;
+	}
+
+	/* The EEPROM is ready, so every other byte of the record is complete and the commit byte can go last */
+	if (Position > DataEnd)
+	{
+		EEPROMStore_Commit();
+		return;
+	}
+
+	uint8_t* Address = EEPROMStore_BlockAddress(EEPROMStore_WriteBlock);
+
+	if (Position == DataEnd)
+	{
+		eeprom_update_byte(&Address[EEPROM_STORE_HEADER_SIZE - 1], EEPROMStore_WriteHeader.CRC);
+		EEPROMStore_WritePosition = (Position + 1);
+	}
+	else if (Position >= (EEPROM_STORE_HEADER_SIZE - 1))
+	{
+		/* Streamed data is written by EEPROMStore_Append() as it arrives */
+		if (EEPROMStore_WriteData != NULL)
+		  EEPROMStore_WriteDataByte(EEPROMStore_WriteData[Position - (EEPROM_STORE_HEADER_SIZE - 1)]);
+	}
+	else
+	{
+		eeprom_update_byte(&Address[Position], EEPROMStore_WriteByte(Position));
+		EEPROMStore_WritePosition = (Position + 1);
+	}
+}
+
+/** Streams data into the record started by \ref EEPROMStore_Begin(). The EEPROM takes a byte at a time, so at most
+ *  a single byte is taken per call, and none until the EEPROM has finished the previous byte.
+ *
+ *  \param[in] Data   Record data to add
+ *  \param[in] Count  Number of bytes to add
+ *
+ *  \return Number of bytes taken, which is zero or one
+ */
+uint16_t EEPROMStore_Append(const uint8_t* const Data, const uint16_t Count)
+{
+	uint16_t Position = EEPROMStore_WritePosition;
+	uint16_t DataEnd  = ((EEPROM_STORE_HEADER_SIZE - 1) + EEPROMStore_WriteHeader.Length);
+
+	if (!(EEPROMStore_Writing) || (EEPROMStore_WriteData != NULL) || !(Count) || !(eeprom_is_ready()))
+	  return 0;
+
+	if ((Position < (EEPROM_STORE_HEADER_SIZE - 1)) || (Position >= DataEnd))
+	  return 0;
+
+	EEPROMStore_WriteDataByte(Data[0]);
+	return 1;
+}
+
+/** Gives the number of bytes of data still expected for a record started by \ref EEPROMStore_Begin().
+ *
+ *  \return Number of bytes still to be given to \ref EEPROMStore_Append(), zero if no record is being streamed
+ */
+uint16_t EEPROMStore_GetRemaining(void)
+{
+	uint16_t Position = EEPROMStore_WritePosition;
+	uint16_t DataEnd  = ((EEPROM_STORE_HEADER_SIZE - 1) + EEPROMStore_WriteHeader.Length);
+
+	if (!(EEPROMStore_Writing) || (EEPROMStore_WriteData != NULL) || (Position >= DataEnd))
+	  return 0;
+
+	return (DataEnd - ((Position < (EEPROM_STORE_HEADER_SIZE - 1)) ? (EEPROM_STORE_HEADER_SIZE - 1) : Position));
+}
+
+/** Abandons the record being written. Its commit byte is cleared before anything else is written, so the record is
+ *  never taken as complete, and its blocks were never marked as live; they are scrubbed of what was written.
+ */
+void EEPROMStore_Abort(void)
+{
+	if (!(EEPROMStore_Writing))
+	  return;
+
+	EEPROMStore_ScrubBlocks |= EEPROMStore_BlockMask(EEPROMStore_WriteBlock,
+	                                                 EEPROMStore_BlockCount(EEPROMStore_WriteHeader.Length));
+	EEPROMStore_Writing      = false;
+}
+
+/** Checks whether a record is still being written, or the blocks of a replaced record are still being scrubbed. The
+ *  EEPROM cannot be read without stalling until both are done.
+ *
+ *  \return Boolean \c true while a write or a scrub is in progress
+ */
+bool EEPROMStore_IsBusy(void)
+{
+	return (EEPROMStore_Writing || EEPROMStore_ScrubBlocks);
+}
+
+/** Reads the data length of the live record of a slot.
+ *
+ *  \param[in] Slot  Slot to read, which must be held in the store
+ *
+ *  \return Length of the record data in bytes
+ */
+static uint16_t EEPROMStore_SlotLength(const uint8_t Slot)
+{
+	uint8_t* Address = EEPROMStore_BlockAddress(EEPROMStore_SlotBlock[Slot]);
+
+	return (eeprom_read_byte(&Address[4]) | ((uint16_t)eeprom_read_byte(&Address[5]) << 8));
+}
+
+/** Checks whether a slot is held in the EEPROM store. A slot whose live record is empty has been erased from the
+ *  store, and is left to the stores below it.
+ *
+ *  \param[in] Slot  Slot to check
+ *
+ *  \return Boolean \c true if the store holds keys for the slot
+ */
+bool EEPROMStore_HasSlot(const uint8_t Slot)
+{
+	return ((Slot < EEPROM_STORE_MAX_SLOTS) && (EEPROMStore_SlotBlock[Slot] != EEPROM_STORE_NO_BLOCK) &&
+	        !(EEPROMStore_ErasedSlots & (1U << Slot)));
+}
+
+/** Opens a stream over the keys of a slot held in the EEPROM store.
+ *
+ *  \param[out] Stream  Stream to open
+ *  \param[in]  Slot    Slot to read
+ *
+ *  \return Boolean \c true if the store holds the slot, \c false otherwise
+ */
+bool EEPROMStore_OpenSlot(SecretStream_t* const Stream, const uint8_t Slot)
+{
+	if (!(EEPROMStore_HasSlot(Slot)))
+	  return false;
+
+	uint8_t* Address = EEPROMStore_BlockAddress(EEPROMStore_SlotBlock[Slot]);
+
+	SecretStream_OpenEEPROM(Stream, &Address[EEPROM_STORE_HEADER_SIZE], EEPROMStore_SlotLength(Slot));
+	return true;
+}
+
+/** Counts the blocks not taken by live records or waiting to be scrubbed.
+ *
+ *  \return Number of free blocks
+ */
+uint8_t EEPROMStore_GetFreeBlocks(void)
+{
+	uint8_t Free = 0;
+
+	for (uint8_t Block = 0; Block < EEPROM_STORE_BLOCKS; Block++)
+	{
+		if (!((EEPROMStore_LiveBlocks | EEPROMStore_ScrubBlocks) & ((uint32_t)1 << Block)))
+		  Free++;
+	}
+
+	return Free;
+}
@@ -0,0 +1,76 @@
+/** \file
+ *
+ *  Header file for EEPROMStore.c.
+ */
+
+#ifndef _EEPROMSTORE_H_
+#define _EEPROMSTORE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/eeprom.h>
+		#include <util/crc16.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include "SecretStream.h"
+
+	/* Macros: */
+		/** Size of an allocation block of the journal; every record starts on a block boundary. */
+		#define EEPROM_STORE_BLOCK_SIZE    32
+
+		/** Number of blocks of the journal, which covers the whole EEPROM. */
+		#define EEPROM_STORE_BLOCKS        ((E2END + 1) / EEPROM_STORE_BLOCK_SIZE)
+
+		/** Number of slots which can be held in the EEPROM store, from slot 0; at most 16. */
+		#define EEPROM_STORE_MAX_SLOTS     16
+
+		/** Size in bytes of \ref EEPROMStoreHeader_t as stored in EEPROM. */
+		#define EEPROM_STORE_HEADER_SIZE   7
+
+		/** Value of the commit byte of a complete record, which is written last. */
+		#define EEPROM_STORE_COMMITTED     0x5A
+
+		/** Longest record data which fits into the journal. */
+		#define EEPROM_STORE_MAX_LENGTH    ((EEPROM_STORE_BLOCKS * EEPROM_STORE_BLOCK_SIZE) - EEPROM_STORE_HEADER_SIZE)
+
+		/** Block index for a slot which is not held in the EEPROM store. */
+		#define EEPROM_STORE_NO_BLOCK      0xFF
+
+	/* Enums: */
+		/** Enum for the results of \ref EEPROMStore_Write(). */
+		enum EEPROMStoreWriteResults_t
+		{
+			EEPROM_STORE_WRITE_Started, /**< The record is being written in the background */
+			EEPROM_STORE_WRITE_Busy,    /**< Another record is still being written */
+			EEPROM_STORE_WRITE_BadSlot, /**< The slot number is out of range */
+			EEPROM_STORE_WRITE_Full,    /**< There is no run of free blocks long enough for the record */
+		};
+
+	/* Type Defines: */
+		/** Type define for the header of a journal record in EEPROM. The record data, the packed keys of the slot,
+		 *  follows the header and runs on over as many blocks as it needs. A record with no data erases its slot from
+		 *  the store.
+		 */
+		typedef struct
+		{
+			uint8_t  Commit;   /**< \ref EEPROM_STORE_COMMITTED once the record is complete */
+			uint8_t  Slot;     /**< Slot the record holds */
+			uint16_t Sequence; /**< Journal sequence number; the newest record of a slot is the live one */
+			uint16_t Length;   /**< Length of the record data in bytes */
+			uint8_t  CRC;      /**< CRC-8 of the slot, sequence and length fields and the record data, written after the data */
+		} EEPROMStoreHeader_t;
+
+	/* Function Prototypes: */
+		void     EEPROMStore_Init(void);
+		void     EEPROMStore_Task(void);
+		uint8_t  EEPROMStore_Begin(const uint8_t Slot, const uint16_t Length);
+		uint8_t  EEPROMStore_Write(const uint8_t Slot, const uint8_t* const Data, const uint16_t Length);
+		uint16_t EEPROMStore_Append(const uint8_t* const Data, const uint16_t Count);
+		uint16_t EEPROMStore_GetRemaining(void);
+		void     EEPROMStore_Abort(void);
+		bool     EEPROMStore_IsBusy(void);
+		bool     EEPROMStore_HasSlot(const uint8_t Slot);
+		bool     EEPROMStore_OpenSlot(SecretStream_t* const Stream, const uint8_t Slot);
+		uint8_t  EEPROMStore_GetFreeBlocks(void);
+#endif
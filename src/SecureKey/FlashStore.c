@@ -0,0 +1,449 @@
+/** \file
+ *
+ *  Secret store in a region of the application section of FLASH, for slots too large for the EEPROM store. Records
+ *  are appended one after another from the start of the region, each starting on a page boundary, so the last record
+ *  of a slot is its live one; the space of superseded records is only given back by formatting the whole region.
+ *  Records are read in place through \c pgm_read_byte(), like the vault, so a slot costs no RAM however large it is.
+ *
+ *  The AVR can only run the SPM instruction from the bootloader section, so pages are erased and written through
+ *  the function table exported by the LUFA DFU bootloader. Record data is gathered into a page buffer in RAM, and
+ *  each full page is programmed from \ref FlashStore_Task(), one erase or write per run, so that every run of the
+ *  main loop takes at most a single page operation. The application section cannot be read while it is being
+ *  programmed, so interrupts are held off for each operation, and an operation is never started while the EEPROM is
+ *  being written, which would discard the loaded page.
+ */
+
+#include "FlashStore.h"
+
+#if (FLASH_STORE_PAGES >= FLASH_STORE_NO_PAGE)
+	#error The FLASH store holds page indexes in a byte, use fewer FLASH_STORE_PAGES.
+#endif
+
+/** Region of FLASH reserved for the store, page aligned and left erased by the programmer. */
+static const uint8_t FlashStore_Region[FLASH_STORE_SIZE] PROGMEM __attribute__((aligned(SPM_PAGESIZE))) =
+	{
+		[0 ... (FLASH_STORE_SIZE - 1)] = 0xFF,
+	};
+
+/** Bootloader function erasing the FLASH page at a byte address. */
+static void (* const FlashStore_BootErasePage)(uint32_t Address) = BOOTLOADER_API_CALL(0);
+
+/** Bootloader function programming the loaded page buffer to the FLASH page at a byte address. */
+static void (* const FlashStore_BootWritePage)(uint32_t Address) = BOOTLOADER_API_CALL(1);
+
+/** Bootloader function loading a word into the page buffer at a byte address within the page. */
+static void (* const FlashStore_BootFillWord)(uint32_t Address, uint16_t Word) = BOOTLOADER_API_CALL(2);
+
+/** First page of the live record of each slot, or \ref FLASH_STORE_NO_PAGE. */
+static uint8_t  FlashStore_SlotPage[FLASH_STORE_MAX_SLOTS];
+
+/** First page after the last record, where the next record is written. */
+static uint8_t  FlashStore_NextPage;
+
+/** Flag set if the bootloader exports the functions to erase and write FLASH. */
+static bool     FlashStore_Writable;
+
+/** Data of the page being gathered, programmed once it is full or the record is complete. */
+static uint8_t  FlashStore_PageBuffer[SPM_PAGESIZE];
+
+/** Number of bytes gathered into \ref FlashStore_PageBuffer. */
+static uint8_t  FlashStore_BufferCount;
+
+/** Flag set while \ref FlashStore_PageBuffer is waiting to be programmed, during which no data is taken. */
+static bool     FlashStore_PagePending;
+
+/** Flag set once the page to be programmed next has been erased. */
+static bool     FlashStore_PageErased;
+
+/** Page to be programmed next. */
+static uint8_t  FlashStore_WritePage;
+
+/** Header of the record being received. */
+static FlashStoreHeader_t FlashStore_Record;
+
+/** First page of the record being received. */
+static uint8_t  FlashStore_RecordPage;
+
+/** Bytes of record data still to be received. */
+static uint16_t FlashStore_Remaining;
+
+/** Bytes of the CRC trailer gathered so far. */
+static uint8_t  FlashStore_TrailerCount;
+
+/** Running CRC of the record being received. */
+static uint16_t FlashStore_CRC;
+
+/** Flag set from \ref FlashStore_Begin() until the last page of the record has been programmed. */
+static bool     FlashStore_Receiving;
+
+/** Next page to be erased by \ref FlashStore_Format(), or \ref FLASH_STORE_NO_PAGE if the region is not being
+ *  formatted.
+ */
+static uint8_t  FlashStore_FormatPage = FLASH_STORE_NO_PAGE;
+
+/** Returns the FLASH address of the start of a page of the region. */
+static inline const uint8_t* FlashStore_PageAddress(const uint8_t Page)
+{
+	return &FlashStore_Region[(uint16_t)Page * SPM_PAGESIZE];
+}
+
+/** Returns the number of pages taken by a record with the given data length. */
+static inline uint16_t FlashStore_PageCount(const uint16_t Length)
+{
+	return (((uint32_t)FLASH_STORE_HEADER_SIZE + Length + FLASH_STORE_TRAILER_SIZE + (SPM_PAGESIZE - 1)) / SPM_PAGESIZE);
+}
+
+/** Reads the header of the record starting at a page.
+ *
+ *  \param[in]  Page    Page to read
+ *  \param[out] Header  Header of the record
+ *
+ *  \return Boolean \c true if the page starts a record, \c false if it is free
+ */
+static bool FlashStore_ReadHeader(const uint8_t Page, FlashStoreHeader_t* const Header)
+{
+	const uint8_t* Address = FlashStore_PageAddress(Page);
+
+	Header->Magic  = pgm_read_word(&Address[0]);
+	Header->Slot   = pgm_read_byte(&Address[2]);
+	Header->Length = pgm_read_word(&Address[3]);
+
+	return (Header->Magic == FLASH_STORE_MAGIC);
+}
+
+/** Checks the CRC of a complete record.
+ *
+ *  \param[in] Page    First page of the record
+ *  \param[in] Length  Length of the record data in bytes
+ *
+ *  \return Boolean \c true if the record was written in full, \c false if it was cut short
+ */
+static bool FlashStore_CheckRecord(const uint8_t Page, const uint16_t Length)
+{
+	const uint8_t* Address = &FlashStore_PageAddress(Page)[2];
+	uint16_t       CRC     = 0xFFFF;
+
+	for (uint16_t Index = 0; Index < (FLASH_STORE_HEADER_SIZE - 2 + Length); Index++)
+	  CRC = _crc_ccitt_update(CRC, pgm_read_byte(&Address[Index]));
+
+	return (pgm_read_word(&Address[FLASH_STORE_HEADER_SIZE - 2 + Length]) == CRC);
+}
+
+/** Checks whether a page of the region is erased, so that it can be programmed without erasing it first. */
+static bool FlashStore_IsPageBlank(const uint8_t Page)
+{
+	const uint8_t* Address = FlashStore_PageAddress(Page);
+
+	for (uint16_t Index = 0; Index < SPM_PAGESIZE; Index += 2)
+	{
+		if (pgm_read_word(&Address[Index]) != 0xFFFF)
+		  return false;
+	}
+
+	return true;
+}
+
+/** Indexes the records of the region and checks for the bootloader functions. This is a single pass over the
+ *  record headers, which skips from each record to the next, with a CRC check of each record on the way so that a
+ *  record cut short by a reset is passed over.
+ */
+void FlashStore_Init(void)
+{
+	uint8_t Page = 0;
+
+	memset(FlashStore_SlotPage, FLASH_STORE_NO_PAGE, sizeof(FlashStore_SlotPage));
+	FlashStore_Receiving   = false;
+	FlashStore_PagePending = false;
+	FlashStore_FormatPage  = FLASH_STORE_NO_PAGE;
+	FlashStore_Writable    = (pgm_read_word(BOOTLOADER_MAGIC_SIGNATURE_START) == BOOTLOADER_MAGIC_SIGNATURE);
+
+	while (Page < FLASH_STORE_PAGES)
+	{
+		FlashStoreHeader_t Header;
+
+		if (!(FlashStore_ReadHeader(Page, &Header)))
+		  break;
+
+		uint16_t Pages = FlashStore_PageCount(Header.Length);
+
+		/* A header running past the region was torn while its page was written, and marks the end of the records */
+		if ((Page + Pages) > FLASH_STORE_PAGES)
+		  break;
+
+		if ((Header.Slot < FLASH_STORE_MAX_SLOTS) && FlashStore_CheckRecord(Page, Header.Length))
+		  FlashStore_SlotPage[Header.Slot] = (Header.Length ? Page : FLASH_STORE_NO_PAGE);
+
+		Page += Pages;
+	}
+
+	FlashStore_NextPage = Page;
+}
+
+/** Adds a byte of the record being received to the page buffer, marking the page for programming once it is full. */
+static void FlashStore_Put(const uint8_t Byte)
+{
+	FlashStore_PageBuffer[FlashStore_BufferCount++] = Byte;
+
+	if (FlashStore_BufferCount == SPM_PAGESIZE)
+	  FlashStore_PagePending = true;
+}
+
+/** Adds the CRC trailer to the page buffer once all of the record data has been received, as far as the buffer has
+ *  room, and marks the last, partly filled, page for programming once the trailer is complete.
+ */
+static void FlashStore_PutTrailer(void)
+{
+	if (FlashStore_Remaining || (FlashStore_TrailerCount == FLASH_STORE_TRAILER_SIZE))
+	  return;
+
+	while (!(FlashStore_PagePending) && (FlashStore_TrailerCount < FLASH_STORE_TRAILER_SIZE))
+	  FlashStore_Put((FlashStore_CRC >> (8 * FlashStore_TrailerCount++)) & 0xFF);
+
+	if ((FlashStore_TrailerCount == FLASH_STORE_TRAILER_SIZE) && !(FlashStore_PagePending) && FlashStore_BufferCount)
+	{
+		memset(&FlashStore_PageBuffer[FlashStore_BufferCount], 0xFF, (SPM_PAGESIZE - FlashStore_BufferCount));
+		FlashStore_PagePending = true;
+	}
+}
+
+/** Starts a new record for a slot, whose data is then given to \ref FlashStore_Write(). The record takes over the
+ *  slot once all of its data has been received and programmed. A record with no data erases the slot.
+ *
+ *  \param[in] Slot    Slot of the record
+ *  \param[in] Length  Length of the record data in bytes
+ *
+ *  \return A value from the \ref FlashStoreResults_t enum
+ */
+uint8_t FlashStore_Begin(const uint8_t Slot, const uint16_t Length)
+{
+	if (!(FlashStore_Writable))
+	  return FLASH_STORE_NoBootloader;
+
+	if (FlashStore_Receiving || FlashStore_IsBusy())
+	  return FLASH_STORE_Busy;
+
+	if (Slot >= FLASH_STORE_MAX_SLOTS)
+	  return FLASH_STORE_BadSlot;
+
+	if (FlashStore_PageCount(Length) > FlashStore_GetFreePages())
+	  return FLASH_STORE_Full;
+
+	FlashStore_Record.Magic  = FLASH_STORE_MAGIC;
+	FlashStore_Record.Slot   = Slot;
+	FlashStore_Record.Length = Length;
+
+	FlashStore_RecordPage   = FlashStore_NextPage;
+	FlashStore_WritePage    = FlashStore_NextPage;
+	FlashStore_PageErased   = false;
+	FlashStore_BufferCount  = 0;
+	FlashStore_Remaining    = Length;
+	FlashStore_TrailerCount = 0;
+	FlashStore_CRC          = 0xFFFF;
+	FlashStore_Receiving    = true;
+
+	FlashStore_Put(FLASH_STORE_MAGIC & 0xFF);
+	FlashStore_Put(FLASH_STORE_MAGIC >> 8);
+
+	const uint8_t Fields[] = {Slot, (Length & 0xFF), (Length >> 8)};
+
+	for (uint8_t Index = 0; Index < sizeof(Fields); Index++)
+	{
+		FlashStore_CRC = _crc_ccitt_update(FlashStore_CRC, Fields[Index]);
+		FlashStore_Put(Fields[Index]);
+	}
+
+	FlashStore_PutTrailer();
+	return FLASH_STORE_Started;
+}
+
+/** Gives data of the record being received to the store. Data is taken until the page buffer is full, after which
+ *  the rest must be given again once the page has been programmed.
+ *
+ *  \param[in] Data   Record data to add
+ *  \param[in] Count  Number of bytes to add
+ *
+ *  \return Number of bytes taken, which is zero while the page buffer is waiting to be programmed
+ */
+uint16_t FlashStore_Write(const uint8_t* const Data, const uint16_t Count)
+{
+	uint16_t Taken = 0;
+
+	while (FlashStore_Receiving && !(FlashStore_PagePending) && FlashStore_Remaining && (Taken < Count))
+	{
+		FlashStore_CRC = _crc_ccitt_update(FlashStore_CRC, Data[Taken]);
+		FlashStore_Put(Data[Taken++]);
+		FlashStore_Remaining--;
+	}
+
+	if (FlashStore_Receiving)
+	  FlashStore_PutTrailer();
+
+	return Taken;
+}
+
+/** Starts erasing the whole region, dropping every slot of the store at once to give back the space of superseded
+ *  records. The pages are erased in the background.
+ *
+ *  \return A value from the \ref FlashStoreResults_t enum
+ */
+uint8_t FlashStore_Format(void)
+{
+	if (!(FlashStore_Writable))
+	  return FLASH_STORE_NoBootloader;
+
+	if (FlashStore_Receiving || FlashStore_IsBusy())
+	  return FLASH_STORE_Busy;
+
+	memset(FlashStore_SlotPage, FLASH_STORE_NO_PAGE, sizeof(FlashStore_SlotPage));
+	FlashStore_NextPage   = 0;
+	FlashStore_FormatPage = 0;
+
+	return FLASH_STORE_Started;
+}
+
+/** Programs the page buffer to the next page of the record, completing the record after its last page. */
+static void FlashStore_ProgramPage(void)
+{
+	uint32_t Address = (uintptr_t)FlashStore_PageAddress(FlashStore_WritePage);
+
+	/* The page buffer of the SPM unit is only loaded here, so that an EEPROM write can never discard it */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (uint8_t Index = 0; Index < SPM_PAGESIZE; Index += 2)
+		{
+			FlashStore_BootFillWord(Address + Index, (FlashStore_PageBuffer[Index] |
+			                                      ((uint16_t)FlashStore_PageBuffer[Index + 1] << 8)));
+		}
+
+		FlashStore_BootWritePage(Address);
+	}
+
+	FlashStore_WritePage++;
+	FlashStore_PageErased  = false;
+	FlashStore_BufferCount = 0;
+	FlashStore_PagePending = false;
+
+	if (FlashStore_Remaining || (FlashStore_TrailerCount < FLASH_STORE_TRAILER_SIZE))
+	{
+		FlashStore_PutTrailer();
+		return;
+	}
+
+	FlashStore_SlotPage[FlashStore_Record.Slot] = (FlashStore_Record.Length ? FlashStore_RecordPage : FLASH_STORE_NO_PAGE);
+	FlashStore_NextPage  = FlashStore_WritePage;
+	FlashStore_Receiving = false;
+}
+
+/** Task to program the FLASH store, taking a single page erase or write per run. Nothing is done while the EEPROM
+ *  is being written, as the SPM unit cannot run alongside it.
+ */
+void FlashStore_Task(void)
+{
+	if (!(FlashStore_IsBusy()) || !(eeprom_is_ready()))
+	  return;
+
+	if (FlashStore_FormatPage != FLASH_STORE_NO_PAGE)
+	{
+		uint8_t Page = FlashStore_FormatPage;
+
+		if (!(FlashStore_IsPageBlank(Page)))
+		{
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				FlashStore_BootErasePage((uintptr_t)FlashStore_PageAddress(Page));
+			}
+		}
+
+		FlashStore_FormatPage = ((Page + 1) < FLASH_STORE_PAGES) ? (Page + 1) : FLASH_STORE_NO_PAGE;
+		return;
+	}
+
+	/* Pages past the last record are normally still erased, unless a record was cut short while being written */
+	if (!(FlashStore_PageErased) && !(FlashStore_IsPageBlank(FlashStore_WritePage)))
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			FlashStore_BootErasePage((uintptr_t)FlashStore_PageAddress(FlashStore_WritePage));
+		}
+
+		FlashStore_PageErased = true;
+		return;
+	}
+
+	FlashStore_ProgramPage();
+}
+
+/** Abandons the record being received. The pages already programmed fail the CRC check of the record and are erased
+ *  when the next record reaches them, as the free space still starts at the first of them.
+ */
+void FlashStore_Abort(void)
+{
+	FlashStore_Receiving   = false;
+	FlashStore_PagePending = false;
+}
+
+/** Checks whether a record is being received. While one is, no other record can be started.
+ *
+ *  \return Boolean \c true from \ref FlashStore_Begin() until the last page of the record has been programmed
+ */
+bool FlashStore_IsOpen(void)
+{
+	return FlashStore_Receiving;
+}
+
+/** Gives the number of bytes of data still expected for the record being received.
+ *
+ *  \return Number of bytes still to be given to \ref FlashStore_Write(), zero if no record is being received
+ */
+uint16_t FlashStore_GetRemaining(void)
+{
+	return (FlashStore_Receiving ? FlashStore_Remaining : 0);
+}
+
+/** Checks whether the store has a page operation waiting, either a full page buffer or the erasure of the region.
+ *
+ *  \return Boolean \c true while FLASH is being programmed
+ */
+bool FlashStore_IsBusy(void)
+{
+	return (FlashStore_PagePending || (FlashStore_FormatPage != FLASH_STORE_NO_PAGE));
+}
+
+/** Checks whether a slot is held in the FLASH store.
+ *
+ *  \param[in] Slot  Slot to check
+ *
+ *  \return Boolean \c true if the store holds keys for the slot
+ */
+bool FlashStore_HasSlot(const uint8_t Slot)
+{
+	return ((Slot < FLASH_STORE_MAX_SLOTS) && (FlashStore_SlotPage[Slot] != FLASH_STORE_NO_PAGE));
+}
+
+/** Opens a stream over the keys of a slot held in the FLASH store, which are read in place.
+ *
+ *  \param[out] Stream  Stream to open
+ *  \param[in]  Slot    Slot to read
+ *
+ *  \return Boolean \c true if the store holds the slot, \c false otherwise
+ */
+bool FlashStore_OpenSlot(SecretStream_t* const Stream, const uint8_t Slot)
+{
+	FlashStoreHeader_t Header;
+
+	if (!(FlashStore_HasSlot(Slot)))
+	  return false;
+
+	FlashStore_ReadHeader(FlashStore_SlotPage[Slot], &Header);
+	SecretStream_Open(Stream, &FlashStore_PageAddress(FlashStore_SlotPage[Slot])[FLASH_STORE_HEADER_SIZE], Header.Length);
+	return true;
+}
+
+/** Counts the pages after the last record, which are free for new records until the region is formatted.
+ *
+ *  \return Number of free pages
+ */
+uint8_t FlashStore_GetFreePages(void)
+{
+	return (FLASH_STORE_PAGES - FlashStore_NextPage);
+}
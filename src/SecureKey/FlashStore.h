@@ -0,0 +1,100 @@
+/** \file
+ *
+ *  Header file for FlashStore.c.
+ */
+
+#ifndef _FLASHSTORE_H_
+#define _FLASHSTORE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/eeprom.h>
+		#include <avr/pgmspace.h>
+		#include <util/atomic.h>
+		#include <util/crc16.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include "SecretStream.h"
+
+	/* Macros: */
+		#if !defined(FLASH_STORE_PAGES) || defined(__DOXYGEN__)
+			/** Number of FLASH pages reserved for the store in the application section, which may be overridden from
+			 *  the makefile. Each page holds \c SPM_PAGESIZE bytes.
+			 */
+			#define FLASH_STORE_PAGES      64
+		#endif
+
+		/** Size in bytes of the FLASH region reserved for the store. */
+		#define FLASH_STORE_SIZE           ((uint16_t)FLASH_STORE_PAGES * SPM_PAGESIZE)
+
+		/** Number of slots which can be held in the FLASH store, from slot 0. */
+		#define FLASH_STORE_MAX_SLOTS      16
+
+		/** Size in bytes of \ref FlashStoreHeader_t as stored in FLASH. */
+		#define FLASH_STORE_HEADER_SIZE    5
+
+		/** Size in bytes of the CRC which follows the data of each record. */
+		#define FLASH_STORE_TRAILER_SIZE   2
+
+		/** Largest data length in bytes of a record, which then fills the whole store. */
+		#define FLASH_STORE_MAX_LENGTH     (FLASH_STORE_SIZE - FLASH_STORE_HEADER_SIZE - FLASH_STORE_TRAILER_SIZE)
+
+		/** Value of the magic field of a record header. */
+		#define FLASH_STORE_MAGIC          0x5346
+
+		/** Page index for a slot which is not held in the FLASH store. */
+		#define FLASH_STORE_NO_PAGE        0xFF
+
+		/** Size in bytes of the table of functions exported by the LUFA DFU bootloader, at the end of FLASH. */
+		#define BOOTLOADER_API_TABLE_SIZE          32
+
+		/** Byte address of the table of functions exported by the LUFA DFU bootloader. */
+		#define BOOTLOADER_API_TABLE_START         ((FLASHEND + 1UL) - BOOTLOADER_API_TABLE_SIZE)
+
+		/** Word address of the given entry of the bootloader function table, for use as a function pointer. */
+		#define BOOTLOADER_API_CALL(Index)         (void*)((BOOTLOADER_API_TABLE_START + ((Index) * 2)) / 2)
+
+		/** Byte address of the signature word which marks a bootloader exporting the function table. */
+		#define BOOTLOADER_MAGIC_SIGNATURE_START   (BOOTLOADER_API_TABLE_START + (BOOTLOADER_API_TABLE_SIZE - 2))
+
+		/** Value of the signature word of a bootloader exporting the function table. */
+		#define BOOTLOADER_MAGIC_SIGNATURE         0xDCFB
+
+	/* Enums: */
+		/** Enum for the results of \ref FlashStore_Begin() and \ref FlashStore_Format(). */
+		enum FlashStoreResults_t
+		{
+			FLASH_STORE_Started,      /**< The operation has started, and runs on in the background */
+			FLASH_STORE_Busy,         /**< Another record is still being received or written */
+			FLASH_STORE_BadSlot,      /**< The slot number is out of range */
+			FLASH_STORE_Full,         /**< There are not enough free pages left for the record */
+			FLASH_STORE_NoBootloader, /**< The bootloader does not export the functions needed to write FLASH */
+		};
+
+	/* Type Defines: */
+		/** Type define for the header of a record in the FLASH store. The record data, the packed keys of the slot,
+		 *  follows the header and is followed in turn by a CRC-16 of the slot, length and data. Records start on a page
+		 *  boundary, and a record with no data erases its slot from the store.
+		 */
+		typedef struct
+		{
+			uint16_t Magic;  /**< \ref FLASH_STORE_MAGIC */
+			uint8_t  Slot;   /**< Slot the record holds */
+			uint16_t Length; /**< Length of the record data in bytes */
+		} FlashStoreHeader_t;
+
+	/* Function Prototypes: */
+		void     FlashStore_Init(void);
+		void     FlashStore_Task(void);
+		uint8_t  FlashStore_Begin(const uint8_t Slot, const uint16_t Length);
+		uint16_t FlashStore_Write(const uint8_t* const Data, const uint16_t Count);
+		uint8_t  FlashStore_Format(void);
+		void     FlashStore_Abort(void);
+		bool     FlashStore_IsOpen(void);
+		uint16_t FlashStore_GetRemaining(void);
+		bool     FlashStore_IsBusy(void);
+		bool     FlashStore_HasSlot(const uint8_t Slot);
+		bool     FlashStore_OpenSlot(SecretStream_t* const Stream, const uint8_t Slot);
+		uint8_t  FlashStore_GetFreePages(void);
+#endif
@@ -0,0 +1,95 @@
+/** \file
+ *
+ *  Decoder for short, long, double and triple presses of HWB. The decoder is fed with the debounced, timestamped
+ *  events of the HWB driver and checked for timeouts on every millisecond tick, so that a gesture is reported on
+ *  the tick at which it becomes unambiguous: a long press once it has been held long enough, a triple press on its
+ *  last release, and a single or double press once the gap for a further press has passed.
+ */
+
+#include "Gesture.h"
+
+/** Enum for the states of the gesture decoder. */
+enum GestureStates_t
+{
+	GESTURE_STATE_Idle,     /**< HWB is released and no gesture is in progress */
+	GESTURE_STATE_Pressed,  /**< HWB is held during a gesture */
+	GESTURE_STATE_Released, /**< HWB was released during a gesture, which completes unless it is pressed again */
+	GESTURE_STATE_LongHeld, /**< A long press was reported and HWB is still held */
+};
+
+/** Feeds a debounced HWB event to a gesture decoder.
+ *
+ *  \param[in,out] Decoder  Pointer to the gesture decoder state
+ *  \param[in]     Event    HWB event to process
+ *
+ *  \return Gesture completed by the event, a value from \ref Gesture_t
+ */
+uint8_t Gesture_ProcessEvent(GestureDecoder_t* const Decoder, const hwb_event_t* const Event)
+{
+	if (Event->type == HWB_EVENT_PRESS)
+	{
+		if (Decoder->State == GESTURE_STATE_Idle)
+		  Decoder->Presses = 0;
+		else if (Decoder->State != GESTURE_STATE_Released)
+		  return GESTURE_NONE;
+
+		Decoder->Presses++;
+		Decoder->State    = GESTURE_STATE_Pressed;
+		Decoder->EdgeTime = Event->time;
+	}
+	else
+	{
+		if (Decoder->State == GESTURE_STATE_LongHeld)
+		  Decoder->State = GESTURE_STATE_Idle;
+
+		if (Decoder->State != GESTURE_STATE_Pressed)
+		  return GESTURE_NONE;
+
+		if (Decoder->Presses == GESTURE_MAX_PRESSES)
+		{
+			Decoder->State = GESTURE_STATE_Idle;
+			return Decoder->Presses;
+		}
+
+		Decoder->State    = GESTURE_STATE_Released;
+		Decoder->EdgeTime = Event->time;
+	}
+
+	return GESTURE_NONE;
+}
+
+/** Checks a gesture decoder for a gesture completed by the passing of time, which must be called on every tick
+ *  of the HWB clock for gestures to be reported without delay.
+ *
+ *  \param[in,out] Decoder  Pointer to the gesture decoder state
+ *  \param[in]     Now      Current time on the HWB clock
+ *
+ *  \return Gesture completed by the timeout, a value from \ref Gesture_t
+ */
+uint8_t Gesture_ProcessTimeout(GestureDecoder_t* const Decoder, const uint16_t Now)
+{
+	uint16_t Elapsed = (Now - Decoder->EdgeTime);
+
+	switch (Decoder->State)
+	{
+		case GESTURE_STATE_Pressed:
+			/* Only the first press of a gesture can be a long press; later ones complete on release */
+			if ((Decoder->Presses == 1) && (Elapsed >= GESTURE_LONG_PRESS_MS))
+			{
+				Decoder->State = GESTURE_STATE_LongHeld;
+				return GESTURE_LONG;
+			}
+
+			break;
+		case GESTURE_STATE_Released:
+			if (Elapsed >= GESTURE_MULTI_PRESS_GAP_MS)
+			{
+				Decoder->State = GESTURE_STATE_Idle;
+				return Decoder->Presses;
+			}
+
+			break;
+	}
+
+	return GESTURE_NONE;
+}
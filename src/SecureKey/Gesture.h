@@ -0,0 +1,49 @@
+/** \file
+ *
+ *  Header file for Gesture.c.
+ */
+
+#ifndef _GESTURE_H_
+#define _GESTURE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+
+		#include "HWif.h"
+
+	/* Macros: */
+		/** Milliseconds HWB must be held on the first press of a gesture for it to be a long press. */
+		#define GESTURE_LONG_PRESS_MS     600
+
+		/** Longest gap in milliseconds between a release and the next press of a double or triple press. */
+		#define GESTURE_MULTI_PRESS_GAP_MS  250
+
+		/** Number of presses of the longest multiple press gesture, which completes as soon as it is released. */
+		#define GESTURE_MAX_PRESSES       3
+
+	/* Enums: */
+		/** Enum for the gestures recognized by the decoder. Multiple presses have the value of their press count. */
+		enum Gesture_t
+		{
+			GESTURE_NONE   = 0, /**< No gesture was completed */
+			GESTURE_SHORT  = 1, /**< A single short press */
+			GESTURE_DOUBLE = 2, /**< Two short presses */
+			GESTURE_TRIPLE = 3, /**< Three short presses */
+			GESTURE_LONG   = 4, /**< A single press held for \ref GESTURE_LONG_PRESS_MS */
+			GESTURE_COUNT,      /**< Number of gesture values, for tables indexed by gesture */
+		};
+
+	/* Type Defines: */
+		/** Type define for the state of a gesture decoder. */
+		typedef struct
+		{
+			uint8_t  State;    /**< Decoder state, internal to the decoder */
+			uint8_t  Presses;  /**< Presses seen so far in the current gesture */
+			uint16_t EdgeTime; /**< HWB clock time of the last press or release of the current gesture */
+		} GestureDecoder_t;
+
+	/* Function Prototypes: */
+		uint8_t Gesture_ProcessEvent(GestureDecoder_t* const Decoder, const hwb_event_t* const Event);
+		uint8_t Gesture_ProcessTimeout(GestureDecoder_t* const Decoder, const uint16_t Now);
+#endif
@@ -1,52 +1,240 @@
 #include "HWif.h"
 
+#define LED_BLUE_MASK 0b00100000
+#define LED_RED_MASK  0b01000000
+
+/* Playback state of the pattern on one LED, advanced by led_tick(). Patterns are started and stopped from the USB
+   events and the report callback, which run in interrupt context, as well as from the main loop, so the state and
+   PORTD are only changed with interrupts held off. */
+typedef struct
+{
+	const led_step_t* pattern;
+	uint8_t           step;
+	uint16_t          remaining;
+} led_state_t;
+
+static led_state_t led_blue_state;
+static led_state_t led_red_state;
+
+/* Debounced HWB state, owned by the INT7 and SOF interrupts */
+static volatile char     hwb_pressed;
+static volatile uint8_t  hwb_lockout;
+static volatile uint16_t hwb_clock;
+
+/* Single producer, single consumer event queue: the interrupts only write the head, hwb_get_event() only the tail.
+   The entries are volatile as well as the indexes, so that an entry is written before the head moves past it and
+   read before the tail does. */
+static volatile hwb_event_t hwb_events[HWB_EVENT_QUEUE_SIZE];
+static volatile uint8_t  hwb_events_head;
+static volatile uint8_t  hwb_events_tail;
+
+static const led_step_t led_heartbeat[] PROGMEM =
+	{
+		LED_STEP(0, 2500), LED_STEP(1, 50), LED_STEP_REPEAT
+	};
+
+static const led_step_t led_fast_heartbeat[] PROGMEM =
+	{
+		LED_STEP(0, 500), LED_STEP(1, 10), LED_STEP_REPEAT
+	};
+
+static void led_set(uint8_t mask, char on)
+{
+	if (on) PORTD &= ~mask;
+	else    PORTD |=  mask;
+}
+
+static void led_load_step(led_state_t* state, uint8_t mask)
+{
+	led_step_t step = pgm_read_word(&state->pattern[state->step]);
+
+	if (step == LED_STEP_REPEAT)
+	{
+		state->step = 0;
+		step = pgm_read_word(&state->pattern[0]);
+	}
+
+	led_set(mask, (step & 0x8000) != 0);
+	state->remaining = (step & 0x7FFF);
+}
+
+static void led_advance(led_state_t* state, uint8_t mask)
+{
+	uint8_t sreg = SREG;
+	cli();
+
+	if ((state->pattern != NULL) && !(--state->remaining))
+	{
+		state->step++;
+		led_load_step(state, mask);
+	}
+
+	SREG = sreg;
+}
+
+static void led_start(led_state_t* state, uint8_t mask, const led_step_t* pattern)
+{
+	uint8_t sreg = SREG;
+	cli();
+
+	state->pattern = pattern;
+	state->step    = 0;
+	led_load_step(state, mask);
+
+	SREG = sreg;
+}
+
+/* Stops the pattern on an LED and holds it on or off */
+static void led_hold(led_state_t* state, uint8_t mask, char on)
+{
+	uint8_t sreg = SREG;
+	cli();
+
+	state->pattern = NULL;
+	led_set(mask, on);
+
+	SREG = sreg;
+}
+
+static void led_toggle(uint8_t mask)
+{
+	uint8_t sreg = SREG;
+	cli();
+
+	PORTD ^= mask;
+
+	SREG = sreg;
+}
+
+/* Advances the LED patterns by a millisecond; call once per millisecond from the main loop */
+void led_tick()
+{
+	led_advance(&led_blue_state, LED_BLUE_MASK);
+	led_advance(&led_red_state,  LED_RED_MASK);
+}
+
+void led_blue_pattern(const led_step_t* pattern)
+{
+	led_start(&led_blue_state, LED_BLUE_MASK, pattern);
+}
+
+void led_red_pattern(const led_step_t* pattern)
+{
+	led_start(&led_red_state, LED_RED_MASK, pattern);
+}
+
 void led_blue_heartbeat()
 {
-	_delay_ms(2500);
-	led_blue_toggle();
-	_delay_ms(50);
-	led_blue_toggle();
+	led_blue_pattern(led_heartbeat);
 }
 
 void led_blue_fast_heartbeat()
 {
-	_delay_ms(500);
-	led_blue_toggle();
-	_delay_ms(10);
-	led_blue_toggle();
+	led_blue_pattern(led_fast_heartbeat);
 }
 
 void led_red_heartbeat()
 {
-	_delay_ms(2500);
-	led_red_toggle();
-	_delay_ms(50);
-	led_red_toggle();
+	led_red_pattern(led_heartbeat);
 }
 
 void led_blue(char on)
 {
-	if (on) PORTD &= 0b11011111;
-	else    PORTD |= 0b00100000;
+	led_hold(&led_blue_state, LED_BLUE_MASK, on);
 }
 
 void led_blue_toggle()
 {
-	PORTD ^= 0b00100000;
+	led_toggle(LED_BLUE_MASK);
 }
 
 void led_red(char on)
 {
-	if (on) PORTD &= 0b10111111;
-	else    PORTD |= 0b01000000;
+	led_hold(&led_red_state, LED_RED_MASK, on);
 }
 
 void led_red_toggle()
 {
-	PORTD ^= 0b01000000;
+	led_toggle(LED_RED_MASK);
 }
 
 char hwb_is_pressed()
 {
 	return !(PIND & 0b10000000);
 }
+
+/* Takes a new HWB level as the debounced state, queues its event and ignores further edges until the lockout ends */
+static void hwb_accept(char pressed)
+{
+	if (pressed == hwb_pressed)
+		return;
+
+	hwb_pressed = pressed;
+	hwb_lockout = HWB_DEBOUNCE_MS;
+
+	uint8_t head = hwb_events_head;
+
+	/* Drop the event when the queue is full rather than overwrite one the reader has not seen */
+	if ((uint8_t)(head - hwb_events_tail) == HWB_EVENT_QUEUE_SIZE)
+		return;
+
+	hwb_events[head & (HWB_EVENT_QUEUE_SIZE - 1)].type = (pressed ? HWB_EVENT_PRESS : HWB_EVENT_RELEASE);
+	hwb_events[head & (HWB_EVENT_QUEUE_SIZE - 1)].time = hwb_clock;
+	hwb_events_head = head + 1;
+}
+
+/* The first edge is accepted at once, so a press is seen without waiting for the contacts to settle */
+ISR(INT7_vect)
+{
+	if (hwb_lockout)
+		return;
+
+	hwb_accept(!hwb_pressed);
+}
+
+/* Enables the HWB (PD7) edge interrupt; HWB must already be configured as an input */
+void hwb_init()
+{
+	hwb_pressed = hwb_is_pressed();
+
+	EICRB  = (EICRB & ~((1 << ISC71) | (1 << ISC70))) | (1 << ISC70);
+	EIFR   = (1 << INTF7);
+	EIMSK |= (1 << INT7);
+}
+
+/* Advances the HWB millisecond clock; call from the USB Start of Frame event. At the end of a lockout the pin is
+   sampled again, to catch a release or press which settled while edges were being ignored. */
+void hwb_tick()
+{
+	hwb_clock++;
+
+	if (hwb_lockout && !(--hwb_lockout))
+		hwb_accept(hwb_is_pressed());
+}
+
+uint16_t hwb_millis()
+{
+	uint16_t clock;
+
+	uint8_t sreg = SREG;
+	cli();
+	clock = hwb_clock;
+	SREG = sreg;
+
+	return clock;
+}
+
+/* Reads the oldest queued HWB event, returning zero when there is none */
+char hwb_get_event(hwb_event_t* event)
+{
+	uint8_t tail = hwb_events_tail;
+
+	if (tail == hwb_events_head)
+		return 0;
+
+	event->type = hwb_events[tail & (HWB_EVENT_QUEUE_SIZE - 1)].type;
+	event->time = hwb_events[tail & (HWB_EVENT_QUEUE_SIZE - 1)].time;
+	hwb_events_tail = tail + 1;
+
+	return 1;
+}
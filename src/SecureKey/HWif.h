@@ -8,11 +8,50 @@
 
 	/* Includes: */
 		#include <avr/io.h>
+		#include <avr/interrupt.h>
+		#include <avr/pgmspace.h>
+		#include <stddef.h>
+		#include <stdint.h>
 
 	/* Macros: */
+		/** Builds a step of an LED pattern, holding the LED on or off for 1 to 32767 milliseconds. */
+		#define LED_STEP(on, ms)    ((led_step_t)(((on) ? 0x8000 : 0) | (ms)))
 
+		/** Marks the end of an LED pattern, which then repeats from its first step. */
+		#define LED_STEP_REPEAT     ((led_step_t)0)
+
+		/** Milliseconds after an accepted HWB edge during which further edges are taken as contact bounce. */
+		#define HWB_DEBOUNCE_MS     10
+
+		/** Number of HWB events held until they are read; must be a power of two. */
+		#define HWB_EVENT_QUEUE_SIZE 8
+
+	/* Type Defines: */
+		/** Type define for a step of an LED pattern. Patterns are arrays of steps in FLASH memory, built with
+		 *  \ref LED_STEP() and ended by \ref LED_STEP_REPEAT.
+		 */
+		typedef uint16_t led_step_t;
+
+		/** Enum for the kinds of HWB event. */
+		enum hwb_event_types
+		{
+			HWB_EVENT_RELEASE = 0, /**< HWB was released */
+			HWB_EVENT_PRESS   = 1, /**< HWB was pressed */
+		};
+
+		/** Type define for a debounced HWB event, as read from the event queue with \ref hwb_get_event(). */
+		typedef struct
+		{
+			uint8_t  type; /**< Kind of event, a value from \ref hwb_event_types */
+			uint16_t time; /**< Millisecond clock of \ref hwb_tick() at the edge which caused the event */
+		} hwb_event_t;
 
 	/* Function Prototypes: */
+		void led_tick(void);
+
+		void led_blue_pattern(const led_step_t*);
+		void led_red_pattern(const led_step_t*);
+
 		void led_blue_heartbeat(void);
 		void led_blue_fast_heartbeat(void);
 
@@ -25,4 +64,8 @@
 		void led_red_toggle(void);
 
 		char hwb_is_pressed(void);
+		void hwb_init(void);
+		void hwb_tick(void);
+		uint16_t hwb_millis(void);
+		char hwb_get_event(hwb_event_t*);
 #endif
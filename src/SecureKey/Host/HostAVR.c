@@ -0,0 +1,66 @@
+/** \file
+ *
+ *  Registers, EEPROM and program space string formatting of the ATmega32U2, as stubbed for the host build of the
+ *  firmware.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+
+/** Longest format string given to \ref snprintf_P(). */
+#define HOST_AVR_MAX_FORMAT        160
+
+/* HWB (PD7) reads high while released, through the pull-up of the board */
+volatile uint8_t  PORTD, DDRD, PIND = 0x80;
+volatile uint8_t  MCUSR, SREG, SPL, SPH;
+volatile uint8_t  EICRB, EIMSK, EIFR;
+volatile uint8_t  TCCR0A, TCCR0B, OCR0A, TIMSK0;
+volatile uint8_t  TCCR1A, TCCR1B, TIFR1, TIMSK1;
+volatile uint16_t TCNT1;
+
+/** EEPROM contents, erased as when the device is first programmed. */
+uint8_t HostAVR_EEPROM[E2END + 1] =
+	{
+		[0 ... E2END] = 0xFF,
+	};
+
+/** Formats a string as avr-libc does, with a format string from FLASH memory. The \c %S conversion of avr-libc takes a
+ *  string in FLASH memory, where that of the host C library takes a wide string, so it is turned into \c %s first.
+ */
+int snprintf_P(char* const Buffer, const size_t Size, const char* const Format, ...)
+{
+	char    HostFormat[HOST_AVR_MAX_FORMAT];
+	size_t  Length = 0;
+	va_list Args;
+
+	for (const char* Next = Format; *Next && (Length < (sizeof(HostFormat) - 2)); Next++)
+	{
+		HostFormat[Length++] = *Next;
+
+		if ((*Next != '%') || !(Next[1]))
+		  continue;
+
+		/* Conversions are copied whole, flags and width included, so that the second % of a %% is not taken for the
+		   start of another */
+		while (strchr("-+ #.0123456789", Next[1]) && Next[1] && (Length < (sizeof(HostFormat) - 3)))
+		  HostFormat[Length++] = *(++Next);
+
+		if (!(*(++Next)))
+		  break;
+
+		HostFormat[Length++] = ((*Next == 'S') ? 's' : *Next);
+	}
+
+	HostFormat[Length] = '\0';
+
+	va_start(Args, Format);
+	int Written = vsnprintf(Buffer, Size, HostFormat, Args);
+	va_end(Args);
+
+	return Written;
+}
@@ -0,0 +1,392 @@
+/** \file
+ *
+ *  Typing benchmark of the host build. The firmware is built in with its main loop unchanged and runs against the
+ *  simulated USB host of HostUSB.c, which plays a terminal on the virtual serial port and a keyboard driver on the HID
+ *  interface. Each run pastes a text through the \c paste command, or types a vault slot from a press of HWB, decodes
+ *  the keyboard reports the host takes back into text and checks it against what was sent. The keys newly pressed in
+ *  a report are decoded twice, once in the order of the report array and once in keycode order, as host drivers
+ *  differ in which they follow, and both must give the same text.
+ *
+ *  For each run, the number of reports per character, the typing rate in simulated time, the occupancy of the CDC
+ *  receive ring and of the paste queue, sampled once per frame, and the host time spent in the report callback are
+ *  printed. Everything but the callback time depends on the firmware alone, so runs are exactly repeatable and a
+ *  change to the typing path shows up as a change of the figures.
+ *
+ *  The exit status is non-zero if any run types the wrong text or does not finish.
+ */
+
+#include <setjmp.h>
+#include <stdio.h>
+
+/* Built in rather than linked, so that the driver can sample the queues of the firmware */
+#define main SecureKey_Main
+#include "../SecureKey.c"
+#undef main
+
+#include "../KeymapTables.h"
+#include "HostUSB.h"
+
+/** Number of times the benchmark text is repeated in each paste run. */
+#if !defined(HOST_BENCH_REPEATS)
+	#define HOST_BENCH_REPEATS         4
+#endif
+
+/** Frames a run may take before it is taken to have stalled. */
+#define HOST_BENCH_TIMEOUT_MS      120000
+
+/** Frames HWB is held down for a short press. */
+#define HOST_BENCH_PRESS_MS        50
+
+/** Size of the buffers holding the sent and the typed text of a run. */
+#define HOST_BENCH_TEXT_SIZE       4096
+
+/** Type define for a benchmark run. */
+typedef struct
+{
+	const char* Name;   /**< Name of the run in the results */
+	uint8_t     Layout; /**< Keyboard layout selected for the run, a value from \ref KeymapLayouts_t */
+	bool        Paste;  /**< Flag set to paste the benchmark text, clear to type slot 0 from a press of HWB */
+} HostBenchRun_t;
+
+/** Enum for the orders in which the keys newly pressed in a report are decoded. */
+enum HostBenchOrders_t
+{
+	HOST_BENCH_ArrayOrder,   /**< Order of the keycode array of the report */
+	HOST_BENCH_KeyCodeOrder, /**< Ascending keycode order, as taken by hosts which track the keys as a bitmap */
+	HOST_BENCH_ORDERS,       /**< Number of decode orders */
+};
+
+/** Type define for the text decoded from the keyboard reports of a run in one order. */
+typedef struct
+{
+	char     Typed[HOST_BENCH_TEXT_SIZE]; /**< Decoded text */
+	uint16_t Length;                      /**< Length of the decoded text */
+	char     DeadKey;                     /**< Character of a dead key waiting for the Space which types it, or zero */
+} HostBenchDecoder_t;
+
+/** Enum for the phases of a run. */
+enum HostBenchPhases_t
+{
+	HOST_BENCH_Open,    /**< Opening the virtual serial port */
+	HOST_BENCH_Setup,   /**< Selecting the layout of the run */
+	HOST_BENCH_Start,   /**< Holding HWB down */
+	HOST_BENCH_Typing,  /**< Waiting for the typing statistics of the firmware */
+};
+
+/** Runs of the benchmark, in order. */
+static const HostBenchRun_t HostBench_Runs[] =
+	{
+		{ .Name = "paste us", .Layout = KEYMAP_LAYOUT_US, .Paste = true  },
+		{ .Name = "paste uk", .Layout = KEYMAP_LAYOUT_UK, .Paste = true  },
+		{ .Name = "paste de", .Layout = KEYMAP_LAYOUT_DE, .Paste = true  },
+		{ .Name = "paste fr", .Layout = KEYMAP_LAYOUT_FR, .Paste = true  },
+		{ .Name = "slot 0",   .Layout = KEYMAP_LAYOUT_US, .Paste = false },
+	};
+
+/** Text pasted by the paste runs, repeated \ref HOST_BENCH_REPEATS times: prose, both cases, repeated letters which
+ *  need a release between them, every printable ASCII symbol, and CR LF line endings of which the CR is dropped.
+ */
+static const char HostBench_Text[] =
+	"The quick brown fox jumps over the lazy dog. THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG!\r\n"
+	"Pack my box with five dozen liquor jugs: 0123456789, aabbccddeeff  zz\r\n"
+	"\t~`!@#$%^&*()_+-={}[]|\\:;\"'<>,.?/ https://example.com/?q=a&b=c#top user@example.org\r\n";
+
+/** HWB edge interrupt handler of HWif.c, raised here for the presses of a run. */
+void INT7_vect(void);
+
+/** Behaviour of the simulated host. */
+static void HostBench_Frame(void);
+static void HostBench_Report(const USB_KeyboardReport_Data_t* Report);
+
+static const HostUSB_Host_t HostBench_Host =
+	{
+		.PollingIntervalMS = KEYBOARD_POLLING_INTERVAL_MS,
+		.Frame             = HostBench_Frame,
+		.Report            = HostBench_Report,
+	};
+
+/** Return point of the firmware main loop once every run has finished. */
+static jmp_buf HostBench_Done;
+
+/** Index of the current run. */
+static uint8_t HostBench_Run;
+
+/** Phase of the current run, a value from \ref HostBenchPhases_t. */
+static uint8_t HostBench_Phase;
+
+/** Frames spent in the current phase. */
+static uint32_t HostBench_PhaseMS;
+
+/** Number of runs which failed. */
+static uint8_t HostBench_Failures;
+
+/** Text sent by the current run, and the text it is expected to type. */
+static char HostBench_Sent[HOST_BENCH_TEXT_SIZE];
+static char HostBench_Expected[HOST_BENCH_TEXT_SIZE];
+
+/** Text decoded from the keyboard reports of the current run, in each order of \ref HostBenchOrders_t. */
+static HostBenchDecoder_t HostBench_Decoders[HOST_BENCH_ORDERS];
+
+/** Previous keyboard report taken by the host, to tell newly pressed keys from held ones. */
+static USB_KeyboardReport_Data_t HostBench_PrevReport;
+
+/** Frames of the first and the last keyboard report of the current run, which bound its typing time. */
+static uint32_t HostBench_FirstReportMS, HostBench_LastReportMS;
+
+/** Per frame samples of the occupancy of the CDC receive ring and the paste queue. */
+static uint64_t HostBench_RingTotal, HostBench_QueueTotal;
+static uint16_t HostBench_RingMax, HostBench_QueueMax;
+static uint32_t HostBench_Samples;
+
+/** Appends a decoded character to the typed text of a decoder. */
+static void HostBench_Type(HostBenchDecoder_t* const Decoder, const char Character)
+{
+	if (Decoder->Length < (sizeof(Decoder->Typed) - 1))
+	  Decoder->Typed[Decoder->Length++] = Character;
+}
+
+/** Decodes a keystroke into the character the layout of the run gives it, as the keyboard driver of the host does. */
+static void HostBench_Keystroke(HostBenchDecoder_t* const Decoder, const uint8_t Key, const uint8_t Modifier)
+{
+	const key_t* Table = KeymapTables[HostBench_Runs[HostBench_Run].Layout];
+
+	if (Decoder->DeadKey)
+	{
+		HostBench_Type(Decoder, (Key == KEYMAP_DEAD_KEY_SPACE) && !(Modifier) ? Decoder->DeadKey : '?');
+		Decoder->DeadKey = 0;
+		return;
+	}
+
+	for (uint8_t Character = 0; Character < KEYMAP_CHARACTERS; Character++)
+	{
+		if (!(Table[Character].key) || ((Table[Character].key & ~KEYMAP_DEAD_KEY) != Key) ||
+		    (Table[Character].mod != Modifier))
+		{
+			continue;
+		}
+
+		if (Table[Character].key & KEYMAP_DEAD_KEY)
+		  Decoder->DeadKey = Character;
+		else
+		  HostBench_Type(Decoder, Character);
+
+		return;
+	}
+
+	HostBench_Type(Decoder, '?');
+}
+
+/** Takes a keyboard report from the device, decoding the keys pressed since the previous one in each order. */
+static void HostBench_Report(const USB_KeyboardReport_Data_t* Report)
+{
+	uint8_t Pressed[sizeof(Report->KeyCode)];
+	uint8_t PressedCount = 0;
+
+	if (!(HostBench_FirstReportMS))
+	  HostBench_FirstReportMS = HostUSB_GetStats()->Frames;
+
+	HostBench_LastReportMS = HostUSB_GetStats()->Frames;
+
+	for (uint8_t Index = 0; (Index < sizeof(Report->KeyCode)) && Report->KeyCode[Index]; Index++)
+	{
+		if (!(memchr(HostBench_PrevReport.KeyCode, Report->KeyCode[Index], sizeof(HostBench_PrevReport.KeyCode))))
+		  Pressed[PressedCount++] = Report->KeyCode[Index];
+	}
+
+	for (uint8_t Index = 0; Index < PressedCount; Index++)
+	  HostBench_Keystroke(&HostBench_Decoders[HOST_BENCH_ArrayOrder], Pressed[Index], Report->Modifier);
+
+	/* Insertion sort, as a report holds at most six keys */
+	for (uint8_t Index = 1; Index < PressedCount; Index++)
+	{
+		uint8_t Key      = Pressed[Index];
+		uint8_t Position = Index;
+
+		for (; Position && (Pressed[Position - 1] > Key); Position--)
+		  Pressed[Position] = Pressed[Position - 1];
+
+		Pressed[Position] = Key;
+	}
+
+	for (uint8_t Index = 0; Index < PressedCount; Index++)
+	  HostBench_Keystroke(&HostBench_Decoders[HOST_BENCH_KeyCodeOrder], Pressed[Index], Report->Modifier);
+
+	HostBench_PrevReport = *Report;
+}
+
+/** Checks whether the device has sent a whole line containing the given text. */
+static bool HostBench_Received(const char* const Text)
+{
+	const char* Found = strstr(HostUSB_Received(), Text);
+
+	return ((Found != NULL) && (strstr(Found, "\r\n") != NULL));
+}
+
+/** Moves the current run to a new phase. */
+static void HostBench_SetPhase(const uint8_t Phase)
+{
+	HostBench_Phase   = Phase;
+	HostBench_PhaseMS = 0;
+	HostUSB_ClearReceived();
+}
+
+/** Starts the current run, clearing its measurements and sending or pressing whatever starts the typing. */
+static void HostBench_StartRun(void)
+{
+	const HostBenchRun_t* Run = &HostBench_Runs[HostBench_Run];
+
+	HostUSB_ClearStats();
+	memset(HostBench_Decoders, 0, sizeof(HostBench_Decoders));
+	HostBench_RingTotal   = HostBench_QueueTotal = 0;
+	HostBench_RingMax     = HostBench_QueueMax   = 0;
+	HostBench_Samples     = 0;
+	HostBench_Expected[0] = '\0';
+
+	HostBench_FirstReportMS = HostBench_LastReportMS = 0;
+
+	if (Run->Paste)
+	{
+		size_t Length = 0;
+
+		for (uint8_t Repeat = 0; Repeat < HOST_BENCH_REPEATS; Repeat++)
+		{
+			for (const char* Next = HostBench_Text; *Next; Next++)
+			{
+				if (*Next != '\r')
+				  HostBench_Expected[Length++] = *Next;
+			}
+		}
+
+		HostBench_Expected[Length] = '\0';
+
+		strcpy(HostBench_Sent, "paste\r");
+
+		for (uint8_t Repeat = 0; Repeat < HOST_BENCH_REPEATS; Repeat++)
+		  strcat(HostBench_Sent, HostBench_Text);
+
+		strcat(HostBench_Sent, (const char[]){PASTE_END_CHARACTER, '\0'});
+		HostUSB_Send(HostBench_Sent, strlen(HostBench_Sent));
+	}
+	else
+	{
+		PIND &= ~0x80;
+		INT7_vect();
+	}
+}
+
+/** Prints the results of the current run, and checks its typed text. */
+static void HostBench_FinishRun(void)
+{
+	const HostBenchRun_t*  Run   = &HostBench_Runs[HostBench_Run];
+	const HostUSB_Stats_t* Stats = HostUSB_GetStats();
+	const char* Typed      = HostBench_Decoders[HOST_BENCH_ArrayOrder].Typed;
+	const char* TypedByKey = HostBench_Decoders[HOST_BENCH_KeyCodeOrder].Typed;
+	uint16_t    Characters = HostBench_Decoders[HOST_BENCH_ArrayOrder].Length;
+	uint32_t    Samples    = (HostBench_Samples ? HostBench_Samples : 1);
+	uint32_t    TypingMS   = (HostBench_LastReportMS - HostBench_FirstReportMS);
+
+	printf("%-9s %6u %8u %9.2f %7u %8.1f %9.1f %9u %9.1f %9u %9.0f %9u\n",
+	       Run->Name, Characters, Stats->KeyboardReports,
+	       (double)Stats->KeyboardReports / (Characters ? Characters : 1),
+	       TypingMS, (Characters * 1000.0) / (TypingMS ? TypingMS : 1),
+	       (double)HostBench_RingTotal / Samples, HostBench_RingMax,
+	       (double)HostBench_QueueTotal / Samples, HostBench_QueueMax,
+	       (double)Stats->CallbackNS / (Stats->ReportCallbacks ? Stats->ReportCallbacks : 1), Stats->MaxCallbackNS);
+
+	if (Run->Paste && strcmp(Typed, HostBench_Expected))
+	{
+		printf("%-9s typed the wrong text:\n%s\n", Run->Name, Typed);
+		HostBench_Failures++;
+	}
+	else if (strcmp(Typed, TypedByKey))
+	{
+		printf("%-9s typed other text in keycode order:\n%s\n", Run->Name, TypedByKey);
+		HostBench_Failures++;
+	}
+	else if (!(Run->Paste) && !(Characters))
+	{
+		printf("%-9s typed nothing\n", Run->Name);
+		HostBench_Failures++;
+	}
+}
+
+/** Steps the runs of the benchmark at the end of every frame of the simulated host. */
+static void HostBench_Frame(void)
+{
+	const HostBenchRun_t* Run = &HostBench_Runs[HostBench_Run];
+	char Command[16];
+
+	HostBench_PhaseMS++;
+
+	switch (HostBench_Phase)
+	{
+		case HOST_BENCH_Open:
+			HostUSB_OpenPort(true);
+			HostBench_SetPhase(HOST_BENCH_Setup);
+
+			snprintf(Command, sizeof(Command), "\rlayout %s\r", Keymap_GetLayoutName(Run->Layout));
+			strcpy(HostBench_Sent, Command);
+			HostUSB_Send(HostBench_Sent, strlen(HostBench_Sent));
+			break;
+		case HOST_BENCH_Setup:
+			if (HostBench_Received("Layout "))
+			{
+				HostBench_SetPhase(Run->Paste ? HOST_BENCH_Typing : HOST_BENCH_Start);
+				HostBench_StartRun();
+			}
+
+			break;
+		case HOST_BENCH_Start:
+			if (!(Run->Paste) && (HostBench_PhaseMS == HOST_BENCH_PRESS_MS))
+			{
+				PIND |= 0x80;
+				INT7_vect();
+			}
+
+			if (HostBench_PhaseMS >= HOST_BENCH_PRESS_MS)
+			  HostBench_Phase = HOST_BENCH_Typing;
+
+			break;
+		case HOST_BENCH_Typing:
+			HostBench_RingTotal  += RingBuffer_GetCount(&USBtoREPL_Buffer);
+			HostBench_RingMax     = MAX(HostBench_RingMax, RingBuffer_GetCount(&USBtoREPL_Buffer));
+			HostBench_QueueTotal += (Paste_IsOpen(&PastePipe) ? RingBuffer_GetCount(&PastePipe.Queue) : 0);
+			HostBench_QueueMax    = MAX(HostBench_QueueMax, (Paste_IsOpen(&PastePipe) ? RingBuffer_GetCount(&PastePipe.Queue) : 0));
+			HostBench_Samples++;
+
+			if (HostBench_Received("Typed "))
+			{
+				HostBench_FinishRun();
+
+				if (++HostBench_Run == (sizeof(HostBench_Runs) / sizeof(HostBench_Runs[0])))
+				  longjmp(HostBench_Done, 1);
+
+				HostBench_SetPhase(HOST_BENCH_Open);
+			}
+
+			break;
+	}
+
+	if (HostBench_PhaseMS > HOST_BENCH_TIMEOUT_MS)
+	{
+		printf("%-9s stalled in phase %u, received:\n%s\n", Run->Name, HostBench_Phase, HostUSB_Received());
+		HostBench_Failures++;
+		longjmp(HostBench_Done, 1);
+	}
+}
+
+int main(void)
+{
+	printf("%u ms polling, %u ms/report, %u passes of the main loop per frame\n\n",
+	       KEYBOARD_POLLING_INTERVAL_MS, KeyboardReportIntervalMS, HOST_USB_PASSES_PER_FRAME);
+	printf("%-9s %6s %8s %9s %7s %8s %9s %9s %9s %9s %9s %9s\n",
+	       "run", "chars", "reports", "rep/char", "ms", "chars/s", "ring avg", "ring max", "queue avg", "queue max",
+	       "cb ns avg", "cb ns max");
+
+	HostUSB_Attach(&HostBench_Host);
+
+	if (!(setjmp(HostBench_Done)))
+	  SecureKey_Main();
+
+	return (HostBench_Failures ? 1 : 0);
+}
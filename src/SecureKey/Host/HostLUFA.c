@@ -0,0 +1,23 @@
+/** \file
+ *
+ *  HID and CDC device class drivers of LUFA, built over the endpoint API of the simulated USB host in place of the
+ *  stand-ins of HostUSB.c, which are left out with \c HOST_USB_LUFA_CLASS_DRIVERS defined.
+ *
+ *  The sources of the class drivers are included here, after this stub of the LUFA USB header, so that the private
+ *  interface it declares for them is in place. Their own relative includes of the LUFA headers are then kept out by
+ *  the include guards the stub defines.
+ */
+
+/* The events LUFA leaves to the application are aliases of one empty stub, whatever their parameters */
+#pragma GCC diagnostic ignored "-Wattribute-alias"
+
+#define  __INCLUDE_FROM_USB_DRIVER
+#define  __INCLUDE_FROM_HID_DRIVER
+#define  __INCLUDE_FROM_HID_DEVICE_C
+#define  __INCLUDE_FROM_CDC_DRIVER
+#define  __INCLUDE_FROM_CDC_DEVICE_C
+
+#include <LUFA/Drivers/USB/USB.h>
+
+#include <LUFA/Drivers/USB/Class/Device/HIDClassDevice.c>
+#include <LUFA/Drivers/USB/Class/Device/CDCClassDevice.c>
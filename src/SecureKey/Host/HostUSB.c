@@ -0,0 +1,863 @@
+/** \file
+ *
+ *  Simulated USB host and the LUFA device side API it is reached through, for the host build of the firmware. The
+ *  endpoints are modelled as banks which the firmware fills or drains through the endpoint API, and which the host
+ *  side empties or fills once per frame: the keyboard endpoint is polled at the interval of its descriptor, and the
+ *  virtual serial port moves a packet each way per frame. Time only advances as the firmware runs its main loop, by
+ *  a frame every \ref HOST_USB_PASSES_PER_FRAME calls of \c USB_USBTask(), so a run is exactly repeatable.
+ *
+ *  As a real host, it finds the endpoints from the configuration descriptor of the firmware, and opens the virtual
+ *  serial port with class requests on the control endpoint. The HID and CDC class drivers here follow those of LUFA
+ *  over the same endpoint API, so that the report callback of the firmware is called, and its reports are sent, on
+ *  the same frames as on the device. With \c HOST_USB_LUFA_CLASS_DRIVERS defined they are left out, for the class
+ *  drivers of LUFA itself to be built in their place, as the simulator build of Sim/ does.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <string.h>
+
+#if !defined(__AVR__)
+	#include <time.h>
+#endif
+
+#include "HostUSB.h"
+
+/** Type define for the state of a simulated endpoint. Banks are used in turn, from the oldest full bank. */
+typedef struct
+{
+	uint8_t  Data[HOST_USB_MAX_BANKS][HOST_USB_MAX_PACKET]; /**< Packet held by each bank */
+	uint16_t Length[HOST_USB_MAX_BANKS];                    /**< Bytes held by each bank */
+	uint16_t Size;                                          /**< Packet size of the endpoint */
+	uint8_t  Banks;                                         /**< Number of banks of the endpoint */
+	uint8_t  Full;                                          /**< Number of full banks, waiting for the other side */
+	uint8_t  First;                                         /**< Oldest full bank */
+	uint16_t Position;                                      /**< Read position of the firmware in the oldest OUT bank */
+} HostUSB_Endpoint_t;
+
+volatile uint8_t USB_DeviceState;
+
+USB_Request_Header_t USB_ControlRequest;
+
+/** Endpoints of the device, by direction (OUT, IN) and number. The control endpoint carries data both ways, and is
+ *  modelled as an endpoint in each direction.
+ */
+static HostUSB_Endpoint_t HostUSB_Endpoints[2][ENDPOINT_TOTAL_ENDPOINTS];
+
+/** Endpoint selected by the firmware, the OUT direction of the control endpoint when that is selected. */
+static HostUSB_Endpoint_t* HostUSB_Selected = &HostUSB_Endpoints[0][ENDPOINT_CONTROLEP];
+
+/** Flag set when the selected endpoint is an IN endpoint. */
+static bool HostUSB_SelectedIN;
+
+/** Flag set while a control request waits for the firmware to take its SETUP packet. */
+static bool HostUSB_SETUPReceived;
+
+/** Behaviour of the host, or \c NULL until the device is attached. */
+static const HostUSB_Host_t* HostUSB_Host;
+
+/** Counters of the host. */
+static HostUSB_Stats_t HostUSB_Stats;
+
+/** Current frame number, as sent in the Start of Frame packets. */
+static uint16_t HostUSB_FrameNumber;
+
+/** Calls of \c USB_USBTask() in the current frame. */
+static uint8_t  HostUSB_Passes;
+
+/** Flag set once the firmware has enabled the Start of Frame events. */
+static bool     HostUSB_SOFEvents;
+
+/** Address of the keyboard report endpoint, once configured. */
+static uint8_t  HostUSB_KeyboardAddress;
+
+/** Number of the control interface of the virtual serial port, which its class requests are sent to. */
+static uint8_t  HostUSB_SerialInterface;
+
+/** Addresses of the data IN and OUT endpoints of the virtual serial port, once configured. */
+static uint8_t  HostUSB_SerialINAddress, HostUSB_SerialOUTAddress;
+
+/** Data the host has still to send on the virtual serial port. */
+static const char* HostUSB_SendData;
+
+/** Number of bytes at \ref HostUSB_SendData. */
+static size_t HostUSB_SendLength;
+
+/** Data received from the virtual serial port, null terminated. */
+static char HostUSB_ReceiveData[HOST_USB_RECEIVE_SIZE];
+
+/** Number of bytes in \ref HostUSB_ReceiveData. */
+static uint16_t HostUSB_ReceiveLength;
+
+/** Returns the endpoint of an address. */
+static HostUSB_Endpoint_t* HostUSB_Endpoint(const uint8_t Address)
+{
+	return &HostUSB_Endpoints[(Address & ENDPOINT_DIR_IN) ? 1 : 0][Address & ENDPOINT_EPNUM_MASK];
+}
+
+/** Sets up an endpoint from its entry in a class driver endpoint table. */
+static void HostUSB_ConfigureEndpoint(const USB_Endpoint_Table_t* const Table)
+{
+	HostUSB_Endpoint_t* Endpoint = HostUSB_Endpoint(Table->Address);
+
+	memset(Endpoint, 0, sizeof(HostUSB_Endpoint_t));
+	Endpoint->Size  = MIN(Table->Size, HOST_USB_MAX_PACKET);
+	Endpoint->Banks = MIN(MAX(Table->Banks, 1), HOST_USB_MAX_BANKS);
+}
+
+/** Gives the selected endpoint for data sent to the host, which for the control endpoint is its IN direction. */
+static HostUSB_Endpoint_t* HostUSB_SelectedForIN(void)
+{
+	if (HostUSB_Selected == &HostUSB_Endpoints[0][ENDPOINT_CONTROLEP])
+	  return &HostUSB_Endpoints[1][ENDPOINT_CONTROLEP];
+
+	return HostUSB_Selected;
+}
+
+/** Gives the bank the firmware writes next on an IN endpoint, or the host writes next on an OUT endpoint. */
+static uint8_t HostUSB_NextBank(const HostUSB_Endpoint_t* const Endpoint)
+{
+	return ((Endpoint->First + Endpoint->Full) % Endpoint->Banks);
+}
+
+/** Takes the oldest full bank of an endpoint, returning its length, or -1 if no bank is full. */
+static int16_t HostUSB_TakeBank(HostUSB_Endpoint_t* const Endpoint, uint8_t* const Data)
+{
+	if (!(Endpoint->Full))
+	  return -1;
+
+	uint16_t Length = Endpoint->Length[Endpoint->First];
+
+	if (Data != NULL)
+	  memcpy(Data, Endpoint->Data[Endpoint->First], Length);
+
+	Endpoint->Length[Endpoint->First] = 0;
+	Endpoint->First = ((Endpoint->First + 1) % Endpoint->Banks);
+	Endpoint->Full--;
+
+	return Length;
+}
+
+/** Runs the host side of a frame: the Start of Frame event, a poll of the keyboard endpoint when due, and a packet each
+ *  way on the virtual serial port.
+ */
+static void HostUSB_RunFrame(void)
+{
+	HostUSB_FrameNumber = ((HostUSB_FrameNumber + 1) & 0x7FF);
+	HostUSB_Stats.Frames++;
+
+	if (HostUSB_SOFEvents)
+	  EVENT_USB_Device_StartOfFrame();
+
+	if (HostUSB_KeyboardAddress && !(HostUSB_FrameNumber % MAX(HostUSB_Host->PollingIntervalMS, 1)))
+	{
+		USB_KeyboardReport_Data_t Report;
+
+		HostUSB_Stats.KeyboardPolls++;
+
+		if (HostUSB_TakeBank(HostUSB_Endpoint(HostUSB_KeyboardAddress), (uint8_t*)&Report) == sizeof(Report))
+		{
+			HostUSB_Stats.KeyboardReports++;
+
+			if (HostUSB_Host->Report != NULL)
+			  HostUSB_Host->Report(&Report);
+		}
+	}
+
+	if (HostUSB_SerialINAddress)
+	{
+		HostUSB_Endpoint_t* DataIN  = HostUSB_Endpoint(HostUSB_SerialINAddress);
+		HostUSB_Endpoint_t* DataOUT = HostUSB_Endpoint(HostUSB_SerialOUTAddress);
+		uint8_t             Packet[HOST_USB_MAX_PACKET];
+		int16_t             Length  = HostUSB_TakeBank(DataIN, Packet);
+
+		if (Length > 0)
+		{
+			Length = MIN(Length, (int16_t)(sizeof(HostUSB_ReceiveData) - 1 - HostUSB_ReceiveLength));
+			memcpy(&HostUSB_ReceiveData[HostUSB_ReceiveLength], Packet, Length);
+			HostUSB_ReceiveLength += Length;
+			HostUSB_ReceiveData[HostUSB_ReceiveLength] = '\0';
+			HostUSB_Stats.SerialBytesIn += Length;
+		}
+
+		/* A full OUT endpoint NAKs the host, which keeps the data until the firmware has made room */
+		if (HostUSB_SendLength && (DataOUT->Full < DataOUT->Banks))
+		{
+			uint8_t Bank = HostUSB_NextBank(DataOUT);
+
+			Length = MIN(HostUSB_SendLength, DataOUT->Size);
+			memcpy(DataOUT->Data[Bank], HostUSB_SendData, Length);
+			DataOUT->Length[Bank] = Length;
+			DataOUT->Full++;
+
+			HostUSB_SendData   += Length;
+			HostUSB_SendLength -= Length;
+			HostUSB_Stats.SerialBytesOut += Length;
+		}
+	}
+
+	if (HostUSB_Host->Frame != NULL)
+	  HostUSB_Host->Frame();
+}
+
+/** Sends a class or vendor request to the device, as the USB interrupt of LUFA hands it to the firmware: with the
+ *  control endpoint selected, and any data stage, of a single packet here, already received. A reply of the device is
+ *  dropped, as the host makes no request which needs one.
+ *
+ *  \param[in] RequestType  Type, direction and recipient of the request
+ *  \param[in] Request      Request number
+ *  \param[in] Value        Value of the request
+ *  \param[in] Index        Index of the request, such as the interface number
+ *  \param[in] Data         Data of the OUT data stage, or \c NULL
+ *  \param[in] Length       Length of the OUT data stage in bytes
+ */
+static void HostUSB_ControlRequest(const uint8_t RequestType, const uint8_t Request, const uint16_t Value,
+                                   const uint16_t Index, const void* const Data, const uint16_t Length)
+{
+	HostUSB_Endpoint_t* ControlOUT   = &HostUSB_Endpoints[0][ENDPOINT_CONTROLEP];
+	HostUSB_Endpoint_t* ControlIN    = &HostUSB_Endpoints[1][ENDPOINT_CONTROLEP];
+	HostUSB_Endpoint_t* PrevSelected = HostUSB_Selected;
+	bool                PrevIN       = HostUSB_SelectedIN;
+
+	USB_ControlRequest = (USB_Request_Header_t)
+		{
+			.bmRequestType = RequestType,
+			.bRequest      = Request,
+			.wValue        = Value,
+			.wIndex        = Index,
+			.wLength       = Length,
+		};
+
+	while (HostUSB_TakeBank(ControlOUT, NULL) >= 0);
+	ControlOUT->Position = 0;
+
+	if (Length)
+	{
+		ControlOUT->Length[ControlOUT->First] = MIN(Length, ControlOUT->Size);
+		memcpy(ControlOUT->Data[ControlOUT->First], Data, ControlOUT->Length[ControlOUT->First]);
+		ControlOUT->Full = 1;
+	}
+
+	HostUSB_SETUPReceived = true;
+
+	Endpoint_SelectEndpoint(ENDPOINT_CONTROLEP);
+	EVENT_USB_Device_ControlRequest();
+
+	HostUSB_SETUPReceived = false;
+	while (HostUSB_TakeBank(ControlIN, NULL) >= 0);
+	memset(ControlIN->Length, 0, sizeof(ControlIN->Length));
+
+	HostUSB_Selected   = PrevSelected;
+	HostUSB_SelectedIN = PrevIN;
+}
+
+/** Reads the configuration descriptor of the device, as a host does while enumerating it, for the keyboard report
+ *  endpoint, and for the control interface and the data endpoints of the virtual serial port.
+ */
+static void HostUSB_ReadConfiguration(void)
+{
+	const uint8_t* Descriptor;
+	uint16_t       Size  = CALLBACK_USB_GetDescriptor((DTYPE_Configuration << 8), 0, (const void**)&Descriptor);
+	uint8_t        Class = 0;
+
+	for (uint16_t Offset = 0; (Offset + sizeof(USB_Descriptor_Header_t)) <= Size; )
+	{
+		const uint8_t* Item   = &Descriptor[Offset];
+		uint8_t        Length = pgm_read_byte(Item + offsetof(USB_Descriptor_Header_t, Size));
+
+		if (!(Length))
+		  break;
+
+		switch (pgm_read_byte(Item + offsetof(USB_Descriptor_Header_t, Type)))
+		{
+			case DTYPE_Interface:
+				Class = pgm_read_byte(Item + offsetof(USB_Descriptor_Interface_t, Class));
+
+				if (Class == CDC_CSCP_CDCClass)
+				  HostUSB_SerialInterface = pgm_read_byte(Item + offsetof(USB_Descriptor_Interface_t, InterfaceNumber));
+
+				break;
+			case DTYPE_Endpoint:
+			{
+				uint8_t Address = pgm_read_byte(Item + offsetof(USB_Descriptor_Endpoint_t, EndpointAddress));
+
+				if ((Class == HID_CSCP_HIDClass) && (Address & ENDPOINT_DIR_IN))
+				  HostUSB_KeyboardAddress = Address;
+				else if ((Class == CDC_CSCP_CDCDataClass) && (Address & ENDPOINT_DIR_IN))
+				  HostUSB_SerialINAddress = Address;
+				else if (Class == CDC_CSCP_CDCDataClass)
+				  HostUSB_SerialOUTAddress = Address;
+
+				break;
+			}
+		}
+
+		Offset += Length;
+	}
+}
+
+/** Attaches the device to the simulated host, which enumerates it on the next run of the USB management task.
+ *
+ *  \param[in] Host  Behaviour of the host, which must stay valid while the firmware runs
+ */
+void HostUSB_Attach(const HostUSB_Host_t* const Host)
+{
+	HostUSB_Host = Host;
+}
+
+/** Opens or closes the virtual serial port on the host, setting the line coding and the DTR line as a terminal does.
+ *
+ *  \param[in] Open  Boolean \c true to open the port, \c false to close it
+ */
+void HostUSB_OpenPort(const bool Open)
+{
+	const CDC_LineEncoding_t LineEncoding = {.BaudRateBPS = 115200, .DataBits = 8};
+
+	if (!(HostUSB_SerialINAddress))
+	  return;
+
+	HostUSB_ControlRequest((REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE), CDC_REQ_SetLineEncoding,
+	                       0, HostUSB_SerialInterface, &LineEncoding, sizeof(LineEncoding));
+	HostUSB_ControlRequest((REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE), CDC_REQ_SetControlLineState,
+	                       (Open ? (CDC_CONTROL_LINE_OUT_DTR | CDC_CONTROL_LINE_OUT_RTS) : 0), HostUSB_SerialInterface,
+	                       NULL, 0);
+}
+
+/** Starts sending data to the virtual serial port of the device, a packet per frame for as long as the device takes
+ *  it.
+ *
+ *  \param[in] Data    Data to send, which must stay valid until it has been sent
+ *  \param[in] Length  Number of bytes to send
+ *
+ *  \return Boolean \c true if the data was taken, \c false if earlier data is still being sent
+ */
+bool HostUSB_Send(const char* const Data, const size_t Length)
+{
+	if (HostUSB_SendLength)
+	  return false;
+
+	HostUSB_SendData   = Data;
+	HostUSB_SendLength = Length;
+	return true;
+}
+
+/** Checks whether all the data given to \ref HostUSB_Send() has been delivered to the device.
+ *
+ *  \return Boolean \c true once nothing is left to send
+ */
+bool HostUSB_IsSent(void)
+{
+	return !(HostUSB_SendLength);
+}
+
+/** Gives the data received from the virtual serial port since it was last cleared.
+ *
+ *  \return Received data, null terminated; data past \ref HOST_USB_RECEIVE_SIZE is dropped
+ */
+const char* HostUSB_Received(void)
+{
+	return HostUSB_ReceiveData;
+}
+
+/** Clears the data received from the virtual serial port. */
+void HostUSB_ClearReceived(void)
+{
+	HostUSB_ReceiveLength  = 0;
+	HostUSB_ReceiveData[0] = '\0';
+}
+
+/** Gives the counters of the simulated host.
+ *
+ *  \return Pointer to the counters
+ */
+const HostUSB_Stats_t* HostUSB_GetStats(void)
+{
+	return &HostUSB_Stats;
+}
+
+/** Clears the counters of the simulated host. */
+void HostUSB_ClearStats(void)
+{
+	memset(&HostUSB_Stats, 0, sizeof(HostUSB_Stats));
+}
+
+void USB_Init(void)
+{
+	const USB_Endpoint_Table_t Control[] =
+		{
+			{ .Address = (ENDPOINT_DIR_OUT | ENDPOINT_CONTROLEP), .Size = FIXED_CONTROL_ENDPOINT_SIZE, .Banks = 1 },
+			{ .Address = (ENDPOINT_DIR_IN  | ENDPOINT_CONTROLEP), .Size = FIXED_CONTROL_ENDPOINT_SIZE, .Banks = 1 },
+		};
+
+	HostUSB_ConfigureEndpoint(&Control[0]);
+	HostUSB_ConfigureEndpoint(&Control[1]);
+
+	USB_DeviceState = DEVICE_STATE_Unattached;
+}
+
+/** Runs the USB management of the firmware, which here enumerates the device once attached and advances the frame
+ *  clock.
+ */
+void USB_USBTask(void)
+{
+	if (HostUSB_Host == NULL)
+	  return;
+
+	if (USB_DeviceState == DEVICE_STATE_Unattached)
+	{
+		USB_DeviceState = DEVICE_STATE_Configured;
+
+		EVENT_USB_Device_Connect();
+		EVENT_USB_Device_ConfigurationChanged();
+
+		HostUSB_ReadConfiguration();
+	}
+
+	if (++HostUSB_Passes < HOST_USB_PASSES_PER_FRAME)
+	  return;
+
+	HostUSB_Passes = 0;
+	HostUSB_RunFrame();
+}
+
+void USB_Device_EnableSOFEvents(void)
+{
+	HostUSB_SOFEvents = true;
+}
+
+uint16_t USB_Device_GetFrameNumber(void)
+{
+	return HostUSB_FrameNumber;
+}
+
+bool Endpoint_ConfigureEndpointTable(const USB_Endpoint_Table_t* const Table, const uint8_t Entries)
+{
+	for (uint8_t Index = 0; Index < Entries; Index++)
+	{
+		if (Table[Index].Address)
+		  HostUSB_ConfigureEndpoint(&Table[Index]);
+	}
+
+	return true;
+}
+
+void Endpoint_SelectEndpoint(const uint8_t Address)
+{
+	HostUSB_Selected   = HostUSB_Endpoint(Address);
+	HostUSB_SelectedIN = ((Address & ENDPOINT_DIR_IN) != 0);
+}
+
+bool Endpoint_IsReadWriteAllowed(void)
+{
+	if (!(HostUSB_SelectedIN))
+	  return (HostUSB_Selected->Full && (HostUSB_Selected->Position < HostUSB_Selected->Length[HostUSB_Selected->First]));
+
+	return ((HostUSB_Selected->Full < HostUSB_Selected->Banks) &&
+	        (HostUSB_Selected->Length[HostUSB_NextBank(HostUSB_Selected)] < HostUSB_Selected->Size));
+}
+
+bool Endpoint_IsINReady(void)
+{
+	HostUSB_Endpoint_t* Endpoint = HostUSB_SelectedForIN();
+
+	return (Endpoint->Full < Endpoint->Banks);
+}
+
+bool Endpoint_IsOUTReceived(void)
+{
+	return (HostUSB_Selected->Full != 0);
+}
+
+bool Endpoint_IsSETUPReceived(void)
+{
+	return (HostUSB_SETUPReceived && (HostUSB_Selected == &HostUSB_Endpoints[0][ENDPOINT_CONTROLEP]));
+}
+
+uint16_t Endpoint_BytesInEndpoint(void)
+{
+	if (!(HostUSB_SelectedIN))
+	  return (HostUSB_Selected->Length[HostUSB_Selected->First] - HostUSB_Selected->Position);
+
+	return HostUSB_Selected->Length[HostUSB_NextBank(HostUSB_Selected)];
+}
+
+uint8_t Endpoint_Read_8(void)
+{
+	return HostUSB_Selected->Data[HostUSB_Selected->First][HostUSB_Selected->Position++];
+}
+
+uint32_t Endpoint_Read_32_LE(void)
+{
+	uint32_t Data = 0;
+
+	for (uint8_t Byte = 0; Byte < 4; Byte++)
+	  Data |= ((uint32_t)Endpoint_Read_8() << (Byte * 8));
+
+	return Data;
+}
+
+void Endpoint_Write_8(const uint8_t Data)
+{
+	HostUSB_Endpoint_t* Endpoint = HostUSB_SelectedForIN();
+	uint8_t             Bank     = HostUSB_NextBank(Endpoint);
+
+	if (Endpoint->Length[Bank] < HOST_USB_MAX_PACKET)
+	  Endpoint->Data[Bank][Endpoint->Length[Bank]++] = Data;
+}
+
+void Endpoint_Write_16_LE(const uint16_t Data)
+{
+	Endpoint_Write_8(Data & 0xFF);
+	Endpoint_Write_8(Data >> 8);
+}
+
+void Endpoint_Write_32_LE(const uint32_t Data)
+{
+	Endpoint_Write_16_LE(Data & 0xFFFF);
+	Endpoint_Write_16_LE(Data >> 16);
+}
+
+void Endpoint_ClearIN(void)
+{
+	HostUSB_Endpoint_t* Endpoint = HostUSB_SelectedForIN();
+
+	if (Endpoint->Full < Endpoint->Banks)
+	  Endpoint->Full++;
+}
+
+void Endpoint_ClearOUT(void)
+{
+	HostUSB_TakeBank(HostUSB_Selected, NULL);
+	HostUSB_Selected->Position = 0;
+}
+
+void Endpoint_ClearSETUP(void)
+{
+	HostUSB_SETUPReceived = false;
+}
+
+/** Completes the status stage of a control request, which the simulated host takes as done once the request has been
+ *  handled.
+ */
+void Endpoint_ClearStatusStage(void)
+{
+}
+
+/** Checks whether the selected endpoint is ready for the firmware, which LUFA waits for. Time only moves on between
+ *  passes of the main loop here, so an endpoint which is not ready cannot become so while waiting, and the wait times
+ *  out at once.
+ */
+uint8_t Endpoint_WaitUntilReady(void)
+{
+	if (USB_DeviceState == DEVICE_STATE_Unattached)
+	  return ENDPOINT_READYWAIT_DeviceDisconnected;
+
+	if (HostUSB_SelectedIN ? Endpoint_IsINReady() : Endpoint_IsOUTReceived())
+	  return ENDPOINT_READYWAIT_NoError;
+
+	return ENDPOINT_READYWAIT_Timeout;
+}
+
+/** Writes a stream of bytes to the selected IN endpoint as LUFA does, sending each packet once it is full. With
+ *  \c BytesProcessed given, the stream stops at the first full bank so that it can be resumed from the same point.
+ */
+static uint8_t HostUSB_WriteStream(const uint8_t* Data, uint16_t Length, uint16_t* const BytesProcessed,
+                                   const bool InFLASH)
+{
+	uint16_t BytesInTransfer = 0;
+	uint8_t  ErrorCode;
+
+	if ((ErrorCode = Endpoint_WaitUntilReady()))
+	  return ErrorCode;
+
+	if (BytesProcessed != NULL)
+	{
+		Length -= *BytesProcessed;
+		Data   += *BytesProcessed;
+	}
+
+	while (Length)
+	{
+		if (!(Endpoint_IsReadWriteAllowed()))
+		{
+			Endpoint_ClearIN();
+
+			if (BytesProcessed != NULL)
+			{
+				*BytesProcessed += BytesInTransfer;
+				return ENDPOINT_RWSTREAM_IncompleteTransfer;
+			}
+
+			if ((ErrorCode = Endpoint_WaitUntilReady()))
+			  return ErrorCode;
+		}
+		else
+		{
+			Endpoint_Write_8(InFLASH ? pgm_read_byte(Data) : *Data);
+			Data++;
+			Length--;
+			BytesInTransfer++;
+		}
+	}
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+uint8_t Endpoint_Write_Stream_LE(const void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed)
+{
+	return HostUSB_WriteStream((const uint8_t*)Buffer, Length, BytesProcessed, false);
+}
+
+uint8_t Endpoint_Write_PStream_LE(const void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed)
+{
+	return HostUSB_WriteStream((const uint8_t*)Buffer, Length, BytesProcessed, true);
+}
+
+/** Reads a stream of bytes from the selected OUT endpoint as LUFA does, releasing each packet once it is empty. With
+ *  \c BytesProcessed given, the stream stops at the first empty bank so that it can be resumed from the same point.
+ */
+uint8_t Endpoint_Read_Stream_LE(void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed)
+{
+	uint8_t* Data            = (uint8_t*)Buffer;
+	uint16_t BytesInTransfer = 0;
+	uint8_t  ErrorCode;
+
+	if ((ErrorCode = Endpoint_WaitUntilReady()))
+	  return ErrorCode;
+
+	if (BytesProcessed != NULL)
+	{
+		Length -= *BytesProcessed;
+		Data   += *BytesProcessed;
+	}
+
+	while (Length)
+	{
+		if (!(Endpoint_IsReadWriteAllowed()))
+		{
+			Endpoint_ClearOUT();
+
+			if (BytesProcessed != NULL)
+			{
+				*BytesProcessed += BytesInTransfer;
+				return ENDPOINT_RWSTREAM_IncompleteTransfer;
+			}
+
+			if ((ErrorCode = Endpoint_WaitUntilReady()))
+			  return ErrorCode;
+		}
+		else
+		{
+			*Data++ = Endpoint_Read_8();
+			Length--;
+			BytesInTransfer++;
+		}
+	}
+
+	return ENDPOINT_RWSTREAM_NoError;
+}
+
+/** Writes the data stage of a control request, in as many packets as the IN direction of the control endpoint has
+ *  banks for, as the host only takes them once the request has been handled.
+ */
+uint8_t Endpoint_Write_Control_Stream_LE(const void* const Buffer, uint16_t Length)
+{
+	const uint8_t*      Data     = (const uint8_t*)Buffer;
+	HostUSB_Endpoint_t* Endpoint = &HostUSB_Endpoints[1][ENDPOINT_CONTROLEP];
+
+	Length = MIN(Length, USB_ControlRequest.wLength);
+
+	do
+	{
+		if (!(Endpoint_IsINReady()))
+		  return ENDPOINT_RWCSTREAM_HostAborted;
+
+		while (Length && (Endpoint->Length[HostUSB_NextBank(Endpoint)] < Endpoint->Size))
+		{
+			Endpoint_Write_8(*Data++);
+			Length--;
+		}
+
+		Endpoint_ClearIN();
+	}
+	while (Length);
+
+	return ENDPOINT_RWCSTREAM_NoError;
+}
+
+/** Reads the data stage of a control request, releasing each packet of it once it is empty. */
+uint8_t Endpoint_Read_Control_Stream_LE(void* const Buffer, uint16_t Length)
+{
+	uint8_t* Data = (uint8_t*)Buffer;
+
+	while (Length)
+	{
+		if (!(Endpoint_IsOUTReceived()))
+		  return ENDPOINT_RWCSTREAM_HostAborted;
+
+		while (Length && Endpoint_BytesInEndpoint())
+		{
+			*Data++ = Endpoint_Read_8();
+			Length--;
+		}
+
+		if (!(Endpoint_BytesInEndpoint()))
+		  Endpoint_ClearOUT();
+	}
+
+	return ENDPOINT_RWCSTREAM_NoError;
+}
+
+#if !defined(HOST_USB_LUFA_CLASS_DRIVERS)
+/** Gives the time of a monotonic host clock in nanoseconds. The simulator build of Sim/ has no clock, and counts
+ *  the cycles of the callback itself, so there this is always zero.
+ */
+static uint64_t HostUSB_Nanoseconds(void)
+{
+#if defined(__AVR__)
+	return 0;
+#else
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return ((uint64_t)Now.tv_sec * 1000000000 + Now.tv_nsec);
+#endif
+}
+
+bool HID_Device_ConfigureEndpoints(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
+{
+	memset(&HIDInterfaceInfo->State, 0, sizeof(HIDInterfaceInfo->State));
+	HIDInterfaceInfo->State.UsingReportProtocol = true;
+	HIDInterfaceInfo->State.IdleCount           = 500;
+
+	HIDInterfaceInfo->Config.ReportINEndpoint.Type = EP_TYPE_INTERRUPT;
+
+	return Endpoint_ConfigureEndpointTable(&HIDInterfaceInfo->Config.ReportINEndpoint, 1);
+}
+
+/** Handles the HID class requests, of which the simulated host makes none. */
+void HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
+{
+}
+
+/** Runs the HID class driver as LUFA does: once per frame, and while the report endpoint has a free bank, the report
+ *  callback of the firmware is called and its report sent if forced, changed or due at the end of the idle period.
+ */
+void HID_Device_USBTask(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
+{
+	if (USB_DeviceState != DEVICE_STATE_Configured)
+	  return;
+
+	if (HIDInterfaceInfo->State.PrevFrameNum == USB_Device_GetFrameNumber())
+	  return;
+
+	Endpoint_SelectEndpoint(HIDInterfaceInfo->Config.ReportINEndpoint.Address);
+
+	if (!(Endpoint_IsReadWriteAllowed()))
+	  return;
+
+	uint8_t  ReportINData[HIDInterfaceInfo->Config.PrevReportINBufferSize];
+	uint8_t  ReportID     = 0;
+	uint16_t ReportINSize = 0;
+
+	memset(ReportINData, 0, sizeof(ReportINData));
+
+	uint64_t Start     = HostUSB_Nanoseconds();
+	bool     ForceSend = CALLBACK_HID_Device_CreateHIDReport(HIDInterfaceInfo, &ReportID, HID_REPORT_ITEM_In,
+	                                                         ReportINData, &ReportINSize);
+	uint32_t Elapsed   = (uint32_t)(HostUSB_Nanoseconds() - Start);
+
+	HostUSB_Stats.ReportCallbacks++;
+	HostUSB_Stats.CallbackNS += Elapsed;
+	HostUSB_Stats.MaxCallbackNS = MAX(HostUSB_Stats.MaxCallbackNS, Elapsed);
+
+	bool StatesChanged     = false;
+	bool IdlePeriodElapsed = (HIDInterfaceInfo->State.IdleCount && !(HIDInterfaceInfo->State.IdleMSRemaining));
+
+	if (HIDInterfaceInfo->Config.PrevReportINBuffer != NULL)
+	{
+		StatesChanged = (memcmp(ReportINData, HIDInterfaceInfo->Config.PrevReportINBuffer, ReportINSize) != 0);
+		memcpy(HIDInterfaceInfo->Config.PrevReportINBuffer, ReportINData, HIDInterfaceInfo->Config.PrevReportINBufferSize);
+	}
+
+	if (ReportINSize && (ForceSend || StatesChanged || IdlePeriodElapsed))
+	{
+		HIDInterfaceInfo->State.IdleMSRemaining = HIDInterfaceInfo->State.IdleCount;
+
+		Endpoint_SelectEndpoint(HIDInterfaceInfo->Config.ReportINEndpoint.Address);
+
+		if (ReportID)
+		  Endpoint_Write_8(ReportID);
+
+		Endpoint_Write_Stream_LE(ReportINData, ReportINSize, NULL);
+
+		Endpoint_ClearIN();
+	}
+
+	HIDInterfaceInfo->State.PrevFrameNum = USB_Device_GetFrameNumber();
+}
+
+bool CDC_Device_ConfigureEndpoints(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	memset(&CDCInterfaceInfo->State, 0, sizeof(CDCInterfaceInfo->State));
+
+	CDCInterfaceInfo->Config.DataINEndpoint.Type       = EP_TYPE_BULK;
+	CDCInterfaceInfo->Config.DataOUTEndpoint.Type      = EP_TYPE_BULK;
+	CDCInterfaceInfo->Config.NotificationEndpoint.Type = EP_TYPE_INTERRUPT;
+
+	return (Endpoint_ConfigureEndpointTable(&CDCInterfaceInfo->Config.DataINEndpoint, 1) &&
+	        Endpoint_ConfigureEndpointTable(&CDCInterfaceInfo->Config.DataOUTEndpoint, 1) &&
+	        Endpoint_ConfigureEndpointTable(&CDCInterfaceInfo->Config.NotificationEndpoint, 1));
+}
+
+/** Handles the CDC class requests the simulated host makes to open and close the port, as LUFA does. */
+void CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	if (!(Endpoint_IsSETUPReceived()))
+	  return;
+
+	if ((USB_ControlRequest.wIndex != CDCInterfaceInfo->Config.ControlInterfaceNumber) ||
+	    (USB_ControlRequest.bmRequestType != (REQDIR_HOSTTODEVICE | REQTYPE_CLASS | REQREC_INTERFACE)))
+	{
+		return;
+	}
+
+	switch (USB_ControlRequest.bRequest)
+	{
+		case CDC_REQ_SetLineEncoding:
+			Endpoint_ClearSETUP();
+
+			if (!(Endpoint_IsOUTReceived()))
+			  return;
+
+			CDCInterfaceInfo->State.LineEncoding.BaudRateBPS = Endpoint_Read_32_LE();
+			CDCInterfaceInfo->State.LineEncoding.CharFormat  = Endpoint_Read_8();
+			CDCInterfaceInfo->State.LineEncoding.ParityType  = Endpoint_Read_8();
+			CDCInterfaceInfo->State.LineEncoding.DataBits    = Endpoint_Read_8();
+
+			Endpoint_ClearOUT();
+			Endpoint_ClearStatusStage();
+			break;
+		case CDC_REQ_SetControlLineState:
+			Endpoint_ClearSETUP();
+			Endpoint_ClearStatusStage();
+
+			CDCInterfaceInfo->State.ControlLineStates.HostToDevice = USB_ControlRequest.wValue;
+
+			EVENT_CDC_Device_ControLineStateChanged(CDCInterfaceInfo);
+			break;
+	}
+}
+
+/** Runs the CDC class driver as LUFA does, sending any partly filled packet left in the data IN endpoint. */
+void CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	if ((USB_DeviceState != DEVICE_STATE_Configured) || !(CDCInterfaceInfo->State.LineEncoding.BaudRateBPS))
+	  return;
+
+	Endpoint_SelectEndpoint(CDCInterfaceInfo->Config.DataINEndpoint.Address);
+
+	if (Endpoint_IsINReady() && Endpoint_BytesInEndpoint())
+	  Endpoint_ClearIN();
+}
+#endif
@@ -0,0 +1,66 @@
+/** \file
+ *
+ *  Header file for HostUSB.c.
+ */
+
+#ifndef _HOST_USB_H_
+#define _HOST_USB_H_
+
+	/* Includes: */
+		#include <stdbool.h>
+		#include <stddef.h>
+		#include <stdint.h>
+
+		#include <LUFA/Drivers/USB/USB.h>
+
+	/* Macros: */
+		/** Passes of the main loop of the firmware, that is calls of \c USB_USBTask(), in each simulated 1 ms frame.
+		 *  This sets how much work the firmware gets through between two Start of Frame events.
+		 */
+		#if !defined(HOST_USB_PASSES_PER_FRAME)
+			#define HOST_USB_PASSES_PER_FRAME  4
+		#endif
+
+		/** Largest number of banks of a simulated endpoint. */
+		#define HOST_USB_MAX_BANKS         2
+
+		/** Largest packet size of a simulated endpoint. */
+		#define HOST_USB_MAX_PACKET        64
+
+		/** Size of the buffer holding the data the device has sent on the virtual serial port. */
+		#if !defined(HOST_USB_RECEIVE_SIZE)
+			#define HOST_USB_RECEIVE_SIZE  1024
+		#endif
+
+	/* Type Defines: */
+		/** Type define for the behaviour of the simulated USB host, given to \ref HostUSB_Attach(). */
+		typedef struct
+		{
+			uint8_t PollingIntervalMS;                                  /**< Frames between polls of the keyboard endpoint */
+			void    (*Frame)(void);                                     /**< Called at the end of every frame, or \c NULL */
+			void    (*Report)(const USB_KeyboardReport_Data_t* Report); /**< Called for every keyboard report the host takes, or \c NULL */
+		} HostUSB_Host_t;
+
+		/** Type define for the counters of the simulated USB host, cleared by \ref HostUSB_ClearStats(). */
+		typedef struct
+		{
+			uint32_t Frames;            /**< Frames run */
+			uint32_t KeyboardPolls;     /**< Polls of the keyboard endpoint */
+			uint32_t KeyboardReports;   /**< Keyboard reports taken by the host */
+			uint32_t ReportCallbacks;   /**< Calls of the report creation callback of the firmware */
+			uint64_t CallbackNS;        /**< Host time spent in the report creation callback, in nanoseconds */
+			uint32_t MaxCallbackNS;     /**< Longest single call of the report creation callback, in nanoseconds */
+			uint32_t SerialBytesOut;    /**< Bytes delivered to the virtual serial port of the device */
+			uint32_t SerialBytesIn;     /**< Bytes received from the virtual serial port of the device */
+		} HostUSB_Stats_t;
+
+	/* Function Prototypes: */
+		void HostUSB_Attach(const HostUSB_Host_t* const Host);
+		void HostUSB_OpenPort(const bool Open);
+		bool HostUSB_Send(const char* const Data, const size_t Length);
+		bool HostUSB_IsSent(void);
+		const char* HostUSB_Received(void);
+		void HostUSB_ClearReceived(void);
+		const HostUSB_Stats_t* HostUSB_GetStats(void);
+		void HostUSB_ClearStats(void);
+#endif
@@ -0,0 +1,38 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc EEPROM header. The EEPROM is an array in HostAVR.c, erased at start-up, and writes
+ *  complete at once.
+ */
+
+#ifndef _HOST_AVR_EEPROM_H_
+#define _HOST_AVR_EEPROM_H_
+
+	/* Includes: */
+		#include <stdbool.h>
+		#include <stdint.h>
+
+		#include <avr/io.h>
+
+	/* Macros: */
+		#define EEMEM
+		#define eeprom_is_ready()      true
+
+	/* External Variables: */
+		extern uint8_t HostAVR_EEPROM[E2END + 1];
+
+	/* Inline Functions: */
+		static inline uint8_t eeprom_read_byte(const uint8_t* const Address)
+		{
+			return HostAVR_EEPROM[(uintptr_t)Address & E2END];
+		}
+
+		static inline void eeprom_write_byte(uint8_t* const Address, const uint8_t Value)
+		{
+			HostAVR_EEPROM[(uintptr_t)Address & E2END] = Value;
+		}
+
+		static inline void eeprom_update_byte(uint8_t* const Address, const uint8_t Value)
+		{
+			HostAVR_EEPROM[(uintptr_t)Address & E2END] = Value;
+		}
+#endif
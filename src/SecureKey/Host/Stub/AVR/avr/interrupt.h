@@ -0,0 +1,15 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc interrupt header. Interrupt handlers become plain functions, which the simulated
+ *  host calls for the events it raises; nothing runs concurrently, so the global interrupt flag is not modelled.
+ */
+
+#ifndef _HOST_AVR_INTERRUPT_H_
+#define _HOST_AVR_INTERRUPT_H_
+
+	/* Macros: */
+		#define ISR(Vector, ...)       void Vector(void); void Vector(void)
+		#define ISR_NAKED
+		#define sei()
+		#define cli()
+#endif
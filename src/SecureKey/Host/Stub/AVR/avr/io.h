@@ -0,0 +1,50 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc I/O header, declaring the registers of the ATmega32U2 used by the firmware as
+ *  plain variables, defined in HostAVR.c. Writes to them have no effect beyond the value held, and the simulated host
+ *  drives the HWB input through \c PIND.
+ */
+
+#ifndef _HOST_AVR_IO_H_
+#define _HOST_AVR_IO_H_
+
+	/* Includes: */
+		#include <stdint.h>
+
+	/* Macros: */
+		/** Last byte address of the FLASH memory of the ATmega32U2. */
+		#define FLASHEND          0x7FFF
+
+		/** Last byte address of the EEPROM of the ATmega32U2. */
+		#define E2END             0x3FF
+
+		/** Size in bytes of a page of the FLASH memory of the ATmega32U2. */
+		#define SPM_PAGESIZE      128
+
+		/** Size in bytes of a page of the EEPROM of the ATmega32U2. */
+		#define E2PAGESIZE        4
+
+		#define WDRF              3
+		#define ISC70             6
+		#define ISC71             7
+		#define INT7              7
+		#define INTF7             7
+		#define CS00              0
+		#define CS01              1
+		#define CS02              2
+		#define CS10              0
+		#define CS11              1
+		#define CS12              2
+		#define WGM01             1
+		#define OCIE0A            1
+		#define OCF0A             1
+		#define TOV1              0
+
+	/* External Variables: */
+		extern volatile uint8_t  PORTD, DDRD, PIND;
+		extern volatile uint8_t  MCUSR, SREG, SPL, SPH;
+		extern volatile uint8_t  EICRB, EIMSK, EIFR;
+		extern volatile uint8_t  TCCR0A, TCCR0B, OCR0A, TIMSK0;
+		extern volatile uint8_t  TCCR1A, TCCR1B, TIFR1, TIMSK1;
+		extern volatile uint16_t TCNT1;
+#endif
@@ -0,0 +1,51 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc program space header. FLASH and RAM share one address space on the host, so data
+ *  placed in FLASH is read in place. Addresses within the FLASH of the AVR itself, such as the bootloader table at its
+ *  top, are never valid host pointers and read as erased FLASH.
+ */
+
+#ifndef _HOST_AVR_PGMSPACE_H_
+#define _HOST_AVR_PGMSPACE_H_
+
+	/* Includes: */
+		#include <stdint.h>
+		#include <stdio.h>
+		#include <string.h>
+
+		#include <avr/io.h>
+
+	/* Macros: */
+		#define PROGMEM
+		#define PSTR(s)                (s)
+
+		#define pgm_read_byte(Address) HostAVR_ReadFlashByte((const void*)(Address))
+		#define pgm_read_word(Address) HostAVR_ReadFlashWord((const void*)(Address))
+		#define pgm_read_ptr(Address)  (*(void* const*)(Address))
+
+		#define strlen_P               strlen
+		#define strcmp_P               strcmp
+		#define strncmp_P              strncmp
+		#define strcpy_P               strcpy
+		#define memcpy_P               memcpy
+		#define memcmp_P               memcmp
+
+	/* Type Defines: */
+		typedef const char* PGM_P;
+
+	/* Inline Functions: */
+		/** Reads a byte from FLASH memory, as erased FLASH for an address within the FLASH of the AVR. */
+		static inline uint8_t HostAVR_ReadFlashByte(const void* const Address)
+		{
+			return (((uintptr_t)Address <= FLASHEND) ? 0xFF : *(const uint8_t*)Address);
+		}
+
+		/** Reads a little endian word from FLASH memory, as erased FLASH for an address within the FLASH of the AVR. */
+		static inline uint16_t HostAVR_ReadFlashWord(const void* const Address)
+		{
+			return (HostAVR_ReadFlashByte(Address) | ((uint16_t)HostAVR_ReadFlashByte((const uint8_t*)Address + 1) << 8));
+		}
+
+	/* Function Prototypes: */
+		int snprintf_P(char* const Buffer, const size_t Size, const char* const Format, ...);
+#endif
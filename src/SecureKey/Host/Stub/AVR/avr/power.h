@@ -0,0 +1,12 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc power management header.
+ */
+
+#ifndef _HOST_AVR_POWER_H_
+#define _HOST_AVR_POWER_H_
+
+	/* Macros: */
+		#define clock_div_1            0
+		#define clock_prescale_set(Division)
+#endif
@@ -0,0 +1,11 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc watchdog header.
+ */
+
+#ifndef _HOST_AVR_WDT_H_
+#define _HOST_AVR_WDT_H_
+
+	/* Macros: */
+		#define wdt_disable()
+#endif
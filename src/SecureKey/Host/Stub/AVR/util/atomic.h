@@ -0,0 +1,14 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc atomic block header. The simulated host raises interrupts between passes of the
+ *  main loop only, so an atomic block is an ordinary block.
+ */
+
+#ifndef _HOST_UTIL_ATOMIC_H_
+#define _HOST_UTIL_ATOMIC_H_
+
+	/* Macros: */
+		#define ATOMIC_RESTORESTATE    0
+		#define ATOMIC_FORCEON         1
+		#define ATOMIC_BLOCK(Type)     for (uint8_t HostAtomic_Once = 1; HostAtomic_Once; HostAtomic_Once = 0)
+#endif
@@ -0,0 +1,30 @@
+/** \file
+ *
+ *  Host stand-in for the avr-libc CRC header, with the C equivalents given in its documentation.
+ */
+
+#ifndef _HOST_UTIL_CRC16_H_
+#define _HOST_UTIL_CRC16_H_
+
+	/* Includes: */
+		#include <stdint.h>
+
+	/* Inline Functions: */
+		static inline uint16_t _crc_ccitt_update(uint16_t CRC, uint8_t Data)
+		{
+			Data ^= (uint8_t)CRC;
+			Data ^= (uint8_t)(Data << 4);
+
+			return ((((uint16_t)Data << 8) | (CRC >> 8)) ^ (uint8_t)(Data >> 4) ^ ((uint16_t)Data << 3));
+		}
+
+		static inline uint8_t _crc8_ccitt_update(uint8_t CRC, const uint8_t Data)
+		{
+			CRC ^= Data;
+
+			for (uint8_t Bit = 0; Bit < 8; Bit++)
+			  CRC = ((CRC & 0x80) ? (uint8_t)((CRC << 1) ^ 0x07) : (uint8_t)(CRC << 1));
+
+			return CRC;
+		}
+#endif
@@ -0,0 +1,8 @@
+/** \file
+ *
+ *  Host stand-in for the LUFA board button driver header; HWB is read through HWif.c.
+ */
+
+#ifndef _HOST_LUFA_BUTTONS_H_
+#define _HOST_LUFA_BUTTONS_H_
+#endif
@@ -0,0 +1,15 @@
+/** \file
+ *
+ *  Host stand-in for the LUFA board LED driver header, giving the LED masks only; the LEDs of the board are driven
+ *  through HWif.c.
+ */
+
+#ifndef _HOST_LUFA_LEDS_H_
+#define _HOST_LUFA_LEDS_H_
+
+	/* Macros: */
+		#define LEDS_LED1              (1 << 0)
+		#define LEDS_LED2              (1 << 1)
+		#define LEDS_LED3              (1 << 2)
+		#define LEDS_LED4              (1 << 3)
+#endif
@@ -0,0 +1,82 @@
+/** \file
+ *
+ *  Host stand-in for the LUFA ring buffer header, with the same buffer layout and behaviour. As in LUFA, the buffer
+ *  does not check for overflow or underflow; callers check the count first.
+ */
+
+#ifndef _HOST_LUFA_RINGBUFFER_H_
+#define _HOST_LUFA_RINGBUFFER_H_
+
+	/* Includes: */
+		#include <stdbool.h>
+		#include <stdint.h>
+
+	/* Type Defines: */
+		typedef struct
+		{
+			uint8_t* In;    /**< Current storage location in the circular buffer */
+			uint8_t* Out;   /**< Current retrieval location in the circular buffer */
+			uint8_t* Start; /**< Pointer to the start of the buffer's underlying storage array */
+			uint8_t* End;   /**< Pointer to the end of the buffer's underlying storage array */
+			uint16_t Size;  /**< Size of the buffer's underlying storage array */
+			uint16_t Count; /**< Number of bytes currently stored in the buffer */
+		} RingBuffer_t;
+
+	/* Inline Functions: */
+		static inline void RingBuffer_InitBuffer(RingBuffer_t* Buffer, uint8_t* const DataPtr, const uint16_t Size)
+		{
+			Buffer->In    = DataPtr;
+			Buffer->Out   = DataPtr;
+			Buffer->Start = &DataPtr[0];
+			Buffer->End   = &DataPtr[Size];
+			Buffer->Size  = Size;
+			Buffer->Count = 0;
+		}
+
+		static inline uint16_t RingBuffer_GetCount(RingBuffer_t* const Buffer)
+		{
+			return Buffer->Count;
+		}
+
+		static inline uint16_t RingBuffer_GetFreeCount(RingBuffer_t* const Buffer)
+		{
+			return (Buffer->Size - Buffer->Count);
+		}
+
+		static inline bool RingBuffer_IsEmpty(RingBuffer_t* const Buffer)
+		{
+			return (Buffer->Count == 0);
+		}
+
+		static inline bool RingBuffer_IsFull(RingBuffer_t* const Buffer)
+		{
+			return (Buffer->Count == Buffer->Size);
+		}
+
+		static inline void RingBuffer_Insert(RingBuffer_t* Buffer, const uint8_t Data)
+		{
+			*Buffer->In = Data;
+
+			if (++Buffer->In == Buffer->End)
+			  Buffer->In = Buffer->Start;
+
+			Buffer->Count++;
+		}
+
+		static inline uint8_t RingBuffer_Remove(RingBuffer_t* Buffer)
+		{
+			uint8_t Data = *Buffer->Out;
+
+			if (++Buffer->Out == Buffer->End)
+			  Buffer->Out = Buffer->Start;
+
+			Buffer->Count--;
+
+			return Data;
+		}
+
+		static inline uint8_t RingBuffer_Peek(RingBuffer_t* const Buffer)
+		{
+			return *Buffer->Out;
+		}
+#endif
@@ -0,0 +1,540 @@
+/** \file
+ *
+ *  Host stand-in for the LUFA USB header, covering the parts of the device mode core, the endpoint API and the HID and
+ *  CDC device class drivers used by the firmware. Descriptors and class driver state keep the layout of LUFA, so the
+ *  firmware builds against them unchanged; the functions are implemented in HostUSB.c by a simulated USB host.
+ *
+ *  The endpoint API covers all that the HID and CDC device class drivers of LUFA use, so that those drivers can be
+ *  built over it in place of the stand-ins of HostUSB.c, with \c HOST_USB_LUFA_CLASS_DRIVERS defined. Their sources
+ *  include the LUFA headers by relative paths, so HostLUFA.c includes this header ahead of them, and it defines the
+ *  include guards of the LUFA headers it stands in for to keep those out.
+ */
+
+#ifndef _HOST_LUFA_USB_H_
+#define _HOST_LUFA_USB_H_
+
+	/* Include guards of the LUFA headers covered here */
+		#define __USB_H__
+		#define __USBMODE_H__
+		#define _HID_CLASS_DEVICE_H_
+		#define _HID_CLASS_COMMON_H_
+		#define _CDC_CLASS_DEVICE_H_
+		#define _CDC_CLASS_COMMON_H_
+
+	/* Includes: */
+		#include <stdbool.h>
+		#include <stddef.h>
+		#include <stdint.h>
+		#include <stdio.h>
+		#include <string.h>
+
+		#include <avr/pgmspace.h>
+
+		#if defined(USE_LUFA_CONFIG_HEADER)
+			#include "LUFAConfig.h"
+		#endif
+
+	/* Macros: */
+		/** Architecture of the build, the 8-bit AVR which the stubbed registers belong to. */
+		#define ARCH_AVR8                           0
+		#define ARCH                                ARCH_AVR8
+
+		/** Series of the simulated AVR, the ATmega32U2. */
+		#define USB_SERIES_2_AVR
+
+		/** Mode of the USB controller, as LUFA works it out for the ATmega32U2. */
+		#define USB_CAN_BE_DEVICE
+
+		#define ATTR_WARN_UNUSED_RESULT
+		#define ATTR_NON_NULL_PTR_ARG(...)
+		#define ATTR_CONST                          __attribute__ ((const))
+		#define ATTR_WEAK                           __attribute__ ((weak))
+		#define ATTR_PACKED                         __attribute__ ((packed))
+		#define ATTR_ALIAS(Function)                __attribute__ ((alias(#Function)))
+		#define GlobalInterruptEnable()
+		#define GlobalInterruptDisable()
+
+		#define MIN(x, y)                           (((x) < (y)) ? (x) : (y))
+		#define MAX(x, y)                           (((x) > (y)) ? (x) : (y))
+
+		#define CPU_TO_LE16(x)                      (x)
+		#define LE16_TO_CPU(x)                      (x)
+
+		#define REQDIR_HOSTTODEVICE                 (0 << 7)
+		#define REQDIR_DEVICETOHOST                 (1 << 7)
+		#define REQTYPE_STANDARD                    (0 << 5)
+		#define REQTYPE_CLASS                       (1 << 5)
+		#define REQTYPE_VENDOR                      (2 << 5)
+		#define REQREC_DEVICE                       (0 << 0)
+		#define REQREC_INTERFACE                    (1 << 0)
+		#define REQREC_ENDPOINT                     (2 << 0)
+		#define REQREC_OTHER                        (3 << 0)
+
+		#define ENDPOINT_CONTROLEP                  0
+
+		#define ENDPOINT_DIR_MASK                   0x80
+		#define ENDPOINT_DIR_IN                     0x80
+		#define ENDPOINT_DIR_OUT                    0x00
+		#define ENDPOINT_EPNUM_MASK                 0x0F
+		#define ENDPOINT_TOTAL_ENDPOINTS            5
+
+		#define FIXED_CONTROL_ENDPOINT_SIZE         8
+		#define FIXED_NUM_CONFIGURATIONS            1
+
+		#define NO_DESCRIPTOR                       0
+		#define LANGUAGE_ID_ENG                     0x0409
+		#define VERSION_BCD(Major, Minor, Revision) (((Major & 0xFF) << 8) | ((Minor & 0x0F) << 4) | (Revision & 0x0F))
+		#define USB_CONFIG_POWER_MA(mA)             ((mA) >> 1)
+		#define USB_CONFIG_ATTR_RESERVED            0x80
+		#define USB_CONFIG_ATTR_SELFPOWERED         0x40
+
+		#define USB_STRING_DESCRIPTOR(String)       { .Header = {.Size = sizeof(USB_Descriptor_Header_t) + \
+		                                                                 (sizeof(String) / sizeof(wchar_t) - 1) * 2, \
+		                                                         .Type = DTYPE_String}, \
+		                                              .UnicodeString = String }
+		#define USB_STRING_DESCRIPTOR_ARRAY(...)    { .Header = {.Size = sizeof(USB_Descriptor_Header_t) + \
+		                                                                 sizeof((uint16_t[]){__VA_ARGS__}), \
+		                                                         .Type = DTYPE_String}, \
+		                                              .UnicodeString = {__VA_ARGS__} }
+
+		#define EP_TYPE_CONTROL                     0x00
+		#define EP_TYPE_ISOCHRONOUS                 0x01
+		#define EP_TYPE_BULK                        0x02
+		#define EP_TYPE_INTERRUPT                   0x03
+		#define ENDPOINT_ATTR_NO_SYNC               (0 << 2)
+		#define ENDPOINT_USAGE_DATA                 (0 << 4)
+
+		#define DTYPE_Device                        0x01
+		#define DTYPE_Configuration                 0x02
+		#define DTYPE_String                        0x03
+		#define DTYPE_Interface                     0x04
+		#define DTYPE_Endpoint                      0x05
+		#define DTYPE_CSInterface                   0x24
+		#define HID_DTYPE_HID                       0x21
+		#define HID_DTYPE_Report                    0x22
+
+		#define USB_CSCP_NoDeviceClass              0x00
+		#define USB_CSCP_NoDeviceSubclass           0x00
+		#define USB_CSCP_NoDeviceProtocol           0x00
+		#define HID_CSCP_HIDClass                   0x03
+		#define HID_CSCP_BootSubclass               0x01
+		#define HID_CSCP_KeyboardBootProtocol       0x01
+		#define CDC_CSCP_CDCClass                   0x02
+		#define CDC_CSCP_ACMSubclass                0x02
+		#define CDC_CSCP_ATCommandProtocol          0x01
+		#define CDC_CSCP_CDCDataClass               0x0A
+		#define CDC_CSCP_NoDataSubclass             0x00
+		#define CDC_CSCP_NoDataProtocol             0x00
+		#define CDC_DSUBTYPE_CSInterface_Header     0x00
+		#define CDC_DSUBTYPE_CSInterface_ACM        0x02
+		#define CDC_DSUBTYPE_CSInterface_Union      0x06
+		#define CDC_CONTROL_LINE_OUT_DTR            (1 << 0)
+		#define CDC_CONTROL_LINE_OUT_RTS            (1 << 1)
+
+		#define CDC_REQ_SendEncapsulatedCommand     0x00
+		#define CDC_REQ_GetEncapsulatedResponse     0x01
+		#define CDC_REQ_SetLineEncoding             0x20
+		#define CDC_REQ_GetLineEncoding             0x21
+		#define CDC_REQ_SetControlLineState         0x22
+		#define CDC_REQ_SendBreak                   0x23
+		#define CDC_NOTIF_SerialState               0x20
+
+		#define HID_REQ_GetReport                   0x01
+		#define HID_REQ_GetIdle                     0x02
+		#define HID_REQ_GetProtocol                 0x03
+		#define HID_REQ_SetReport                   0x09
+		#define HID_REQ_SetIdle                     0x0A
+		#define HID_REQ_SetProtocol                 0x0B
+
+		#define HID_REPORT_ITEM_In                  0
+		#define HID_REPORT_ITEM_Out                 1
+		#define HID_REPORT_ITEM_Feature             2
+
+		/** Boot keyboard report descriptor. The simulated host never reads the report descriptor and decodes reports
+		 *  by the fixed boot layout, so only the opening items are given.
+		 */
+		#define HID_DESCRIPTOR_KEYBOARD(MaxKeys)    0x05, 0x01, 0x09, 0x06
+
+		#define HID_KEYBOARD_MODIFIER_LEFTCTRL      (1 << 0)
+		#define HID_KEYBOARD_MODIFIER_LEFTSHIFT     (1 << 1)
+		#define HID_KEYBOARD_MODIFIER_LEFTALT       (1 << 2)
+		#define HID_KEYBOARD_MODIFIER_LEFTGUI       (1 << 3)
+		#define HID_KEYBOARD_MODIFIER_RIGHTCTRL     (1 << 4)
+		#define HID_KEYBOARD_MODIFIER_RIGHTSHIFT    (1 << 5)
+		#define HID_KEYBOARD_MODIFIER_RIGHTALT      (1 << 6)
+		#define HID_KEYBOARD_MODIFIER_RIGHTGUI      (1 << 7)
+
+		#define HID_KEYBOARD_SC_A                   0x04
+		#define HID_KEYBOARD_SC_B                   0x05
+		#define HID_KEYBOARD_SC_C                   0x06
+		#define HID_KEYBOARD_SC_D                   0x07
+		#define HID_KEYBOARD_SC_E                   0x08
+		#define HID_KEYBOARD_SC_F                   0x09
+		#define HID_KEYBOARD_SC_G                   0x0A
+		#define HID_KEYBOARD_SC_H                   0x0B
+		#define HID_KEYBOARD_SC_I                   0x0C
+		#define HID_KEYBOARD_SC_J                   0x0D
+		#define HID_KEYBOARD_SC_K                   0x0E
+		#define HID_KEYBOARD_SC_L                   0x0F
+		#define HID_KEYBOARD_SC_M                   0x10
+		#define HID_KEYBOARD_SC_N                   0x11
+		#define HID_KEYBOARD_SC_O                   0x12
+		#define HID_KEYBOARD_SC_P                   0x13
+		#define HID_KEYBOARD_SC_Q                   0x14
+		#define HID_KEYBOARD_SC_R                   0x15
+		#define HID_KEYBOARD_SC_S                   0x16
+		#define HID_KEYBOARD_SC_T                   0x17
+		#define HID_KEYBOARD_SC_U                   0x18
+		#define HID_KEYBOARD_SC_V                   0x19
+		#define HID_KEYBOARD_SC_W                   0x1A
+		#define HID_KEYBOARD_SC_X                   0x1B
+		#define HID_KEYBOARD_SC_Y                   0x1C
+		#define HID_KEYBOARD_SC_Z                   0x1D
+		#define HID_KEYBOARD_SC_1_AND_EXCLAMATION   0x1E
+		#define HID_KEYBOARD_SC_2_AND_AT            0x1F
+		#define HID_KEYBOARD_SC_3_AND_HASHMARK      0x20
+		#define HID_KEYBOARD_SC_4_AND_DOLLAR        0x21
+		#define HID_KEYBOARD_SC_5_AND_PERCENTAGE    0x22
+		#define HID_KEYBOARD_SC_6_AND_CARET         0x23
+		#define HID_KEYBOARD_SC_7_AND_AMPERSAND     0x24
+		#define HID_KEYBOARD_SC_8_AND_ASTERISK      0x25
+		#define HID_KEYBOARD_SC_9_AND_OPENING_PARENTHESIS 0x26
+		#define HID_KEYBOARD_SC_0_AND_CLOSING_PARENTHESIS 0x27
+		#define HID_KEYBOARD_SC_ENTER               0x28
+		#define HID_KEYBOARD_SC_ESCAPE              0x29
+		#define HID_KEYBOARD_SC_BACKSPACE           0x2A
+		#define HID_KEYBOARD_SC_TAB                 0x2B
+		#define HID_KEYBOARD_SC_SPACE               0x2C
+		#define HID_KEYBOARD_SC_MINUS_AND_UNDERSCORE 0x2D
+		#define HID_KEYBOARD_SC_EQUAL_AND_PLUS      0x2E
+		#define HID_KEYBOARD_SC_OPENING_BRACKET_AND_OPENING_BRACE 0x2F
+		#define HID_KEYBOARD_SC_CLOSING_BRACKET_AND_CLOSING_BRACE 0x30
+		#define HID_KEYBOARD_SC_BACKSLASH_AND_PIPE  0x31
+		#define HID_KEYBOARD_SC_NON_US_HASHMARK_AND_TILDE 0x32
+		#define HID_KEYBOARD_SC_SEMICOLON_AND_COLON 0x33
+		#define HID_KEYBOARD_SC_APOSTROPHE_AND_QUOTE 0x34
+		#define HID_KEYBOARD_SC_GRAVE_ACCENT_AND_TILDE 0x35
+		#define HID_KEYBOARD_SC_COMMA_AND_LESS_THAN_SIGN 0x36
+		#define HID_KEYBOARD_SC_DOT_AND_GREATER_THAN_SIGN 0x37
+		#define HID_KEYBOARD_SC_SLASH_AND_QUESTION_MARK 0x38
+		#define HID_KEYBOARD_SC_CAPS_LOCK           0x39
+		#define HID_KEYBOARD_SC_NON_US_BACKSLASH_AND_PIPE 0x64
+
+	/* Enums: */
+		/** Enum for the results of the endpoint data stream functions, as in LUFA. */
+		enum Endpoint_Stream_RW_ErrorCodes_t
+		{
+			ENDPOINT_RWSTREAM_NoError            = 0,
+			ENDPOINT_RWSTREAM_EndpointStalled    = 1,
+			ENDPOINT_RWSTREAM_DeviceDisconnected = 2,
+			ENDPOINT_RWSTREAM_BusSuspended       = 3,
+			ENDPOINT_RWSTREAM_Timeout            = 4,
+			ENDPOINT_RWSTREAM_IncompleteTransfer = 5,
+		};
+
+		/** Enum for the results of the control endpoint stream functions, as in LUFA. */
+		enum Endpoint_ControlStream_RW_ErrorCodes_t
+		{
+			ENDPOINT_RWCSTREAM_NoError            = 0,
+			ENDPOINT_RWCSTREAM_HostAborted        = 1,
+			ENDPOINT_RWCSTREAM_DeviceDisconnected = 2,
+			ENDPOINT_RWCSTREAM_BusSuspended       = 3,
+		};
+
+		/** Enum for the results of \c Endpoint_WaitUntilReady(), as in LUFA. */
+		enum Endpoint_WaitUntilReady_ErrorCodes_t
+		{
+			ENDPOINT_READYWAIT_NoError            = 0,
+			ENDPOINT_READYWAIT_EndpointStalled    = 1,
+			ENDPOINT_READYWAIT_DeviceDisconnected = 2,
+			ENDPOINT_READYWAIT_BusSuspended       = 3,
+			ENDPOINT_READYWAIT_Timeout            = 4,
+		};
+
+		/** Enum for the states of the USB device, as in LUFA. */
+		enum USB_Device_States_t
+		{
+			DEVICE_STATE_Unattached = 0,
+			DEVICE_STATE_Powered    = 1,
+			DEVICE_STATE_Default    = 2,
+			DEVICE_STATE_Addressed  = 3,
+			DEVICE_STATE_Configured = 4,
+			DEVICE_STATE_Suspended  = 5,
+		};
+
+	/* Type Defines: */
+		typedef uint8_t USB_Descriptor_HIDReport_Datatype_t;
+
+		typedef struct
+		{
+			uint8_t  bmRequestType;
+			uint8_t  bRequest;
+			uint16_t wValue;
+			uint16_t wIndex;
+			uint16_t wLength;
+		} ATTR_PACKED USB_Request_Header_t;
+
+		typedef struct
+		{
+			uint32_t BaudRateBPS;
+			uint8_t  CharFormat;
+			uint8_t  ParityType;
+			uint8_t  DataBits;
+		} ATTR_PACKED CDC_LineEncoding_t;
+
+		typedef struct
+		{
+			uint8_t Size;
+			uint8_t Type;
+		} ATTR_PACKED USB_Descriptor_Header_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			uint16_t USBSpecification;
+			uint8_t  Class;
+			uint8_t  SubClass;
+			uint8_t  Protocol;
+			uint8_t  Endpoint0Size;
+			uint16_t VendorID;
+			uint16_t ProductID;
+			uint16_t ReleaseNumber;
+			uint8_t  ManufacturerStrIndex;
+			uint8_t  ProductStrIndex;
+			uint8_t  SerialNumStrIndex;
+			uint8_t  NumberOfConfigurations;
+		} ATTR_PACKED USB_Descriptor_Device_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			uint16_t TotalConfigurationSize;
+			uint8_t  TotalInterfaces;
+			uint8_t  ConfigurationNumber;
+			uint8_t  ConfigurationStrIndex;
+			uint8_t  ConfigAttributes;
+			uint8_t  MaxPowerConsumption;
+		} ATTR_PACKED USB_Descriptor_Configuration_Header_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			uint8_t InterfaceNumber;
+			uint8_t AlternateSetting;
+			uint8_t TotalEndpoints;
+			uint8_t Class;
+			uint8_t SubClass;
+			uint8_t Protocol;
+			uint8_t InterfaceStrIndex;
+		} ATTR_PACKED USB_Descriptor_Interface_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			uint8_t  EndpointAddress;
+			uint8_t  Attributes;
+			uint16_t EndpointSize;
+			uint8_t  PollingIntervalMS;
+		} ATTR_PACKED USB_Descriptor_Endpoint_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			wchar_t UnicodeString[];
+		} ATTR_PACKED USB_Descriptor_String_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			uint16_t HIDSpec;
+			uint8_t  CountryCode;
+			uint8_t  TotalReportDescriptors;
+			uint8_t  HIDReportType;
+			uint16_t HIDReportLength;
+		} ATTR_PACKED USB_HID_Descriptor_HID_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			uint8_t  Subtype;
+			uint16_t CDCSpecification;
+		} ATTR_PACKED USB_CDC_Descriptor_FunctionalHeader_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			uint8_t Subtype;
+			uint8_t Capabilities;
+		} ATTR_PACKED USB_CDC_Descriptor_FunctionalACM_t;
+
+		typedef struct
+		{
+			USB_Descriptor_Header_t Header;
+			uint8_t Subtype;
+			uint8_t MasterInterfaceNumber;
+			uint8_t SlaveInterfaceNumber;
+		} ATTR_PACKED USB_CDC_Descriptor_FunctionalUnion_t;
+
+		typedef struct
+		{
+			uint8_t  Address;
+			uint16_t Size;
+			uint8_t  Type;
+			uint8_t  Banks;
+		} USB_Endpoint_Table_t;
+
+		typedef struct
+		{
+			uint8_t Modifier;
+			uint8_t Reserved;
+			uint8_t KeyCode[6];
+		} USB_KeyboardReport_Data_t;
+
+		typedef struct
+		{
+			struct
+			{
+				uint8_t              InterfaceNumber;
+				USB_Endpoint_Table_t ReportINEndpoint;
+				void*                PrevReportINBuffer;
+				uint8_t              PrevReportINBufferSize;
+			} Config;
+
+			struct
+			{
+				bool     UsingReportProtocol;
+				uint16_t PrevFrameNum;
+				uint16_t IdleCount;
+				uint16_t IdleMSRemaining;
+			} State;
+		} USB_ClassInfo_HID_Device_t;
+
+		typedef struct
+		{
+			struct
+			{
+				uint8_t              ControlInterfaceNumber;
+				USB_Endpoint_Table_t DataINEndpoint;
+				USB_Endpoint_Table_t DataOUTEndpoint;
+				USB_Endpoint_Table_t NotificationEndpoint;
+			} Config;
+
+			struct
+			{
+				struct
+				{
+					uint16_t HostToDevice;
+					uint16_t DeviceToHost;
+				} ControlLineStates;
+
+				CDC_LineEncoding_t LineEncoding;
+			} State;
+		} USB_ClassInfo_CDC_Device_t;
+
+	/* External Variables: */
+		extern volatile uint8_t USB_DeviceState;
+		extern USB_Request_Header_t USB_ControlRequest;
+
+	/* Inline Functions: */
+		static inline void HID_Device_MillisecondElapsed(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
+		{
+			if (HIDInterfaceInfo->State.IdleMSRemaining)
+			  HIDInterfaceInfo->State.IdleMSRemaining--;
+		}
+
+	/* Function Prototypes: */
+		void     USB_Init(void);
+		void     USB_USBTask(void);
+		void     USB_Device_EnableSOFEvents(void);
+		uint16_t USB_Device_GetFrameNumber(void);
+
+		bool     Endpoint_ConfigureEndpointTable(const USB_Endpoint_Table_t* const Table, const uint8_t Entries);
+		void     Endpoint_SelectEndpoint(const uint8_t Address);
+		bool     Endpoint_IsReadWriteAllowed(void);
+		bool     Endpoint_IsINReady(void);
+		bool     Endpoint_IsOUTReceived(void);
+		bool     Endpoint_IsSETUPReceived(void);
+		uint16_t Endpoint_BytesInEndpoint(void);
+		uint8_t  Endpoint_Read_8(void);
+		uint32_t Endpoint_Read_32_LE(void);
+		void     Endpoint_Write_8(const uint8_t Data);
+		void     Endpoint_Write_16_LE(const uint16_t Data);
+		void     Endpoint_Write_32_LE(const uint32_t Data);
+		void     Endpoint_ClearIN(void);
+		void     Endpoint_ClearOUT(void);
+		void     Endpoint_ClearSETUP(void);
+		void     Endpoint_ClearStatusStage(void);
+		uint8_t  Endpoint_WaitUntilReady(void);
+		uint8_t  Endpoint_Write_Stream_LE(const void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed);
+		uint8_t  Endpoint_Write_PStream_LE(const void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed);
+		uint8_t  Endpoint_Read_Stream_LE(void* const Buffer, uint16_t Length, uint16_t* const BytesProcessed);
+		uint8_t  Endpoint_Write_Control_Stream_LE(const void* const Buffer, uint16_t Length);
+		uint8_t  Endpoint_Read_Control_Stream_LE(void* const Buffer, uint16_t Length);
+
+		bool     HID_Device_ConfigureEndpoints(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo);
+		void     HID_Device_ProcessControlRequest(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo);
+		void     HID_Device_USBTask(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo);
+
+		bool     CDC_Device_ConfigureEndpoints(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		void     CDC_Device_ProcessControlRequest(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		void     CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		uint8_t  CDC_Device_SendData(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, const void* const Buffer,
+		                             const uint16_t Length);
+		uint8_t  CDC_Device_SendString(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, const char* const String);
+		uint8_t  CDC_Device_SendByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, const uint8_t Data);
+		uint16_t CDC_Device_BytesReceived(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		int16_t  CDC_Device_ReceiveByte(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		uint8_t  CDC_Device_Flush(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		void     CDC_Device_SendControlLineStateChange(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+
+		#if defined(FDEV_SETUP_STREAM)
+		void     CDC_Device_CreateStream(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, FILE* const Stream);
+		void     CDC_Device_CreateBlockingStream(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, FILE* const Stream);
+		#endif
+
+		/* Events and callbacks implemented by the firmware */
+		void     EVENT_USB_Device_Connect(void);
+		void     EVENT_USB_Device_Disconnect(void);
+		void     EVENT_USB_Device_ConfigurationChanged(void);
+		void     EVENT_USB_Device_ControlRequest(void);
+		uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
+		                                    const uint16_t wIndex,
+		                                    const void** const DescriptorAddress);
+		void     EVENT_USB_Device_StartOfFrame(void);
+
+		bool     CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo,
+		                                             uint8_t* const ReportID,
+		                                             const uint8_t ReportType,
+		                                             void* ReportData,
+		                                             uint16_t* const ReportSize);
+		void     CALLBACK_HID_Device_ProcessHIDReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo,
+		                                              const uint8_t ReportID,
+		                                              const uint8_t ReportType,
+		                                              const void* ReportData,
+		                                              const uint16_t ReportSize);
+		void     EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		void     EVENT_CDC_Device_ControLineStateChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+		void     EVENT_CDC_Device_BreakSent(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, const uint8_t Duration);
+
+	/* Private Interface - For use in library only: */
+	#if !defined(__DOXYGEN__)
+		/* Function Prototypes: */
+			#if defined(__INCLUDE_FROM_CDC_DEVICE_C)
+				/* Defaults of the CDC class driver events, which LUFA declares in its class header */
+				void CDC_Device_Event_Stub(void);
+
+				void EVENT_CDC_Device_LineEncodingChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+				     ATTR_WEAK ATTR_ALIAS(CDC_Device_Event_Stub);
+				void EVENT_CDC_Device_ControLineStateChanged(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+				     ATTR_WEAK ATTR_ALIAS(CDC_Device_Event_Stub);
+				void EVENT_CDC_Device_BreakSent(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo, const uint8_t Duration)
+				     ATTR_WEAK ATTR_ALIAS(CDC_Device_Event_Stub);
+
+				#if defined(FDEV_SETUP_STREAM)
+				static int CDC_Device_putchar(char c, FILE* Stream);
+				static int CDC_Device_getchar(FILE* Stream);
+				static int CDC_Device_getchar_Blocking(FILE* Stream);
+				#endif
+			#endif
+	#endif
+#endif
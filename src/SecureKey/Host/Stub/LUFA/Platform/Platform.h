@@ -0,0 +1,8 @@
+/** \file
+ *
+ *  Host stand-in for the LUFA platform header, which has nothing to set up on the host.
+ */
+
+#ifndef _HOST_LUFA_PLATFORM_H_
+#define _HOST_LUFA_PLATFORM_H_
+#endif
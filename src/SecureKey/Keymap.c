@@ -0,0 +1,99 @@
+/** \file
+ *
+ *  Translation of ASCII characters into the keys which type them on the keyboard layout of the host, for text sent
+ *  by the host. The tables of every layout are generated into KeymapTables.h by Tools/keymap-gen.py ("make
+ *  keymaps") and held in FLASH memory; each character indexes the table of the selected layout, so a translation
+ *  is a single \c pgm_read_word() whatever the character and the layout.
+ */
+
+#include "Keymap.h"
+#include "KeymapTables.h"
+
+/** Names of the keyboard layouts, as given to \ref Keymap_FindLayout(). */
+static const char Keymap_LayoutNames[KEYMAP_LAYOUT_COUNT][KEYMAP_NAME_MAX + 1] PROGMEM =
+	{
+		[KEYMAP_LAYOUT_US] = "us",
+		[KEYMAP_LAYOUT_UK] = "uk",
+		[KEYMAP_LAYOUT_DE] = "de",
+		[KEYMAP_LAYOUT_FR] = "fr",
+	};
+
+/** Table of the selected layout, within \c KeymapTables. */
+static const key_t* Keymap_Table = KeymapTables[KEYMAP_LAYOUT_US];
+
+/** Selects the keyboard layout text is translated for.
+ *
+ *  \param[in] Layout  Layout to select, a value from \ref KeymapLayouts_t
+ */
+void Keymap_SetLayout(const uint8_t Layout)
+{
+	if (Layout < KEYMAP_LAYOUT_COUNT)
+	  Keymap_Table = KeymapTables[Layout];
+}
+
+/** Gives the selected keyboard layout.
+ *
+ *  \return The selected layout, a value from \ref KeymapLayouts_t
+ */
+uint8_t Keymap_GetLayout(void)
+{
+	return ((Keymap_Table - KeymapTables[0]) / KEYMAP_CHARACTERS);
+}
+
+/** Looks up a keyboard layout by its name.
+ *
+ *  \param[in]  Name    Name of the layout, such as \c "de"
+ *  \param[out] Layout  Location where the layout is stored, a value from \ref KeymapLayouts_t
+ *
+ *  \return Boolean \c true if the layout was found, \c false otherwise
+ */
+bool Keymap_FindLayout(const char* const Name, uint8_t* const Layout)
+{
+	for (uint8_t Index = 0; Index < KEYMAP_LAYOUT_COUNT; Index++)
+	{
+		if (strcmp_P(Name, Keymap_LayoutNames[Index]) == 0)
+		{
+			*Layout = Index;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/** Gives the name of a keyboard layout.
+ *
+ *  \param[in] Layout  Layout to name, a value from \ref KeymapLayouts_t
+ *
+ *  \return Name of the layout, in FLASH memory
+ */
+const char* Keymap_GetLayoutName(const uint8_t Layout)
+{
+	return Keymap_LayoutNames[Layout];
+}
+
+/** Translates an ASCII character into the key which types it on the selected layout. A character on a dead key takes
+ *  two keystrokes, the key given followed by Space.
+ *
+ *  \param[in]  Character  Character to translate
+ *  \param[out] Key        Location where the key and its modifier are stored
+ *
+ *  \return Number of keystrokes typing the character: zero for characters the layout cannot type, one, or two for
+ *          a dead key
+ */
+uint8_t Keymap_Translate(const uint8_t Character, key_t* const Key)
+{
+	if (Character >= KEYMAP_CHARACTERS)
+	  return 0;
+
+	*Key = Secret_ReadKey_P(Keymap_Table, Character);
+
+	if (!(Key->key))
+	  return 0;
+
+	if (!(Key->key & KEYMAP_DEAD_KEY))
+	  return 1;
+
+	Key->key &= ~KEYMAP_DEAD_KEY;
+	return 2;
+}
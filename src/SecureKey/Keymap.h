@@ -0,0 +1,49 @@
+/** \file
+ *
+ *  Header file for Keymap.c.
+ */
+
+#ifndef _KEYMAP_H_
+#define _KEYMAP_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include "SecretStream.h"
+
+	/* Macros: */
+		/** Number of characters covered by a keymap, the 7-bit ASCII set. */
+		#define KEYMAP_CHARACTERS          128
+
+		/** Bit of the scancode of a keymap entry marking a dead key, which types its character only when followed by
+		 *  Space. Scancodes of the keys which type ASCII are all below 0x80.
+		 */
+		#define KEYMAP_DEAD_KEY            0x80
+
+		/** Scancode of Space, typed after a dead key so that it types its own character. */
+		#define KEYMAP_DEAD_KEY_SPACE      0x2C
+
+		/** Longest name of a keyboard layout, as given to \ref Keymap_FindLayout(). */
+		#define KEYMAP_NAME_MAX            2
+
+	/* Enums: */
+		/** Enum for the keyboard layouts of the keymap tables, in the order of Tools/keymap-gen.py. */
+		enum KeymapLayouts_t
+		{
+			KEYMAP_LAYOUT_US,    /**< United States */
+			KEYMAP_LAYOUT_UK,    /**< United Kingdom */
+			KEYMAP_LAYOUT_DE,    /**< German QWERTZ */
+			KEYMAP_LAYOUT_FR,    /**< French AZERTY */
+			KEYMAP_LAYOUT_COUNT, /**< Number of layouts */
+		};
+
+	/* Function Prototypes: */
+		void    Keymap_SetLayout(const uint8_t Layout);
+		uint8_t Keymap_GetLayout(void);
+		bool    Keymap_FindLayout(const char* const Name, uint8_t* const Layout);
+		const char* Keymap_GetLayoutName(const uint8_t Layout);
+		uint8_t Keymap_Translate(const uint8_t Character, key_t* const Key);
+#endif
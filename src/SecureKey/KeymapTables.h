@@ -0,0 +1,422 @@
+/** \file
+ *
+ *  Keyboard layout tables, generated by Tools/keymap-gen.py; do not edit.
+ */
+
+#ifndef _KEYMAP_TABLES_H_
+#define _KEYMAP_TABLES_H_
+
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+#include "Keymap.h"
+
+static const key_t KeymapTables[KEYMAP_LAYOUT_COUNT][KEYMAP_CHARACTERS] PROGMEM =
+{
+  {  /* us, 99 characters */
+    ['\b'  ] = { .key = 0x2A, .mod = 0x00 },
+    ['\t'  ] = { .key = 0x2B, .mod = 0x00 },
+    ['\n'  ] = { .key = 0x28, .mod = 0x00 },
+    [0x1B  ] = { .key = 0x29, .mod = 0x00 },
+    [' '   ] = { .key = 0x2C, .mod = 0x00 },
+    ['!'   ] = { .key = 0x1E, .mod = 0x02 },
+    ['"'   ] = { .key = 0x34, .mod = 0x02 },
+    ['#'   ] = { .key = 0x20, .mod = 0x02 },
+    ['$'   ] = { .key = 0x21, .mod = 0x02 },
+    ['%'   ] = { .key = 0x22, .mod = 0x02 },
+    ['&'   ] = { .key = 0x24, .mod = 0x02 },
+    ['\''  ] = { .key = 0x34, .mod = 0x00 },
+    ['('   ] = { .key = 0x26, .mod = 0x02 },
+    [')'   ] = { .key = 0x27, .mod = 0x02 },
+    ['*'   ] = { .key = 0x25, .mod = 0x02 },
+    ['+'   ] = { .key = 0x2E, .mod = 0x02 },
+    [','   ] = { .key = 0x36, .mod = 0x00 },
+    ['-'   ] = { .key = 0x2D, .mod = 0x00 },
+    ['.'   ] = { .key = 0x37, .mod = 0x00 },
+    ['/'   ] = { .key = 0x38, .mod = 0x00 },
+    ['0'   ] = { .key = 0x27, .mod = 0x00 },
+    ['1'   ] = { .key = 0x1E, .mod = 0x00 },
+    ['2'   ] = { .key = 0x1F, .mod = 0x00 },
+    ['3'   ] = { .key = 0x20, .mod = 0x00 },
+    ['4'   ] = { .key = 0x21, .mod = 0x00 },
+    ['5'   ] = { .key = 0x22, .mod = 0x00 },
+    ['6'   ] = { .key = 0x23, .mod = 0x00 },
+    ['7'   ] = { .key = 0x24, .mod = 0x00 },
+    ['8'   ] = { .key = 0x25, .mod = 0x00 },
+    ['9'   ] = { .key = 0x26, .mod = 0x00 },
+    [':'   ] = { .key = 0x33, .mod = 0x02 },
+    [';'   ] = { .key = 0x33, .mod = 0x00 },
+    ['<'   ] = { .key = 0x36, .mod = 0x02 },
+    ['='   ] = { .key = 0x2E, .mod = 0x00 },
+    ['>'   ] = { .key = 0x37, .mod = 0x02 },
+    ['?'   ] = { .key = 0x38, .mod = 0x02 },
+    ['@'   ] = { .key = 0x1F, .mod = 0x02 },
+    ['A'   ] = { .key = 0x04, .mod = 0x02 },
+    ['B'   ] = { .key = 0x05, .mod = 0x02 },
+    ['C'   ] = { .key = 0x06, .mod = 0x02 },
+    ['D'   ] = { .key = 0x07, .mod = 0x02 },
+    ['E'   ] = { .key = 0x08, .mod = 0x02 },
+    ['F'   ] = { .key = 0x09, .mod = 0x02 },
+    ['G'   ] = { .key = 0x0A, .mod = 0x02 },
+    ['H'   ] = { .key = 0x0B, .mod = 0x02 },
+    ['I'   ] = { .key = 0x0C, .mod = 0x02 },
+    ['J'   ] = { .key = 0x0D, .mod = 0x02 },
+    ['K'   ] = { .key = 0x0E, .mod = 0x02 },
+    ['L'   ] = { .key = 0x0F, .mod = 0x02 },
+    ['M'   ] = { .key = 0x10, .mod = 0x02 },
+    ['N'   ] = { .key = 0x11, .mod = 0x02 },
+    ['O'   ] = { .key = 0x12, .mod = 0x02 },
+    ['P'   ] = { .key = 0x13, .mod = 0x02 },
+    ['Q'   ] = { .key = 0x14, .mod = 0x02 },
+    ['R'   ] = { .key = 0x15, .mod = 0x02 },
+    ['S'   ] = { .key = 0x16, .mod = 0x02 },
+    ['T'   ] = { .key = 0x17, .mod = 0x02 },
+    ['U'   ] = { .key = 0x18, .mod = 0x02 },
+    ['V'   ] = { .key = 0x19, .mod = 0x02 },
+    ['W'   ] = { .key = 0x1A, .mod = 0x02 },
+    ['X'   ] = { .key = 0x1B, .mod = 0x02 },
+    ['Y'   ] = { .key = 0x1C, .mod = 0x02 },
+    ['Z'   ] = { .key = 0x1D, .mod = 0x02 },
+    ['['   ] = { .key = 0x2F, .mod = 0x00 },
+    ['\\'  ] = { .key = 0x31, .mod = 0x00 },
+    [']'   ] = { .key = 0x30, .mod = 0x00 },
+    ['^'   ] = { .key = 0x23, .mod = 0x02 },
+    ['_'   ] = { .key = 0x2D, .mod = 0x02 },
+    ['`'   ] = { .key = 0x35, .mod = 0x00 },
+    ['a'   ] = { .key = 0x04, .mod = 0x00 },
+    ['b'   ] = { .key = 0x05, .mod = 0x00 },
+    ['c'   ] = { .key = 0x06, .mod = 0x00 },
+    ['d'   ] = { .key = 0x07, .mod = 0x00 },
+    ['e'   ] = { .key = 0x08, .mod = 0x00 },
+    ['f'   ] = { .key = 0x09, .mod = 0x00 },
+    ['g'   ] = { .key = 0x0A, .mod = 0x00 },
+    ['h'   ] = { .key = 0x0B, .mod = 0x00 },
+    ['i'   ] = { .key = 0x0C, .mod = 0x00 },
+    ['j'   ] = { .key = 0x0D, .mod = 0x00 },
+    ['k'   ] = { .key = 0x0E, .mod = 0x00 },
+    ['l'   ] = { .key = 0x0F, .mod = 0x00 },
+    ['m'   ] = { .key = 0x10, .mod = 0x00 },
+    ['n'   ] = { .key = 0x11, .mod = 0x00 },
+    ['o'   ] = { .key = 0x12, .mod = 0x00 },
+    ['p'   ] = { .key = 0x13, .mod = 0x00 },
+    ['q'   ] = { .key = 0x14, .mod = 0x00 },
+    ['r'   ] = { .key = 0x15, .mod = 0x00 },
+    ['s'   ] = { .key = 0x16, .mod = 0x00 },
+    ['t'   ] = { .key = 0x17, .mod = 0x00 },
+    ['u'   ] = { .key = 0x18, .mod = 0x00 },
+    ['v'   ] = { .key = 0x19, .mod = 0x00 },
+    ['w'   ] = { .key = 0x1A, .mod = 0x00 },
+    ['x'   ] = { .key = 0x1B, .mod = 0x00 },
+    ['y'   ] = { .key = 0x1C, .mod = 0x00 },
+    ['z'   ] = { .key = 0x1D, .mod = 0x00 },
+    ['{'   ] = { .key = 0x2F, .mod = 0x02 },
+    ['|'   ] = { .key = 0x31, .mod = 0x02 },
+    ['}'   ] = { .key = 0x30, .mod = 0x02 },
+    ['~'   ] = { .key = 0x35, .mod = 0x02 },
+  },
+  {  /* uk, 99 characters */
+    ['\b'  ] = { .key = 0x2A, .mod = 0x00 },
+    ['\t'  ] = { .key = 0x2B, .mod = 0x00 },
+    ['\n'  ] = { .key = 0x28, .mod = 0x00 },
+    [0x1B  ] = { .key = 0x29, .mod = 0x00 },
+    [' '   ] = { .key = 0x2C, .mod = 0x00 },
+    ['!'   ] = { .key = 0x1E, .mod = 0x02 },
+    ['"'   ] = { .key = 0x1F, .mod = 0x02 },
+    ['#'   ] = { .key = 0x32, .mod = 0x00 },
+    ['$'   ] = { .key = 0x21, .mod = 0x02 },
+    ['%'   ] = { .key = 0x22, .mod = 0x02 },
+    ['&'   ] = { .key = 0x24, .mod = 0x02 },
+    ['\''  ] = { .key = 0x34, .mod = 0x00 },
+    ['('   ] = { .key = 0x26, .mod = 0x02 },
+    [')'   ] = { .key = 0x27, .mod = 0x02 },
+    ['*'   ] = { .key = 0x25, .mod = 0x02 },
+    ['+'   ] = { .key = 0x2E, .mod = 0x02 },
+    [','   ] = { .key = 0x36, .mod = 0x00 },
+    ['-'   ] = { .key = 0x2D, .mod = 0x00 },
+    ['.'   ] = { .key = 0x37, .mod = 0x00 },
+    ['/'   ] = { .key = 0x38, .mod = 0x00 },
+    ['0'   ] = { .key = 0x27, .mod = 0x00 },
+    ['1'   ] = { .key = 0x1E, .mod = 0x00 },
+    ['2'   ] = { .key = 0x1F, .mod = 0x00 },
+    ['3'   ] = { .key = 0x20, .mod = 0x00 },
+    ['4'   ] = { .key = 0x21, .mod = 0x00 },
+    ['5'   ] = { .key = 0x22, .mod = 0x00 },
+    ['6'   ] = { .key = 0x23, .mod = 0x00 },
+    ['7'   ] = { .key = 0x24, .mod = 0x00 },
+    ['8'   ] = { .key = 0x25, .mod = 0x00 },
+    ['9'   ] = { .key = 0x26, .mod = 0x00 },
+    [':'   ] = { .key = 0x33, .mod = 0x02 },
+    [';'   ] = { .key = 0x33, .mod = 0x00 },
+    ['<'   ] = { .key = 0x36, .mod = 0x02 },
+    ['='   ] = { .key = 0x2E, .mod = 0x00 },
+    ['>'   ] = { .key = 0x37, .mod = 0x02 },
+    ['?'   ] = { .key = 0x38, .mod = 0x02 },
+    ['@'   ] = { .key = 0x34, .mod = 0x02 },
+    ['A'   ] = { .key = 0x04, .mod = 0x02 },
+    ['B'   ] = { .key = 0x05, .mod = 0x02 },
+    ['C'   ] = { .key = 0x06, .mod = 0x02 },
+    ['D'   ] = { .key = 0x07, .mod = 0x02 },
+    ['E'   ] = { .key = 0x08, .mod = 0x02 },
+    ['F'   ] = { .key = 0x09, .mod = 0x02 },
+    ['G'   ] = { .key = 0x0A, .mod = 0x02 },
+    ['H'   ] = { .key = 0x0B, .mod = 0x02 },
+    ['I'   ] = { .key = 0x0C, .mod = 0x02 },
+    ['J'   ] = { .key = 0x0D, .mod = 0x02 },
+    ['K'   ] = { .key = 0x0E, .mod = 0x02 },
+    ['L'   ] = { .key = 0x0F, .mod = 0x02 },
+    ['M'   ] = { .key = 0x10, .mod = 0x02 },
+    ['N'   ] = { .key = 0x11, .mod = 0x02 },
+    ['O'   ] = { .key = 0x12, .mod = 0x02 },
+    ['P'   ] = { .key = 0x13, .mod = 0x02 },
+    ['Q'   ] = { .key = 0x14, .mod = 0x02 },
+    ['R'   ] = { .key = 0x15, .mod = 0x02 },
+    ['S'   ] = { .key = 0x16, .mod = 0x02 },
+    ['T'   ] = { .key = 0x17, .mod = 0x02 },
+    ['U'   ] = { .key = 0x18, .mod = 0x02 },
+    ['V'   ] = { .key = 0x19, .mod = 0x02 },
+    ['W'   ] = { .key = 0x1A, .mod = 0x02 },
+    ['X'   ] = { .key = 0x1B, .mod = 0x02 },
+    ['Y'   ] = { .key = 0x1C, .mod = 0x02 },
+    ['Z'   ] = { .key = 0x1D, .mod = 0x02 },
+    ['['   ] = { .key = 0x2F, .mod = 0x00 },
+    ['\\'  ] = { .key = 0x64, .mod = 0x00 },
+    [']'   ] = { .key = 0x30, .mod = 0x00 },
+    ['^'   ] = { .key = 0x23, .mod = 0x02 },
+    ['_'   ] = { .key = 0x2D, .mod = 0x02 },
+    ['`'   ] = { .key = 0x35, .mod = 0x00 },
+    ['a'   ] = { .key = 0x04, .mod = 0x00 },
+    ['b'   ] = { .key = 0x05, .mod = 0x00 },
+    ['c'   ] = { .key = 0x06, .mod = 0x00 },
+    ['d'   ] = { .key = 0x07, .mod = 0x00 },
+    ['e'   ] = { .key = 0x08, .mod = 0x00 },
+    ['f'   ] = { .key = 0x09, .mod = 0x00 },
+    ['g'   ] = { .key = 0x0A, .mod = 0x00 },
+    ['h'   ] = { .key = 0x0B, .mod = 0x00 },
+    ['i'   ] = { .key = 0x0C, .mod = 0x00 },
+    ['j'   ] = { .key = 0x0D, .mod = 0x00 },
+    ['k'   ] = { .key = 0x0E, .mod = 0x00 },
+    ['l'   ] = { .key = 0x0F, .mod = 0x00 },
+    ['m'   ] = { .key = 0x10, .mod = 0x00 },
+    ['n'   ] = { .key = 0x11, .mod = 0x00 },
+    ['o'   ] = { .key = 0x12, .mod = 0x00 },
+    ['p'   ] = { .key = 0x13, .mod = 0x00 },
+    ['q'   ] = { .key = 0x14, .mod = 0x00 },
+    ['r'   ] = { .key = 0x15, .mod = 0x00 },
+    ['s'   ] = { .key = 0x16, .mod = 0x00 },
+    ['t'   ] = { .key = 0x17, .mod = 0x00 },
+    ['u'   ] = { .key = 0x18, .mod = 0x00 },
+    ['v'   ] = { .key = 0x19, .mod = 0x00 },
+    ['w'   ] = { .key = 0x1A, .mod = 0x00 },
+    ['x'   ] = { .key = 0x1B, .mod = 0x00 },
+    ['y'   ] = { .key = 0x1C, .mod = 0x00 },
+    ['z'   ] = { .key = 0x1D, .mod = 0x00 },
+    ['{'   ] = { .key = 0x2F, .mod = 0x02 },
+    ['|'   ] = { .key = 0x64, .mod = 0x02 },
+    ['}'   ] = { .key = 0x30, .mod = 0x02 },
+    ['~'   ] = { .key = 0x32, .mod = 0x02 },
+  },
+  {  /* de, 99 characters */
+    ['\b'  ] = { .key = 0x2A, .mod = 0x00 },
+    ['\t'  ] = { .key = 0x2B, .mod = 0x00 },
+    ['\n'  ] = { .key = 0x28, .mod = 0x00 },
+    [0x1B  ] = { .key = 0x29, .mod = 0x00 },
+    [' '   ] = { .key = 0x2C, .mod = 0x00 },
+    ['!'   ] = { .key = 0x1E, .mod = 0x02 },
+    ['"'   ] = { .key = 0x1F, .mod = 0x02 },
+    ['#'   ] = { .key = 0x32, .mod = 0x00 },
+    ['$'   ] = { .key = 0x21, .mod = 0x02 },
+    ['%'   ] = { .key = 0x22, .mod = 0x02 },
+    ['&'   ] = { .key = 0x23, .mod = 0x02 },
+    ['\''  ] = { .key = 0x32, .mod = 0x02 },
+    ['('   ] = { .key = 0x25, .mod = 0x02 },
+    [')'   ] = { .key = 0x26, .mod = 0x02 },
+    ['*'   ] = { .key = 0x30, .mod = 0x02 },
+    ['+'   ] = { .key = 0x30, .mod = 0x00 },
+    [','   ] = { .key = 0x36, .mod = 0x00 },
+    ['-'   ] = { .key = 0x38, .mod = 0x00 },
+    ['.'   ] = { .key = 0x37, .mod = 0x00 },
+    ['/'   ] = { .key = 0x24, .mod = 0x02 },
+    ['0'   ] = { .key = 0x27, .mod = 0x00 },
+    ['1'   ] = { .key = 0x1E, .mod = 0x00 },
+    ['2'   ] = { .key = 0x1F, .mod = 0x00 },
+    ['3'   ] = { .key = 0x20, .mod = 0x00 },
+    ['4'   ] = { .key = 0x21, .mod = 0x00 },
+    ['5'   ] = { .key = 0x22, .mod = 0x00 },
+    ['6'   ] = { .key = 0x23, .mod = 0x00 },
+    ['7'   ] = { .key = 0x24, .mod = 0x00 },
+    ['8'   ] = { .key = 0x25, .mod = 0x00 },
+    ['9'   ] = { .key = 0x26, .mod = 0x00 },
+    [':'   ] = { .key = 0x37, .mod = 0x02 },
+    [';'   ] = { .key = 0x36, .mod = 0x02 },
+    ['<'   ] = { .key = 0x64, .mod = 0x00 },
+    ['='   ] = { .key = 0x27, .mod = 0x02 },
+    ['>'   ] = { .key = 0x64, .mod = 0x02 },
+    ['?'   ] = { .key = 0x2D, .mod = 0x02 },
+    ['@'   ] = { .key = 0x14, .mod = 0x40 },
+    ['A'   ] = { .key = 0x04, .mod = 0x02 },
+    ['B'   ] = { .key = 0x05, .mod = 0x02 },
+    ['C'   ] = { .key = 0x06, .mod = 0x02 },
+    ['D'   ] = { .key = 0x07, .mod = 0x02 },
+    ['E'   ] = { .key = 0x08, .mod = 0x02 },
+    ['F'   ] = { .key = 0x09, .mod = 0x02 },
+    ['G'   ] = { .key = 0x0A, .mod = 0x02 },
+    ['H'   ] = { .key = 0x0B, .mod = 0x02 },
+    ['I'   ] = { .key = 0x0C, .mod = 0x02 },
+    ['J'   ] = { .key = 0x0D, .mod = 0x02 },
+    ['K'   ] = { .key = 0x0E, .mod = 0x02 },
+    ['L'   ] = { .key = 0x0F, .mod = 0x02 },
+    ['M'   ] = { .key = 0x10, .mod = 0x02 },
+    ['N'   ] = { .key = 0x11, .mod = 0x02 },
+    ['O'   ] = { .key = 0x12, .mod = 0x02 },
+    ['P'   ] = { .key = 0x13, .mod = 0x02 },
+    ['Q'   ] = { .key = 0x14, .mod = 0x02 },
+    ['R'   ] = { .key = 0x15, .mod = 0x02 },
+    ['S'   ] = { .key = 0x16, .mod = 0x02 },
+    ['T'   ] = { .key = 0x17, .mod = 0x02 },
+    ['U'   ] = { .key = 0x18, .mod = 0x02 },
+    ['V'   ] = { .key = 0x19, .mod = 0x02 },
+    ['W'   ] = { .key = 0x1A, .mod = 0x02 },
+    ['X'   ] = { .key = 0x1B, .mod = 0x02 },
+    ['Y'   ] = { .key = 0x1D, .mod = 0x02 },
+    ['Z'   ] = { .key = 0x1C, .mod = 0x02 },
+    ['['   ] = { .key = 0x25, .mod = 0x40 },
+    ['\\'  ] = { .key = 0x2D, .mod = 0x40 },
+    [']'   ] = { .key = 0x26, .mod = 0x40 },
+    ['^'   ] = { .key = 0xB5, .mod = 0x00 },
+    ['_'   ] = { .key = 0x38, .mod = 0x02 },
+    ['`'   ] = { .key = 0xAE, .mod = 0x02 },
+    ['a'   ] = { .key = 0x04, .mod = 0x00 },
+    ['b'   ] = { .key = 0x05, .mod = 0x00 },
+    ['c'   ] = { .key = 0x06, .mod = 0x00 },
+    ['d'   ] = { .key = 0x07, .mod = 0x00 },
+    ['e'   ] = { .key = 0x08, .mod = 0x00 },
+    ['f'   ] = { .key = 0x09, .mod = 0x00 },
+    ['g'   ] = { .key = 0x0A, .mod = 0x00 },
+    ['h'   ] = { .key = 0x0B, .mod = 0x00 },
+    ['i'   ] = { .key = 0x0C, .mod = 0x00 },
+    ['j'   ] = { .key = 0x0D, .mod = 0x00 },
+    ['k'   ] = { .key = 0x0E, .mod = 0x00 },
+    ['l'   ] = { .key = 0x0F, .mod = 0x00 },
+    ['m'   ] = { .key = 0x10, .mod = 0x00 },
+    ['n'   ] = { .key = 0x11, .mod = 0x00 },
+    ['o'   ] = { .key = 0x12, .mod = 0x00 },
+    ['p'   ] = { .key = 0x13, .mod = 0x00 },
+    ['q'   ] = { .key = 0x14, .mod = 0x00 },
+    ['r'   ] = { .key = 0x15, .mod = 0x00 },
+    ['s'   ] = { .key = 0x16, .mod = 0x00 },
+    ['t'   ] = { .key = 0x17, .mod = 0x00 },
+    ['u'   ] = { .key = 0x18, .mod = 0x00 },
+    ['v'   ] = { .key = 0x19, .mod = 0x00 },
+    ['w'   ] = { .key = 0x1A, .mod = 0x00 },
+    ['x'   ] = { .key = 0x1B, .mod = 0x00 },
+    ['y'   ] = { .key = 0x1D, .mod = 0x00 },
+    ['z'   ] = { .key = 0x1C, .mod = 0x00 },
+    ['{'   ] = { .key = 0x24, .mod = 0x40 },
+    ['|'   ] = { .key = 0x64, .mod = 0x40 },
+    ['}'   ] = { .key = 0x27, .mod = 0x40 },
+    ['~'   ] = { .key = 0x30, .mod = 0x40 },
+  },
+  {  /* fr, 99 characters */
+    ['\b'  ] = { .key = 0x2A, .mod = 0x00 },
+    ['\t'  ] = { .key = 0x2B, .mod = 0x00 },
+    ['\n'  ] = { .key = 0x28, .mod = 0x00 },
+    [0x1B  ] = { .key = 0x29, .mod = 0x00 },
+    [' '   ] = { .key = 0x2C, .mod = 0x00 },
+    ['!'   ] = { .key = 0x38, .mod = 0x00 },
+    ['"'   ] = { .key = 0x20, .mod = 0x00 },
+    ['#'   ] = { .key = 0x20, .mod = 0x40 },
+    ['$'   ] = { .key = 0x30, .mod = 0x00 },
+    ['%'   ] = { .key = 0x34, .mod = 0x02 },
+    ['&'   ] = { .key = 0x1E, .mod = 0x00 },
+    ['\''  ] = { .key = 0x21, .mod = 0x00 },
+    ['('   ] = { .key = 0x22, .mod = 0x00 },
+    [')'   ] = { .key = 0x2D, .mod = 0x00 },
+    ['*'   ] = { .key = 0x32, .mod = 0x00 },
+    ['+'   ] = { .key = 0x2E, .mod = 0x02 },
+    [','   ] = { .key = 0x10, .mod = 0x00 },
+    ['-'   ] = { .key = 0x23, .mod = 0x00 },
+    ['.'   ] = { .key = 0x36, .mod = 0x02 },
+    ['/'   ] = { .key = 0x37, .mod = 0x02 },
+    ['0'   ] = { .key = 0x27, .mod = 0x02 },
+    ['1'   ] = { .key = 0x1E, .mod = 0x02 },
+    ['2'   ] = { .key = 0x1F, .mod = 0x02 },
+    ['3'   ] = { .key = 0x20, .mod = 0x02 },
+    ['4'   ] = { .key = 0x21, .mod = 0x02 },
+    ['5'   ] = { .key = 0x22, .mod = 0x02 },
+    ['6'   ] = { .key = 0x23, .mod = 0x02 },
+    ['7'   ] = { .key = 0x24, .mod = 0x02 },
+    ['8'   ] = { .key = 0x25, .mod = 0x02 },
+    ['9'   ] = { .key = 0x26, .mod = 0x02 },
+    [':'   ] = { .key = 0x37, .mod = 0x00 },
+    [';'   ] = { .key = 0x36, .mod = 0x00 },
+    ['<'   ] = { .key = 0x64, .mod = 0x00 },
+    ['='   ] = { .key = 0x2E, .mod = 0x00 },
+    ['>'   ] = { .key = 0x64, .mod = 0x02 },
+    ['?'   ] = { .key = 0x10, .mod = 0x02 },
+    ['@'   ] = { .key = 0x27, .mod = 0x40 },
+    ['A'   ] = { .key = 0x14, .mod = 0x02 },
+    ['B'   ] = { .key = 0x05, .mod = 0x02 },
+    ['C'   ] = { .key = 0x06, .mod = 0x02 },
+    ['D'   ] = { .key = 0x07, .mod = 0x02 },
+    ['E'   ] = { .key = 0x08, .mod = 0x02 },
+    ['F'   ] = { .key = 0x09, .mod = 0x02 },
+    ['G'   ] = { .key = 0x0A, .mod = 0x02 },
+    ['H'   ] = { .key = 0x0B, .mod = 0x02 },
+    ['I'   ] = { .key = 0x0C, .mod = 0x02 },
+    ['J'   ] = { .key = 0x0D, .mod = 0x02 },
+    ['K'   ] = { .key = 0x0E, .mod = 0x02 },
+    ['L'   ] = { .key = 0x0F, .mod = 0x02 },
+    ['M'   ] = { .key = 0x33, .mod = 0x02 },
+    ['N'   ] = { .key = 0x11, .mod = 0x02 },
+    ['O'   ] = { .key = 0x12, .mod = 0x02 },
+    ['P'   ] = { .key = 0x13, .mod = 0x02 },
+    ['Q'   ] = { .key = 0x04, .mod = 0x02 },
+    ['R'   ] = { .key = 0x15, .mod = 0x02 },
+    ['S'   ] = { .key = 0x16, .mod = 0x02 },
+    ['T'   ] = { .key = 0x17, .mod = 0x02 },
+    ['U'   ] = { .key = 0x18, .mod = 0x02 },
+    ['V'   ] = { .key = 0x19, .mod = 0x02 },
+    ['W'   ] = { .key = 0x1D, .mod = 0x02 },
+    ['X'   ] = { .key = 0x1B, .mod = 0x02 },
+    ['Y'   ] = { .key = 0x1C, .mod = 0x02 },
+    ['Z'   ] = { .key = 0x1A, .mod = 0x02 },
+    ['['   ] = { .key = 0x22, .mod = 0x40 },
+    ['\\'  ] = { .key = 0x25, .mod = 0x40 },
+    [']'   ] = { .key = 0x2D, .mod = 0x40 },
+    ['^'   ] = { .key = 0x26, .mod = 0x40 },
+    ['_'   ] = { .key = 0x25, .mod = 0x00 },
+    ['`'   ] = { .key = 0xA4, .mod = 0x40 },
+    ['a'   ] = { .key = 0x14, .mod = 0x00 },
+    ['b'   ] = { .key = 0x05, .mod = 0x00 },
+    ['c'   ] = { .key = 0x06, .mod = 0x00 },
+    ['d'   ] = { .key = 0x07, .mod = 0x00 },
+    ['e'   ] = { .key = 0x08, .mod = 0x00 },
+    ['f'   ] = { .key = 0x09, .mod = 0x00 },
+    ['g'   ] = { .key = 0x0A, .mod = 0x00 },
+    ['h'   ] = { .key = 0x0B, .mod = 0x00 },
+    ['i'   ] = { .key = 0x0C, .mod = 0x00 },
+    ['j'   ] = { .key = 0x0D, .mod = 0x00 },
+    ['k'   ] = { .key = 0x0E, .mod = 0x00 },
+    ['l'   ] = { .key = 0x0F, .mod = 0x00 },
+    ['m'   ] = { .key = 0x33, .mod = 0x00 },
+    ['n'   ] = { .key = 0x11, .mod = 0x00 },
+    ['o'   ] = { .key = 0x12, .mod = 0x00 },
+    ['p'   ] = { .key = 0x13, .mod = 0x00 },
+    ['q'   ] = { .key = 0x04, .mod = 0x00 },
+    ['r'   ] = { .key = 0x15, .mod = 0x00 },
+    ['s'   ] = { .key = 0x16, .mod = 0x00 },
+    ['t'   ] = { .key = 0x17, .mod = 0x00 },
+    ['u'   ] = { .key = 0x18, .mod = 0x00 },
+    ['v'   ] = { .key = 0x19, .mod = 0x00 },
+    ['w'   ] = { .key = 0x1D, .mod = 0x00 },
+    ['x'   ] = { .key = 0x1B, .mod = 0x00 },
+    ['y'   ] = { .key = 0x1C, .mod = 0x00 },
+    ['z'   ] = { .key = 0x1A, .mod = 0x00 },
+    ['{'   ] = { .key = 0x21, .mod = 0x40 },
+    ['|'   ] = { .key = 0x23, .mod = 0x40 },
+    ['}'   ] = { .key = 0x2E, .mod = 0x40 },
+    ['~'   ] = { .key = 0x9F, .mod = 0x40 },
+  },
+};
+
+#endif
@@ -0,0 +1,131 @@
+/** \file
+ *
+ *  Streaming decompressor for the compressed secret library. The compressed format is a sequence of tokens:
+ *  \c 0LLLLLLL is followed by L + 1 literal bytes, \c 10LLLLLL D copies L + 3 bytes from D bytes back in the
+ *  output, and \c 11LLLLLL OO OO copies L + 3 bytes from the preset dictionary at offset OOOO. Each output byte
+ *  costs a read of the compressed data or the dictionary and a window write, so decompression keeps far ahead of
+ *  the keyboard reports.
+ *
+ *  The compressed bytes are read from a \ref ByteSource_t given on every read, so that the decompressor only holds
+ *  its own state, and only streams over compressed data need one.
+ *
+ *  Matches are checked as they are decoded: a window match may only reach back over bytes already output, and a
+ *  dictionary match must lie within the dictionary. Anything else can only come from a corrupt image, and ends the
+ *  stream as truncated data does.
+ */
+
+#include "LZStream.h"
+
+/** Decodes the next token of a compressed stream.
+ *
+ *  \param[in,out] Stream  Stream to decode from
+ *  \param[in,out] Input   Source of the compressed data
+ *
+ *  \return Boolean \c true if a token was decoded, \c false at the end of the data or if the data is truncated or
+ *          invalid
+ */
+static bool LZStream_NextToken(LZStream_t* const Stream, ByteSource_t* const Input)
+{
+	uint8_t Token;
+
+	if (!(ByteSource_ReadByte(Input, &Token)))
+	  return false;
+
+	if (!(Token & LZSTREAM_TOKEN_MATCH))
+	{
+		Stream->Mode      = LZSTREAM_MODE_Literal;
+		Stream->Remaining = (Token + 1);
+
+		if (ByteSource_GetRemaining(Input) < Stream->Remaining)
+		  return false;
+	}
+	else if (!(Token & LZSTREAM_TOKEN_DICTIONARY))
+	{
+		uint8_t Distance;
+
+		if (!(ByteSource_ReadByte(Input, &Distance)) || !(Distance) || (Distance > Stream->WindowFill))
+		  return false;
+
+		Stream->Mode      = LZSTREAM_MODE_Window;
+		Stream->Remaining = ((Token & 0x3F) + LZSTREAM_MIN_MATCH);
+		Stream->Match     = (uint8_t)(Stream->WindowPosition - Distance);
+	}
+	else
+	{
+		uint8_t OffsetLow, OffsetHigh;
+
+		if (!(ByteSource_ReadByte(Input, &OffsetLow)) || !(ByteSource_ReadByte(Input, &OffsetHigh)))
+		  return false;
+
+		Stream->Mode      = LZSTREAM_MODE_Dictionary;
+		Stream->Remaining = ((Token & 0x3F) + LZSTREAM_MIN_MATCH);
+		Stream->Match     = (OffsetLow | ((uint16_t)OffsetHigh << 8));
+
+		if ((Stream->Match > Stream->DictionaryLength) ||
+		    (Stream->Remaining > (Stream->DictionaryLength - Stream->Match)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Resets a decompressor for the start of a new stream of compressed data.
+ *
+ *  \param[out] Stream            Stream to open
+ *  \param[in]  Dictionary        Preset dictionary the data was compressed against, in FLASH memory
+ *  \param[in]  DictionaryLength  Length of the dictionary in bytes, zero if there is none
+ */
+void LZStream_Open(LZStream_t* const Stream, const uint8_t* const Dictionary, const uint16_t DictionaryLength)
+{
+	Stream->Dictionary       = Dictionary;
+	Stream->DictionaryLength = DictionaryLength;
+	Stream->Remaining        = 0;
+	Stream->Mode             = LZSTREAM_MODE_Literal;
+	Stream->WindowPosition   = 0;
+	Stream->WindowFill       = 0;
+}
+
+/** Reads the next byte of output from a stream.
+ *
+ *  \param[in,out] Stream  Stream to read from
+ *  \param[in,out] Input   Source of the compressed data, the same for every read since the stream was opened
+ *  \param[out]    Byte    Location where the byte is stored
+ *
+ *  \return Boolean \c true if a byte was read, \c false at the end of the stream
+ */
+bool LZStream_ReadByte(LZStream_t* const Stream, ByteSource_t* const Input, uint8_t* const Byte)
+{
+	uint8_t Output;
+
+	if (!(Stream->Remaining) && !(LZStream_NextToken(Stream, Input)))
+	{
+		/* Stay at the end, also after a truncated token */
+		ByteSource_Close(Input);
+		Stream->Remaining = 0;
+		return false;
+	}
+
+	switch (Stream->Mode)
+	{
+		case LZSTREAM_MODE_Literal:
+			ByteSource_ReadByte(Input, &Output);
+			break;
+		case LZSTREAM_MODE_Window:
+			Output = Stream->Window[Stream->Match++ & (LZSTREAM_WINDOW_SIZE - 1)];
+			break;
+		default:
+			Output = pgm_read_byte(&Stream->Dictionary[Stream->Match++]);
+			break;
+	}
+
+	Stream->Window[Stream->WindowPosition++ & (LZSTREAM_WINDOW_SIZE - 1)] = Output;
+	Stream->Remaining--;
+
+	if (Stream->WindowFill < LZSTREAM_WINDOW_SIZE)
+	  Stream->WindowFill++;
+
+	*Byte = Output;
+	return true;
+}
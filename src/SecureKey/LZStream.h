@@ -0,0 +1,62 @@
+/** \file
+ *
+ *  Header file for LZStream.c.
+ */
+
+#ifndef _LZSTREAM_H_
+#define _LZSTREAM_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+		#include <stddef.h>
+
+		#include "ByteSource.h"
+
+	/* Macros: */
+		/** Size of the window of recent output which window matches copy from; must be a power of two. */
+		#define LZSTREAM_WINDOW_SIZE       32
+
+		/** Shortest match of the compressed format; the length bits of a match token count from here. */
+		#define LZSTREAM_MIN_MATCH         3
+
+		/** Token bit marking a match; tokens without it start a run of 1 to 128 literal bytes. */
+		#define LZSTREAM_TOKEN_MATCH       0x80
+
+		/** Match token bit selecting a copy from the preset dictionary, at a two byte little endian offset, rather
+		 *  than from the window, at a one byte distance of 1 to \ref LZSTREAM_WINDOW_SIZE back.
+		 */
+		#define LZSTREAM_TOKEN_DICTIONARY  0x40
+
+	/* Enums: */
+		/** Enum for the source of the bytes of the current token of a stream. */
+		enum LZStreamModes_t
+		{
+			LZSTREAM_MODE_Literal,    /**< Literal bytes of the compressed data */
+			LZSTREAM_MODE_Window,     /**< Copy from the window of recent output */
+			LZSTREAM_MODE_Dictionary, /**< Copy from the preset dictionary */
+		};
+
+	/* Type Defines: */
+		/** Type define for a streaming decompressor, decoding the compressed bytes read from a \ref ByteSource_t.
+		 *  Output is produced a byte at a time, keeping only the last \ref LZSTREAM_WINDOW_SIZE bytes in RAM; longer
+		 *  range repeats are taken from a preset dictionary which is shared by every stream of a library and read
+		 *  straight from FLASH memory.
+		 */
+		typedef struct
+		{
+			const uint8_t* Dictionary;                    /**< Preset dictionary, in FLASH memory */
+			uint16_t       DictionaryLength;              /**< Length of \c Dictionary in bytes */
+			uint16_t       Match;                         /**< Read index of the current match */
+			uint8_t        Remaining;                     /**< Bytes left in the current token */
+			uint8_t        Mode;                          /**< Source of the current token, a \ref LZStreamModes_t value */
+			uint8_t        WindowPosition;                /**< Write index of the window */
+			uint8_t        WindowFill;                    /**< Bytes output so far, up to the window size */
+			uint8_t        Window[LZSTREAM_WINDOW_SIZE];  /**< Most recent output bytes */
+		} LZStream_t;
+
+	/* Function Prototypes: */
+		void LZStream_Open(LZStream_t* const Stream, const uint8_t* const Dictionary, const uint16_t DictionaryLength);
+		bool LZStream_ReadByte(LZStream_t* const Stream, ByteSource_t* const Input, uint8_t* const Byte);
+#endif
@@ -0,0 +1,102 @@
+/** \file
+ *
+ *  Paste pipe, typing text sent by the host over the virtual serial port. Characters are translated into keys as
+ *  they arrive and queued in the packed key encoding, which the keyboard report callback reads back through a
+ *  \ref SecretStream_t like any stored secret, so pasted text is typed at the full rate of the report encoder.
+ *
+ *  Nothing is taken from the host while the queue is full, which leaves the received bytes in the CDC ring buffer,
+ *  and then in the CDC endpoint, so that the host is held off by NAKs for as long as typing lags behind.
+ */
+
+#include "Paste.h"
+
+/** Queues a key in the packed key encoding, as a single byte where it has no modifier other than Left Shift.
+ *
+ *  \param[in,out] Queue  Ring buffer with room for the packed key
+ *  \param[in]     Key    Key to queue
+ */
+static void Paste_QueueKey(RingBuffer_t* const Queue, const key_t Key)
+{
+	bool Fits = !(Key.key & SECRET_PACKED_SHIFT);
+
+	if (Fits && (Key.mod == HID_KEYBOARD_MODIFIER_NONE))
+	{
+		RingBuffer_Insert(Queue, SECRET_PACKED_KEY(Key.key));
+	}
+	else if (Fits && (Key.mod == SECRET_PACKED_SHIFT_MODIFIER))
+	{
+		RingBuffer_Insert(Queue, SECRET_PACKED_SHIFTED(Key.key));
+	}
+	else
+	{
+		RingBuffer_Insert(Queue, SECRET_PACKED_ESCAPE);
+		RingBuffer_Insert(Queue, Key.mod);
+		RingBuffer_Insert(Queue, Key.key);
+	}
+}
+
+/** Starts a paste, opening a stream over the queue of packed keys for the typing path.
+ *
+ *  \param[out] Paste   Paste to start
+ *  \param[in]  Buffer  Buffer for the queue of packed keys
+ *  \param[in]  Size    Size of \c Buffer in bytes, at least \ref PASTE_MAX_PACKED_SIZE
+ *  \param[out] Stream  Stream to type the pasted keys from
+ */
+void Paste_Begin(Paste_t* const Paste, uint8_t* const Buffer, const uint8_t Size, SecretStream_t* const Stream)
+{
+	RingBuffer_InitBuffer(&Paste->Queue, Buffer, Size);
+	Paste->Open = true;
+
+	SecretStream_OpenQueue(Stream, &Paste->Queue);
+}
+
+/** Translates the text received from the host into queued keys, for as long as there is room in the queue for the
+ *  longest packed character. Characters with no key on the selected layout are dropped, characters on a dead key are
+ *  followed by Space, and \ref PASTE_END_CHARACTER ends the paste.
+ *
+ *  \param[in,out] Paste  Paste to run
+ *  \param[in,out] Input  Ring buffer of characters from the host
+ */
+void Paste_Task(Paste_t* const Paste, RingBuffer_t* const Input)
+{
+	while (Paste->Open && !(RingBuffer_IsEmpty(Input)) &&
+	       (RingBuffer_GetFreeCount(&Paste->Queue) >= PASTE_MAX_PACKED_SIZE))
+	{
+		uint8_t Character = RingBuffer_Remove(Input);
+		key_t   Key;
+
+		if (Character == PASTE_END_CHARACTER)
+		{
+			Paste->Open = false;
+			continue;
+		}
+
+		uint8_t Keystrokes = Keymap_Translate(Character, &Key);
+
+		if (Keystrokes)
+		  Paste_QueueKey(&Paste->Queue, Key);
+
+		if (Keystrokes > 1)
+		  RingBuffer_Insert(&Paste->Queue, SECRET_PACKED_KEY(KEYMAP_DEAD_KEY_SPACE));
+	}
+}
+
+/** Ends a paste, leaving the keys already queued to be typed out.
+ *
+ *  \param[in,out] Paste  Paste to end
+ */
+void Paste_End(Paste_t* const Paste)
+{
+	Paste->Open = false;
+}
+
+/** Checks whether a paste is still taking text from the host.
+ *
+ *  \param[in] Paste  Paste to check
+ *
+ *  \return Boolean \c true from \ref Paste_Begin() until the host ends the paste
+ */
+bool Paste_IsOpen(const Paste_t* const Paste)
+{
+	return Paste->Open;
+}
@@ -0,0 +1,43 @@
+/** \file
+ *
+ *  Header file for Paste.c.
+ */
+
+#ifndef _PASTE_H_
+#define _PASTE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <stdbool.h>
+
+		#include <LUFA/Drivers/Misc/RingBuffer.h>
+
+		#include "Keymap.h"
+		#include "SecretStream.h"
+
+	/* Macros: */
+		/** Character from the host which ends a paste, Ctrl-D (end of transmission). */
+		#define PASTE_END_CHARACTER        0x04
+
+		/** Largest number of bytes a single character takes in the packed key encoding, that of an escaped dead key
+		 *  followed by Space.
+		 */
+		#define PASTE_MAX_PACKED_SIZE      4
+
+	/* Type Defines: */
+		/** Type define for the state of a paste, which turns text from the host into packed keys for the typing path.
+		 *  The keys are queued in a buffer given by the caller and typed from there through a \ref SecretStream_t, so
+		 *  text is taken from the host only as fast as the keyboard reports type it out.
+		 */
+		typedef struct
+		{
+			RingBuffer_t Queue; /**< Packed keys waiting to be typed */
+			bool         Open;  /**< Flag set until the host has ended the paste */
+		} Paste_t;
+
+	/* Function Prototypes: */
+		void Paste_Begin(Paste_t* const Paste, uint8_t* const Buffer, const uint8_t Size, SecretStream_t* const Stream);
+		void Paste_Task(Paste_t* const Paste, RingBuffer_t* const Input);
+		void Paste_End(Paste_t* const Paste);
+		bool Paste_IsOpen(const Paste_t* const Paste);
+#endif
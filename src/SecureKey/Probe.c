@@ -0,0 +1,95 @@
+/** \file
+ *
+ *  Cycle probes of the USB paths, in a \c CYCLE_PROBES build only. Each probe point keeps the shortest, longest and
+ *  mean cycle count of the code between its \ref PROBE_BEGIN() and \ref PROBE_END(), timed by the free running
+ *  Timer 1 of the scheduler task accounting, in a fixed table of a few bytes per point. In other builds the probe
+ *  macros are empty and nothing here is built.
+ */
+
+#include "Probe.h"
+
+#if defined(CYCLE_PROBES)
+
+/** Names of the probe points, as listed by the \c stats command. */
+static const char ProbeNames[PROBE_COUNT][PROBE_NAME_MAX + 1] PROGMEM =
+	{
+		[PROBE_USBTask] = "usb",
+		[PROBE_HIDTask] = "hid",
+		[PROBE_CDCTask] = "cdc",
+		[PROBE_SOF]     = "sof",
+		[PROBE_Report]  = "rep",
+	};
+
+/** Cycle counts of each probe point. The Start of Frame point is written in interrupt context, and with the control
+ *  endpoint serviced from the USB interrupt the report point can be too, from the callback building a report for a
+ *  \c GET_REPORT request, while the main loop builds another. An entry may therefore have more than one writer, so
+ *  every update, read and clear of an entry is done with interrupts held off.
+ */
+static ProbeStats_t Probe_Stats[PROBE_COUNT] =
+	{
+		[0 ... (PROBE_COUNT - 1)] = {.MinCycles = 0xFFFF},
+	};
+
+/** Adds a run of a probe point to its cycle counts.
+ *
+ *  \param[in] Point   Probe point, a value from \ref ProbePoints_t
+ *  \param[in] Cycles  Cycles the run took
+ */
+void Probe_Record(const uint8_t Point, const uint16_t Cycles)
+{
+	ProbeStats_t* Stats = &Probe_Stats[Point];
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (Stats->Runs == 0xFFFF)
+		{
+			Stats->Runs        >>= 1;
+			Stats->TotalCycles >>= 1;
+		}
+
+		Stats->Runs++;
+		Stats->TotalCycles += Cycles;
+
+		if (Cycles < Stats->MinCycles)
+		  Stats->MinCycles = Cycles;
+
+		if (Cycles > Stats->MaxCycles)
+		  Stats->MaxCycles = Cycles;
+	}
+}
+
+/** Takes a consistent copy of the cycle counts of a probe point.
+ *
+ *  \param[in]  Point  Probe point, a value from \ref ProbePoints_t
+ *  \param[out] Stats  Copy of the cycle counts of the point
+ */
+void Probe_GetStats(const uint8_t Point, ProbeStats_t* const Stats)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		*Stats = Probe_Stats[Point];
+	}
+}
+
+/** Retrieves the name of a probe point.
+ *
+ *  \param[in] Point  Probe point, a value from \ref ProbePoints_t
+ *
+ *  \return Name of the point, in FLASH memory
+ */
+const char* Probe_GetName(const uint8_t Point)
+{
+	return ProbeNames[Point];
+}
+
+/** Clears the cycle counts of every probe point. */
+void Probe_ClearStats(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (uint8_t Point = 0; Point < PROBE_COUNT; Point++)
+		  Probe_Stats[Point] = (ProbeStats_t){.MinCycles = 0xFFFF};
+	}
+}
+
+#endif
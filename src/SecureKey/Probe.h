@@ -0,0 +1,65 @@
+/** \file
+ *
+ *  Header file for Probe.c.
+ */
+
+#ifndef _PROBE_H_
+#define _PROBE_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <util/atomic.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include "Scheduler.h"
+
+	/* Macros: */
+		#if defined(CYCLE_PROBES) || defined(__DOXYGEN__)
+			/** Starts timing a probe point at the top of the code it measures, a value from \ref ProbePoints_t. */
+			#define PROBE_BEGIN(Point)     const uint16_t Point##_Start = Scheduler_Cycles()
+
+			/** Records the cycles since the matching \ref PROBE_BEGIN() against the probe point. */
+			#define PROBE_END(Point)       Probe_Record((Point), (uint16_t)(Scheduler_Cycles() - Point##_Start))
+		#else
+			#define PROBE_BEGIN(Point)
+			#define PROBE_END(Point)
+		#endif
+
+		/** Length of the longest probe point name, without the terminator. */
+		#define PROBE_NAME_MAX             3
+
+	/* Enums: */
+		/** Enum for the probe points of a \c CYCLE_PROBES build. */
+		enum ProbePoints_t
+		{
+			PROBE_USBTask,  /**< \c USB_USBTask(), the USB management of LUFA */
+			PROBE_HIDTask,  /**< \c HID_Device_USBTask(), the report callback included */
+			PROBE_CDCTask,  /**< \c CDC_Device_USBTask() */
+			PROBE_SOF,      /**< The Start of Frame event, in interrupt context */
+			PROBE_Report,   /**< The report creation callback of the HID class driver */
+			PROBE_COUNT,    /**< Number of probe points */
+		};
+
+	/* Type Defines: */
+		/** Type define for the cycle counts of a probe point. Cycles are taken from Timer 1 as for the scheduler task
+		 *  accounting, so include any interrupt taken meanwhile and wrap at 65536 (4 ms at 16 MHz). Once \c Runs
+		 *  would overflow, it and \c TotalCycles are both halved, so that the mean follows the recent runs.
+		 */
+		typedef struct
+		{
+			uint32_t TotalCycles; /**< Cycles spent at the probe point over \c Runs runs */
+			uint16_t Runs;        /**< Number of runs counted in \c TotalCycles */
+			uint16_t MinCycles;   /**< Shortest single run, in cycles */
+			uint16_t MaxCycles;   /**< Longest single run, in cycles */
+		} ProbeStats_t;
+
+	/* Function Prototypes: */
+		#if defined(CYCLE_PROBES) || defined(__DOXYGEN__)
+			void Probe_Record(const uint8_t Point, const uint16_t Cycles);
+			void Probe_GetStats(const uint8_t Point, ProbeStats_t* const Stats);
+			const char* Probe_GetName(const uint8_t Point);
+			void Probe_ClearStats(void);
+		#endif
+#endif
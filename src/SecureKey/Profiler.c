@@ -0,0 +1,210 @@
+/** \file
+ *
+ *  Sampling profiler of the program counter, in a \c PC_PROFILER build only. The Timer 0 compare interrupt reads the
+ *  address it interrupted off the stack and counts it in a histogram of FLASH address ranges, which the \c prof
+ *  command dumps and Tools/prof-symbols.py resolves to the symbols of the firmware ELF. The bins cover the whole FLASH
+ *  memory at first, and can be narrowed onto a range of interest for a finer second pass.
+ *
+ *  Sampling stops once a bin fills up, so that the proportions of the histogram hold. The USB interrupt is not
+ *  nested into, so its time shows up as samples on the instructions it returns to.
+ */
+
+#include "Profiler.h"
+
+#if defined(PC_PROFILER)
+
+#if (FLASHEND > 0xFFFF)
+	#error The profiler only handles the 16 bit return addresses of parts with up to 64 KB of FLASH memory.
+#endif
+
+#if ((PROFILER_BINS << PROFILER_DEFAULT_SHIFT) <= FLASHEND)
+	#error PROFILER_BINS and PROFILER_DEFAULT_SHIFT must cover the whole FLASH memory.
+#endif
+
+/** Registers saved by the sampler interrupt before it reads the interrupted address: r0, SREG, r1 and the registers
+ *  a call may clobber, r18 to r27, r30 and r31.
+ */
+#define PROFILER_SAVED_BYTES       15
+
+/** Counts of the samples in each bin. */
+static volatile uint16_t Profiler_Bins[PROFILER_BINS];
+
+/** Sampler state: the range of the bins and the samples taken. */
+static volatile ProfilerState_t Profiler_State;
+
+void Profiler_Sample(const uint16_t WordAddress) __attribute__((used));
+
+/** Counts a sample of the program counter, from the sampler interrupt.
+ *
+ *  \param[in] WordAddress  Interrupted FLASH address, in words as pushed by the interrupt
+ */
+void Profiler_Sample(const uint16_t WordAddress)
+{
+	uint16_t Address = (WordAddress << 1);
+	uint16_t Bin     = ((Address - Profiler_State.Base) >> Profiler_State.Shift);
+
+	Profiler_State.Samples++;
+
+	if ((Address < Profiler_State.Base) || (Bin >= PROFILER_BINS))
+	{
+		if (Profiler_State.Other != 0xFFFF)
+		  Profiler_State.Other++;
+
+		return;
+	}
+
+	if (++Profiler_Bins[Bin] == 0xFFFF)
+	{
+		Profiler_State.Full = true;
+		TIMSK0 &= ~(1 << OCIE0A);
+	}
+}
+
+/** Sampler interrupt. Only naked can it know where the return address is, so it saves what a call into C needs by
+ *  hand, passes the return address of the interrupt, big endian on the stack just above the saved registers, to
+ *  \ref Profiler_Sample() and restores the registers again.
+ */
+ISR(TIMER0_COMPA_vect, ISR_NAKED)
+{
+	__asm__ __volatile__
+	(
+		"push r0"                 "\n\t"
+		"in   r0, __SREG__"       "\n\t"
+		"push r0"                 "\n\t"
+		"push r1"                 "\n\t"
+		"clr  __zero_reg__"       "\n\t"
+		"push r18"                "\n\t"
+		"push r19"                "\n\t"
+		"push r20"                "\n\t"
+		"push r21"                "\n\t"
+		"push r22"                "\n\t"
+		"push r23"                "\n\t"
+		"push r24"                "\n\t"
+		"push r25"                "\n\t"
+		"push r26"                "\n\t"
+		"push r27"                "\n\t"
+		"push r30"                "\n\t"
+		"push r31"                "\n\t"
+		"in   r30, __SP_L__"      "\n\t"
+		"in   r31, __SP_H__"      "\n\t"
+		"ldd  r25, Z+%[High]"     "\n\t"
+		"ldd  r24, Z+%[Low]"      "\n\t"
+		"%~call Profiler_Sample"  "\n\t"
+		"pop  r31"                "\n\t"
+		"pop  r30"                "\n\t"
+		"pop  r27"                "\n\t"
+		"pop  r26"                "\n\t"
+		"pop  r25"                "\n\t"
+		"pop  r24"                "\n\t"
+		"pop  r23"                "\n\t"
+		"pop  r22"                "\n\t"
+		"pop  r21"                "\n\t"
+		"pop  r20"                "\n\t"
+		"pop  r19"                "\n\t"
+		"pop  r18"                "\n\t"
+		"pop  r1"                 "\n\t"
+		"pop  r0"                 "\n\t"
+		"out  __SREG__, r0"       "\n\t"
+		"pop  r0"                 "\n\t"
+		"reti"                    "\n\t"
+		:: [High] "I" (PROFILER_SAVED_BYTES + 1), [Low] "I" (PROFILER_SAVED_BYTES + 2)
+	);
+}
+
+/** Sets the bins to cover the whole FLASH memory, then starts Timer 0 sampling. */
+void Profiler_Init(void)
+{
+	Profiler_SetRange(0, PROFILER_DEFAULT_SHIFT);
+
+	TCCR0A = (1 << WGM01);
+	TCCR0B = ((1 << CS01) | (1 << CS00));
+	OCR0A  = PROFILER_TIMER_COMPARE;
+
+	Profiler_Resume();
+}
+
+/** Stops sampling, so that the histogram holds still while it is read. */
+void Profiler_Pause(void)
+{
+	TIMSK0 &= ~(1 << OCIE0A);
+}
+
+/** Restarts sampling after \ref Profiler_Pause(), unless a bin has filled up. */
+void Profiler_Resume(void)
+{
+	if (!(Profiler_State.Full))
+	  TIMSK0 |= (1 << OCIE0A);
+}
+
+/** Clears the histogram, keeping the range of the bins, and restarts sampling if a bin had filled up. */
+void Profiler_ClearSamples(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (uint8_t Bin = 0; Bin < PROFILER_BINS; Bin++)
+		  Profiler_Bins[Bin] = 0;
+
+		Profiler_State.Samples = 0;
+		Profiler_State.Other   = 0;
+
+		if (Profiler_State.Full)
+		{
+			Profiler_State.Full = false;
+			TIMSK0 |= (1 << OCIE0A);
+		}
+	}
+}
+
+/** Narrows the bins onto a range of FLASH memory and clears the histogram.
+ *
+ *  \param[in] Base   FLASH byte address of the first bin
+ *  \param[in] Shift  Bytes per bin, as a power of two
+ *
+ *  \return Boolean \c true if the range was set, \c false if it does not start within FLASH memory
+ */
+bool Profiler_SetRange(const uint16_t Base, const uint8_t Shift)
+{
+	if ((Base > FLASHEND) || (Shift > 15))
+	  return false;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Profiler_State.Base  = Base;
+		Profiler_State.Shift = Shift;
+		Profiler_ClearSamples();
+	}
+
+	return true;
+}
+
+/** Takes a consistent copy of the state of the sampler.
+ *
+ *  \param[out] State  Copy of the sampler state
+ */
+void Profiler_GetState(ProfilerState_t* const State)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		*State = Profiler_State;
+	}
+}
+
+/** Retrieves the sample count of a bin.
+ *
+ *  \param[in] Bin  Index of the bin, below \ref PROFILER_BINS
+ *
+ *  \return Samples counted in the bin
+ */
+uint16_t Profiler_GetBin(const uint8_t Bin)
+{
+	uint16_t Count;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Count = Profiler_Bins[Bin];
+	}
+
+	return Count;
+}
+
+#endif
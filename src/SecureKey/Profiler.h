@@ -0,0 +1,52 @@
+/** \file
+ *
+ *  Header file for Profiler.c.
+ */
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/interrupt.h>
+		#include <util/atomic.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+	/* Macros: */
+		/** Number of bins of the histogram of sampled addresses. */
+		#define PROFILER_BINS              64
+
+		/** Bytes of FLASH memory per bin as set by \ref Profiler_Init(), as a power of two, so that the bins cover the
+		 *  whole FLASH memory until a narrower range is chosen with \ref Profiler_SetRange().
+		 */
+		#define PROFILER_DEFAULT_SHIFT     9
+
+		/** Compare value of Timer 0, which runs at F_CPU / 64, for a sample every 241 counts (964 us at 16 MHz).
+		 *  The period is kept prime and off the 1 ms USB frame, so that the samples walk across the frame rather
+		 *  than always landing on the same point of the tasks run on the frame tick.
+		 */
+		#define PROFILER_TIMER_COMPARE     240
+
+	/* Type Defines: */
+		/** Type define for the state of the sampler, as reported by \ref Profiler_GetState(). */
+		typedef struct
+		{
+			uint32_t Samples;       /**< Samples taken since the histogram was cleared */
+			uint16_t Other;         /**< Samples outside the range of the bins */
+			uint16_t Base;          /**< FLASH byte address of the first bin */
+			uint8_t  Shift;         /**< Bytes per bin, as a power of two */
+			bool     Full;          /**< Flag set once a bin has filled up and sampling has stopped */
+		} ProfilerState_t;
+
+	/* Function Prototypes: */
+		#if defined(PC_PROFILER) || defined(__DOXYGEN__)
+			void Profiler_Init(void);
+			void Profiler_Pause(void);
+			void Profiler_Resume(void);
+			void Profiler_ClearSamples(void);
+			bool Profiler_SetRange(const uint16_t Base, const uint8_t Shift);
+			void Profiler_GetState(ProfilerState_t* const State);
+			uint16_t Profiler_GetBin(const uint8_t Bin);
+		#endif
+#endif
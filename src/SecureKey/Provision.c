@@ -0,0 +1,375 @@
+/** \file
+ *
+ *  Binary provisioning protocol, run over the virtual serial port in place of the console. Each frame is COBS
+ *  encoded and ends with a zero byte, and holds a type, a sequence number, a payload and a CRC-16 of the rest. The
+ *  host may run up to \ref PROVISION_WINDOW frames ahead of the acknowledgements, and goes back to the sequence
+ *  number of a negative acknowledgement to resend a damaged frame and those after it.
+ *
+ *  A frame is only acknowledged once its data has been taken by the store, and the next frame is not decoded before
+ *  then, so a slow store holds the frames back in the CDC endpoint rather than in RAM.
+ */
+
+#include "Provision.h"
+
+/** Sends a response frame, adding its CRC and COBS encoding it into the output buffer, which must have
+ *  \ref PROVISION_RESPONSE_SIZE bytes free.
+ *
+ *  \param[in,out] Output  Ring buffer for the frame
+ *  \param[in]     Type    Frame type, a value from \ref ProvisionFrameTypes_t
+ *  \param[in]     First   First byte of the frame after the type
+ *  \param[in]     Second  Second byte of the frame after the type
+ */
+static void Provision_SendFrame(RingBuffer_t* const Output, const uint8_t Type, const uint8_t First, const uint8_t Second)
+{
+	uint8_t  Frame[5] = {Type, First, Second};
+	uint16_t CRC      = 0xFFFF;
+
+	for (uint8_t Index = 0; Index < 3; Index++)
+	  CRC = _crc_ccitt_update(CRC, Frame[Index]);
+
+	Frame[3] = (CRC & 0xFF);
+	Frame[4] = (CRC >> 8);
+
+	uint8_t BlockStart = 0;
+
+	for (uint8_t Index = 0; Index <= sizeof(Frame); Index++)
+	{
+		if ((Index < sizeof(Frame)) && Frame[Index])
+		  continue;
+
+		RingBuffer_Insert(Output, (Index - BlockStart + 1));
+
+		while (BlockStart < Index)
+		  RingBuffer_Insert(Output, Frame[BlockStart++]);
+
+		BlockStart++;
+	}
+
+	RingBuffer_Insert(Output, 0x00);
+}
+
+/** Clears the frame decoder for the start of the next frame. */
+static void Provision_ResetFrame(Provision_t* const Provision)
+{
+	Provision->FrameLength = 0;
+	Provision->BlockLeft   = 0;
+	Provision->BlockZero   = false;
+	Provision->Discarding  = false;
+}
+
+/** Adds a decoded byte to the frame, dropping the frame if it outgrows the buffer. */
+static void Provision_PutByte(Provision_t* const Provision, const uint8_t Byte)
+{
+	if (Provision->FrameLength == Provision->FrameSize)
+	  Provision->Discarding = true;
+	else
+	  Provision->Frame[Provision->FrameLength++] = Byte;
+}
+
+/** Decodes a single received byte, marking the frame ready once its delimiter is reached.
+ *
+ *  \param[in,out] Provision  Session receiving the byte
+ *  \param[in]     Byte       Byte received from the host
+ */
+static void Provision_DecodeByte(Provision_t* const Provision, const uint8_t Byte)
+{
+	if (!(Byte))
+	{
+		/* A frame cut short or overrun is still handled, so that it is asked for again */
+		if (Provision->FrameLength || Provision->BlockLeft || Provision->Discarding)
+		  Provision->FrameReady = true;
+
+		return;
+	}
+
+	if (Provision->BlockLeft)
+	{
+		Provision_PutByte(Provision, Byte);
+		Provision->BlockLeft--;
+		return;
+	}
+
+	/* A code byte, which ends the previous block with a zero unless that block was a full run of 254 bytes */
+	if (Provision->BlockZero)
+	  Provision_PutByte(Provision, 0x00);
+
+	Provision->BlockZero = (Byte != 0xFF);
+	Provision->BlockLeft = (Byte - 1);
+}
+
+/** Checks that a decoded frame is complete and that its CRC matches.
+ *
+ *  \return Boolean \c true if the frame is intact
+ */
+static bool Provision_CheckFrame(const Provision_t* const Provision)
+{
+	uint8_t  Length = Provision->FrameLength;
+	uint16_t CRC    = 0xFFFF;
+
+	if ((Length < PROVISION_FRAME_OVERHEAD) || Provision->BlockLeft || Provision->Discarding)
+	  return false;
+
+	for (uint8_t Index = 0; Index < (Length - 2); Index++)
+	  CRC = _crc_ccitt_update(CRC, Provision->Frame[Index]);
+
+	return ((Provision->Frame[Length - 2] | ((uint16_t)Provision->Frame[Length - 1] << 8)) == CRC);
+}
+
+/** Gives the number of data bytes still expected for the open record of the session. */
+static uint16_t Provision_GetRemaining(const Provision_t* const Provision)
+{
+	switch (Provision->Store)
+	{
+		case PROVISION_STORE_EEPROM:
+			return EEPROMStore_GetRemaining();
+		case PROVISION_STORE_Flash:
+			return FlashStore_GetRemaining();
+		default:
+			return Provision->NullLeft;
+	}
+}
+
+/** Handles a begin frame, starting a record in the requested store.
+ *
+ *  \return Status of the frame, a value from \ref ProvisionStatus_t
+ */
+static uint8_t Provision_BeginRecord(Provision_t* const Provision, const uint8_t* const Payload, const uint8_t Length)
+{
+	if (Length != 4)
+	  return PROVISION_STATUS_BadFrame;
+
+	uint8_t  Slot         = Payload[1];
+	uint16_t RecordLength = (Payload[2] | ((uint16_t)Payload[3] << 8));
+
+	if (Provision_GetRemaining(Provision) || EEPROMStore_IsBusy() || FlashStore_IsOpen() || FlashStore_IsBusy())
+	  return PROVISION_STATUS_Busy;
+
+	Provision->Store = Payload[0];
+
+	switch (Payload[0])
+	{
+		case PROVISION_STORE_EEPROM:
+			switch (EEPROMStore_Begin(Slot, RecordLength))
+			{
+				case EEPROM_STORE_WRITE_Started:
+					return PROVISION_STATUS_OK;
+				case EEPROM_STORE_WRITE_BadSlot:
+					return PROVISION_STATUS_BadSlot;
+				case EEPROM_STORE_WRITE_Full:
+					return PROVISION_STATUS_Full;
+				default:
+					return PROVISION_STATUS_Busy;
+			}
+		case PROVISION_STORE_Flash:
+			switch (FlashStore_Begin(Slot, RecordLength))
+			{
+				case FLASH_STORE_Started:
+					return PROVISION_STATUS_OK;
+				case FLASH_STORE_BadSlot:
+					return PROVISION_STATUS_BadSlot;
+				case FLASH_STORE_Full:
+					return PROVISION_STATUS_Full;
+				case FLASH_STORE_NoBootloader:
+					return PROVISION_STATUS_NoBootloader;
+				default:
+					return PROVISION_STATUS_Busy;
+			}
+		case PROVISION_STORE_Null:
+			Provision->NullLeft = RecordLength;
+			return PROVISION_STATUS_OK;
+		default:
+			Provision->Store    = PROVISION_STORE_Null;
+			Provision->NullLeft = 0;
+			return PROVISION_STATUS_BadFrame;
+	}
+}
+
+/** Hands the payload of a data frame to the store of the open record, as far as the store takes it.
+ *
+ *  \return Boolean \c true once the whole payload has been taken
+ */
+static bool Provision_WriteData(Provision_t* const Provision, const uint8_t* const Payload, const uint8_t Length)
+{
+	const uint8_t* Data  = &Payload[Provision->DataTaken];
+	uint8_t        Count = (Length - Provision->DataTaken);
+
+	switch (Provision->Store)
+	{
+		case PROVISION_STORE_EEPROM:
+			Provision->DataTaken += EEPROMStore_Append(Data, Count);
+			break;
+		case PROVISION_STORE_Flash:
+			Provision->DataTaken += FlashStore_Write(Data, Count);
+			break;
+		default:
+			Provision->NullLeft  -= Count;
+			Provision->DataTaken += Count;
+			break;
+	}
+
+	return (Provision->DataTaken == Length);
+}
+
+/** Handles a complete frame, if the store and the output buffer are ready for it.
+ *
+ *  \param[in,out] Provision  Session receiving the frame
+ *  \param[in,out] Output     Ring buffer for the response
+ *
+ *  \return Boolean \c true once the frame has been handled, \c false to be called again later
+ */
+static bool Provision_HandleFrame(Provision_t* const Provision, RingBuffer_t* const Output)
+{
+	uint8_t* Frame  = Provision->Frame;
+	uint8_t  Length = (Provision->FrameLength - PROVISION_FRAME_OVERHEAD);
+	uint8_t  Status = PROVISION_STATUS_OK;
+
+	if (RingBuffer_GetFreeCount(Output) < PROVISION_RESPONSE_SIZE)
+	  return false;
+
+	if (!(Provision_CheckFrame(Provision)))
+	{
+		if (!(Provision->NakSent))
+		  Provision_SendFrame(Output, PROVISION_FRAME_Nak, Provision->Expected, 0);
+
+		Provision->NakSent = true;
+		return true;
+	}
+
+	if (Frame[1] != Provision->Expected)
+	{
+		uint8_t Ahead = (Frame[1] - Provision->Expected);
+
+		/* A frame already handled is sent again when its acknowledgement was lost, so the last one is repeated */
+		if (Ahead >= PROVISION_WINDOW)
+		{
+			Provision_SendFrame(Output, PROVISION_FRAME_Ack, Provision->Expected, Provision->LastStatus);
+			return true;
+		}
+
+		/* Frames the host sent after a lost one arrive further and further ahead; one no further ahead than the last
+		 * starts a resend that also lost the expected frame, so it is asked for again */
+		if (!(Provision->NakSent) || (Ahead <= Provision->Ahead))
+		  Provision_SendFrame(Output, PROVISION_FRAME_Nak, Provision->Expected, 0);
+
+		Provision->NakSent = true;
+		Provision->Ahead   = Ahead;
+		return true;
+	}
+
+	switch (Frame[0])
+	{
+		case PROVISION_FRAME_Begin:
+			Status = Provision_BeginRecord(Provision, &Frame[2], Length);
+			break;
+		case PROVISION_FRAME_Data:
+			if (!(Provision->DataTaken) && (Length > Provision_GetRemaining(Provision)))
+			  Status = PROVISION_STATUS_NoRecord;
+			else if (!(Provision_WriteData(Provision, &Frame[2], Length)))
+			  return false;
+
+			break;
+		case PROVISION_FRAME_End:
+			if (EEPROMStore_IsBusy() || FlashStore_IsOpen() || FlashStore_IsBusy())
+			  return false;
+
+			Provision->Active = false;
+			break;
+		default:
+			Status = PROVISION_STATUS_BadFrame;
+			break;
+	}
+
+	Provision_SendFrame(Output, PROVISION_FRAME_Ack, ++Provision->Expected, Status);
+	Provision->LastStatus = Status;
+	Provision->NakSent    = false;
+	Provision->Ahead      = 0;
+	return true;
+}
+
+/** Starts a provisioning session, which takes over the virtual serial port until the host ends it.
+ *
+ *  \param[out] Provision  Session to start
+ *  \param[in]  Buffer     Buffer for the frame being handled, which limits the payload of each frame
+ *  \param[in]  Size       Size of \c Buffer in bytes, at least \ref PROVISION_FRAME_OVERHEAD plus one
+ */
+void Provision_Begin(Provision_t* const Provision, uint8_t* const Buffer, const uint8_t Size)
+{
+	memset(Provision, 0, sizeof(Provision_t));
+
+	Provision->Frame        = Buffer;
+	Provision->FrameSize    = Size;
+	Provision->Store        = PROVISION_STORE_Null;
+	Provision->HelloPending = true;
+	Provision->Active       = true;
+}
+
+/** Runs a provisioning session for as long as it can make progress: received bytes are decoded until a frame is
+ *  complete, then the frame is handled once its store can take it, and so on while input remains.
+ *
+ *  \param[in,out] Provision  Session to run
+ *  \param[in,out] Input      Ring buffer of bytes from the host
+ *  \param[in,out] Output     Ring buffer of bytes for the host
+ *
+ *  \return Boolean \c true once the host has ended the session
+ */
+bool Provision_Task(Provision_t* const Provision, RingBuffer_t* const Input, RingBuffer_t* const Output)
+{
+	if (Provision->HelloPending)
+	{
+		if (RingBuffer_GetFreeCount(Output) < (PROVISION_RESPONSE_SIZE + 1))
+		  return false;
+
+		/* A leading delimiter ends the echo of the command line on the host, so the hello frame decodes cleanly */
+		RingBuffer_Insert(Output, 0x00);
+		Provision_SendFrame(Output, PROVISION_FRAME_Hello, (Provision->FrameSize - PROVISION_FRAME_OVERHEAD),
+		                    PROVISION_WINDOW);
+		Provision->HelloPending = false;
+	}
+
+	for (;;)
+	{
+		if (Provision->FrameReady)
+		{
+			if (!(Provision_HandleFrame(Provision, Output)))
+			  return false;
+
+			Provision->FrameReady = false;
+			Provision->DataTaken  = 0;
+			Provision_ResetFrame(Provision);
+
+			if (!(Provision->Active))
+			  return true;
+		}
+
+		if (RingBuffer_IsEmpty(Input))
+		  return false;
+
+		Provision_DecodeByte(Provision, RingBuffer_Remove(Input));
+	}
+}
+
+/** Ends a provisioning session which the host has left, abandoning any record it did not finish. */
+void Provision_Abort(Provision_t* const Provision)
+{
+	/* A record with all of its data is left for its store to finish */
+	if (Provision_GetRemaining(Provision))
+	{
+		if (Provision->Store == PROVISION_STORE_EEPROM)
+		  EEPROMStore_Abort();
+		else if (Provision->Store == PROVISION_STORE_Flash)
+		  FlashStore_Abort();
+	}
+
+	Provision->Active = false;
+}
+
+/** Checks whether a provisioning session is running.
+ *
+ *  \param[in] Provision  Session to check
+ *
+ *  \return Boolean \c true from \ref Provision_Begin() until the session has ended
+ */
+bool Provision_IsActive(const Provision_t* const Provision)
+{
+	return Provision->Active;
+}
@@ -0,0 +1,92 @@
+/** \file
+ *
+ *  Header file for Provision.c.
+ */
+
+#ifndef _PROVISION_H_
+#define _PROVISION_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <util/crc16.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+		#include <LUFA/Drivers/Misc/RingBuffer.h>
+
+		#include "EEPROMStore.h"
+		#include "FlashStore.h"
+
+	/* Macros: */
+		/** Bytes of a frame besides its payload: the type and sequence number before it and the CRC-16 after it. */
+		#define PROVISION_FRAME_OVERHEAD   4
+
+		/** Number of frames the host may send ahead of the acknowledgements, advertised in the hello frame. */
+		#define PROVISION_WINDOW           4
+
+		/** Free space needed in the output buffer for a response frame, once COBS encoded and delimited. */
+		#define PROVISION_RESPONSE_SIZE    8
+
+	/* Enums: */
+		/** Enum for the frame types of the provisioning protocol. Host frames have bit 7 clear, device frames set. */
+		enum ProvisionFrameTypes_t
+		{
+			PROVISION_FRAME_Begin = 0x01, /**< Starts a record: store, slot and length (LE) */
+			PROVISION_FRAME_Data  = 0x02, /**< Next part of the data of the record */
+			PROVISION_FRAME_End   = 0x03, /**< Waits for the stores to finish and ends the session */
+			PROVISION_FRAME_Hello = 0x80, /**< Sent on entry: largest payload and window */
+			PROVISION_FRAME_Ack   = 0x81, /**< Host frames up to the sequence number are handled, with their status */
+			PROVISION_FRAME_Nak   = 0x82, /**< A frame was lost or damaged; resend from the sequence number */
+		};
+
+		/** Enum for the stores a record can be written to. */
+		enum ProvisionStores_t
+		{
+			PROVISION_STORE_EEPROM = 0, /**< The EEPROM store */
+			PROVISION_STORE_Flash  = 1, /**< The FLASH store */
+			PROVISION_STORE_Null   = 2, /**< Nowhere; the data is dropped, to measure the link alone */
+		};
+
+		/** Enum for the status of an acknowledged frame. */
+		enum ProvisionStatus_t
+		{
+			PROVISION_STATUS_OK           = 0, /**< The frame was handled */
+			PROVISION_STATUS_Busy         = 1, /**< A record is already being written */
+			PROVISION_STATUS_BadSlot      = 2, /**< The slot number is out of range for the store */
+			PROVISION_STATUS_Full         = 3, /**< The store has no room for the record */
+			PROVISION_STATUS_NoBootloader = 4, /**< The FLASH store cannot be written with this bootloader */
+			PROVISION_STATUS_BadFrame     = 5, /**< The frame type, store or payload is not valid */
+			PROVISION_STATUS_NoRecord     = 6, /**< Data was sent without a record, or past its end */
+		};
+
+	/* Type Defines: */
+		/** Type define for the state of a provisioning session. Frames are decoded one at a time into a buffer given
+		 *  by the caller, and the data of each is handed to its store straight from there, so a record of any length
+		 *  needs no more RAM than a single frame.
+		 */
+		typedef struct
+		{
+			uint8_t* Frame;        /**< Buffer holding the frame being decoded or handled */
+			uint8_t  FrameSize;    /**< Size of \c Frame in bytes */
+			uint8_t  FrameLength;  /**< Number of decoded bytes in \c Frame */
+			uint8_t  BlockLeft;    /**< Bytes left in the current COBS block */
+			bool     BlockZero;    /**< Flag set if the current COBS block ends in a zero byte */
+			bool     Discarding;   /**< Flag set if the frame overran \c Frame and is dropped up to its delimiter */
+			bool     FrameReady;   /**< Flag set while a complete frame waits to be handled */
+			uint8_t  DataTaken;    /**< Bytes of the payload of a data frame given to the store so far */
+			uint8_t  Expected;     /**< Sequence number of the next host frame */
+			uint8_t  LastStatus;   /**< Status the last handled frame was acknowledged with */
+			bool     NakSent;      /**< Flag set once the frame with the expected sequence number has been asked for */
+			uint8_t  Ahead;        /**< How far ahead of \c Expected the last intact frame dropped since then was */
+			bool     HelloPending; /**< Flag set until the hello frame has been sent */
+			bool     Active;       /**< Flag set from the start of the session until its end frame or an abort */
+			uint8_t  Store;        /**< Store of the open record, a value from \ref ProvisionStores_t */
+			uint16_t NullLeft;     /**< Bytes of the open record left to drop, for \ref PROVISION_STORE_Null */
+		} Provision_t;
+
+	/* Function Prototypes: */
+		void Provision_Begin(Provision_t* const Provision, uint8_t* const Buffer, const uint8_t Size);
+		bool Provision_Task(Provision_t* const Provision, RingBuffer_t* const Input, RingBuffer_t* const Output);
+		void Provision_Abort(Provision_t* const Provision);
+		bool Provision_IsActive(const Provision_t* const Provision);
+#endif
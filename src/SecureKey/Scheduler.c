@@ -0,0 +1,172 @@
+/** \file
+ *
+ *  Run-to-completion task scheduler. Tasks are listed in a table in FLASH memory, in priority order; untimed
+ *  tasks run on every pass of the main loop, while timed tasks are placed on a timer wheel which is turned by
+ *  the millisecond tick of the USB Start of Frame event and run once they become due.
+ */
+
+#include "Scheduler.h"
+
+/** Task table given to \ref Scheduler_Init(), in FLASH memory. */
+static const SchedulerTask_t* Scheduler_Tasks;
+
+/** Number of entries in \ref Scheduler_Tasks. */
+static uint8_t Scheduler_TaskCount;
+
+/** Millisecond tick count, advanced by \ref Scheduler_Tick(). */
+static volatile uint16_t Scheduler_TickCount;
+
+/** Timer wheel, holding in each slot a mask of the timed tasks which are waiting on that slot. */
+static volatile SchedulerMask_t Scheduler_Wheel[SCHEDULER_WHEEL_SLOTS];
+
+/** Number of times each waiting task still has to be passed over by the wheel before it becomes due. */
+static volatile uint16_t Scheduler_Rounds[SCHEDULER_MAX_TASKS];
+
+/** Tick at which each ready task became due, to check its start against its deadline. */
+static volatile uint16_t Scheduler_DueTick[SCHEDULER_MAX_TASKS];
+
+/** Mask of the timed tasks which are due to run. */
+static volatile SchedulerMask_t Scheduler_ReadyMask;
+
+/** Run-time accounting of each task. */
+static SchedulerTaskStats_t Scheduler_Stats[SCHEDULER_MAX_TASKS];
+
+/** Places a timed task on the wheel so that it becomes due the given number of ticks from now. */
+static void Scheduler_Schedule(const uint8_t Task, const uint16_t PeriodMS)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		uint8_t Slot = (uint8_t)(Scheduler_TickCount + PeriodMS) & (SCHEDULER_WHEEL_SLOTS - 1);
+
+		Scheduler_Rounds[Task] = (PeriodMS - 1) / SCHEDULER_WHEEL_SLOTS;
+		Scheduler_Wheel[Slot] |= SCHEDULER_TASK_MASK(Task);
+	}
+}
+
+/** Sets up the scheduler with a task table, and starts Timer 1 counting CPU cycles for the task accounting. Entries
+ *  past \ref SCHEDULER_MAX_TASKS have no bit in the task masks and are never run; callers should check the size of
+ *  their table against it at compile time.
+ *
+ *  \param[in] Tasks      Task table in FLASH memory, in priority order
+ *  \param[in] TaskCount  Number of entries in the table, no more than \ref SCHEDULER_MAX_TASKS
+ */
+void Scheduler_Init(const SchedulerTask_t* const Tasks, const uint8_t TaskCount)
+{
+	Scheduler_Tasks     = Tasks;
+	Scheduler_TaskCount = (TaskCount < SCHEDULER_MAX_TASKS) ? TaskCount : SCHEDULER_MAX_TASKS;
+
+	TCCR1A = 0;
+	TCCR1B = (1 << CS10);
+
+	for (uint8_t Task = 0; Task < Scheduler_TaskCount; Task++)
+	{
+		uint16_t PeriodMS = pgm_read_word(&Tasks[Task].PeriodMS);
+
+		if (PeriodMS)
+		  Scheduler_Schedule(Task, PeriodMS);
+	}
+}
+
+/** Advances the timer wheel by a millisecond, marking the tasks on the new slot as ready once they have waited out
+ *  their remaining turns of the wheel. This is called from the USB Start of Frame event, in interrupt context.
+ */
+void Scheduler_Tick(void)
+{
+	uint16_t TickCount = ++Scheduler_TickCount;
+	uint8_t  Slot      = (uint8_t)TickCount & (SCHEDULER_WHEEL_SLOTS - 1);
+	SchedulerMask_t Waiting = Scheduler_Wheel[Slot];
+
+	for (uint8_t Task = 0; Waiting; Task++, Waiting >>= 1)
+	{
+		if (!(Waiting & 0x01))
+		  continue;
+
+		if (Scheduler_Rounds[Task])
+		{
+			Scheduler_Rounds[Task]--;
+			continue;
+		}
+
+		Scheduler_Wheel[Slot] &= ~SCHEDULER_TASK_MASK(Task);
+		Scheduler_ReadyMask   |=  SCHEDULER_TASK_MASK(Task);
+		Scheduler_DueTick[Task] = TickCount;
+	}
+}
+
+/** Makes one pass over the task table, running every untimed task and every timed task which is due, in table
+ *  order. Each timed task is put back on the wheel for its next period once it has run.
+ */
+void Scheduler_RunTasks(void)
+{
+	for (uint8_t Task = 0; Task < Scheduler_TaskCount; Task++)
+	{
+		const SchedulerTask_t* Entry    = &Scheduler_Tasks[Task];
+		uint16_t               PeriodMS = pgm_read_word(&Entry->PeriodMS);
+		SchedulerTaskStats_t*  Stats    = &Scheduler_Stats[Task];
+
+		if (PeriodMS)
+		{
+			uint16_t Lateness;
+
+			if (!(Scheduler_ReadyMask & SCHEDULER_TASK_MASK(Task)))
+			  continue;
+
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				Scheduler_ReadyMask &= ~SCHEDULER_TASK_MASK(Task);
+				Lateness = (Scheduler_TickCount - Scheduler_DueTick[Task]);
+			}
+
+			if (Lateness > pgm_read_word(&Entry->DeadlineMS))
+			  Stats->LateRuns++;
+		}
+
+		void (*Run)(void) = (void (*)(void))pgm_read_ptr(&Entry->Run);
+
+		uint16_t StartCycles = Scheduler_Cycles();
+		Run();
+		uint16_t Cycles = (Scheduler_Cycles() - StartCycles);
+
+		Stats->TotalCycles += Cycles;
+		Stats->Runs++;
+
+		if (Cycles > Stats->MaxCycles)
+		  Stats->MaxCycles = Cycles;
+
+		if (PeriodMS)
+		  Scheduler_Schedule(Task, PeriodMS);
+	}
+}
+
+/** Retrieves the millisecond tick count of the scheduler.
+ *
+ *  \return Number of Start of Frame ticks seen, wrapping at 65536
+ */
+uint16_t Scheduler_GetTicks(void)
+{
+	uint16_t TickCount;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		TickCount = Scheduler_TickCount;
+	}
+
+	return TickCount;
+}
+
+/** Retrieves the run-time accounting of a task.
+ *
+ *  \param[in] Task  Index of the task in the task table
+ *
+ *  \return Pointer to the statistics of the task
+ */
+const SchedulerTaskStats_t* Scheduler_GetTaskStats(const uint8_t Task)
+{
+	return &Scheduler_Stats[Task];
+}
+
+/** Clears the run-time accounting of all tasks. */
+void Scheduler_ClearTaskStats(void)
+{
+	memset(Scheduler_Stats, 0, sizeof(Scheduler_Stats));
+}
@@ -0,0 +1,73 @@
+/** \file
+ *
+ *  Header file for Scheduler.c.
+ */
+
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <util/atomic.h>
+		#include <stdbool.h>
+		#include <string.h>
+
+	/* Macros: */
+		/** Number of slots of the timer wheel, one per millisecond tick; must be a power of two. Tasks with longer
+		 *  periods wait out whole turns of the wheel before they become ready.
+		 */
+		#define SCHEDULER_WHEEL_SLOTS      8
+
+		/** Maximum number of tasks in a task table, one per bit of a \ref SchedulerMask_t task mask. */
+		#define SCHEDULER_MAX_TASKS        (sizeof(SchedulerMask_t) * 8)
+
+		/** Mask of a task in a \ref SchedulerMask_t task mask.
+		 *
+		 *  \param[in] Task  Index of the task in the task table
+		 */
+		#define SCHEDULER_TASK_MASK(Task)  ((SchedulerMask_t)(1U << (Task)))
+
+	/* Type Defines: */
+		/** Type define for a mask of tasks, one bit per entry of the task table, as held in the slots of the timer
+		 *  wheel and in the mask of ready tasks. Its width sets \ref SCHEDULER_MAX_TASKS.
+		 */
+		typedef uint16_t SchedulerMask_t;
+
+		/** Type define for a task table entry. Task tables are located in FLASH memory. */
+		typedef struct
+		{
+			void     (*Run)(void); /**< Task function, which must run to completion without blocking */
+			uint16_t PeriodMS;     /**< Milliseconds between runs, or zero to run on every pass of the main loop */
+			uint16_t DeadlineMS;   /**< Milliseconds a timed task may wait to start once due before the run is late */
+		} SchedulerTask_t;
+
+		/** Type define for the run-time accounting of a task. Cycle counts are taken from Timer 1, which wraps
+		 *  every 65536 cycles (4 ms at 16 MHz); a task which runs longer than that breaks its own budget anyway.
+		 */
+		typedef struct
+		{
+			uint32_t TotalCycles; /**< Cycles spent in the task since the statistics were cleared */
+			uint16_t MaxCycles;   /**< Longest single run of the task, in cycles */
+			uint16_t Runs;        /**< Number of runs of the task */
+			uint16_t LateRuns;    /**< Number of timed runs started after their deadline */
+		} SchedulerTaskStats_t;
+
+	/* Inline Functions: */
+		/** Reads the free running cycle counter used for task accounting.
+		 *
+		 *  \return Current value of the cycle counter, in CPU cycles
+		 */
+		static inline uint16_t Scheduler_Cycles(void)
+		{
+			return TCNT1;
+		}
+
+	/* Function Prototypes: */
+		void Scheduler_Init(const SchedulerTask_t* const Tasks, const uint8_t TaskCount);
+		void Scheduler_Tick(void);
+		void Scheduler_RunTasks(void);
+		uint16_t Scheduler_GetTicks(void);
+		const SchedulerTaskStats_t* Scheduler_GetTaskStats(const uint8_t Task);
+		void Scheduler_ClearTaskStats(void);
+#endif
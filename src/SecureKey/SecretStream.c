@@ -0,0 +1,159 @@
+#include "SecretStream.h"
+
+/** Reads the next packed byte of a stream, through its decompressor if the secret is compressed.
+ *
+ *  \param[in,out] Stream  Stream to read from
+ *  \param[out]    Packed  Location where the byte is stored
+ *
+ *  \return Boolean \c true if a byte was read, \c false at the end of the secret
+ */
+static inline bool SecretStream_ReadPacked(SecretStream_t* const Stream, uint8_t* const Packed)
+{
+	if (Stream->Decompressor != NULL)
+	  return LZStream_ReadByte(Stream->Decompressor, &Stream->Source, Packed);
+
+	return ByteSource_ReadByte(&Stream->Source, Packed);
+}
+
+/** Decodes the next packed key of a stream into its lookahead, leaving a zero scancode there once the end of the
+ *  secret is reached. Single byte keys, which make up nearly every secret, cost a single byte read.
+ *
+ *  \param[in,out] Stream  Stream to decode from
+ */
+static void SecretStream_Fetch(SecretStream_t* const Stream)
+{
+	uint8_t Packed;
+
+	if (!(SecretStream_ReadPacked(Stream, &Packed)))
+	{
+		Stream->Next.key = 0;
+		return;
+	}
+
+	if (Packed != SECRET_PACKED_ESCAPE)
+	{
+		Stream->Next.key = (Packed & ~SECRET_PACKED_SHIFT);
+		Stream->Next.mod = ((Packed & SECRET_PACKED_SHIFT) ? SECRET_PACKED_SHIFT_MODIFIER : HID_KEYBOARD_MODIFIER_NONE);
+	}
+	else if (!(SecretStream_ReadPacked(Stream, &Stream->Next.mod)) ||
+	         !(SecretStream_ReadPacked(Stream, &Stream->Next.key)))
+	{
+		/* A truncated escape ends the secret */
+		Stream->Next.key = 0;
+	}
+}
+
+/** Points a stream at the start of a packed secret.
+ *
+ *  \param[out] Stream  Stream to open
+ *  \param[in]  Data    First byte of the packed secret, in FLASH memory
+ *  \param[in]  Length  Length of the packed secret in bytes
+ */
+void SecretStream_Open(SecretStream_t* const Stream, const uint8_t* const Data, const uint16_t Length)
+{
+	ByteSource_Open(&Stream->Source, Data, Length);
+	Stream->Decompressor = NULL;
+	SecretStream_Fetch(Stream);
+}
+
+/** Points a stream at the start of a packed secret held in EEPROM.
+ *
+ *  \param[out] Stream  Stream to open
+ *  \param[in]  Data    First byte of the packed secret, in EEPROM
+ *  \param[in]  Length  Length of the packed secret in bytes
+ */
+void SecretStream_OpenEEPROM(SecretStream_t* const Stream, const uint8_t* const Data, const uint16_t Length)
+{
+	ByteSource_OpenEEPROM(&Stream->Source, Data, Length);
+	Stream->Decompressor = NULL;
+	SecretStream_Fetch(Stream);
+}
+
+/** Points a stream at packed keys queued into a ring buffer as they arrive. The stream reads as empty whenever the
+ *  queue is, until \ref SecretStream_Refill() is called after more keys have been queued.
+ *
+ *  \param[out] Stream  Stream to open
+ *  \param[in]  Queue   Ring buffer holding the packed keys; escaped keys must be queued whole
+ */
+void SecretStream_OpenQueue(SecretStream_t* const Stream, RingBuffer_t* const Queue)
+{
+	ByteSource_OpenQueue(&Stream->Source, Queue);
+	Stream->Decompressor = NULL;
+	SecretStream_Fetch(Stream);
+}
+
+/** Points a stream at the start of a compressed packed secret, read through a decompressor which the stream uses
+ *  until it is opened again; the decompressor must not be given to another stream in the meantime.
+ *
+ *  \param[out] Stream            Stream to open
+ *  \param[in]  Decompressor      Decompressor to read the secret through
+ *  \param[in]  Data              First byte of the compressed secret, in FLASH memory
+ *  \param[in]  Length            Length of the compressed secret in bytes
+ *  \param[in]  Dictionary        Preset dictionary the secret was compressed against, in FLASH memory
+ *  \param[in]  DictionaryLength  Length of the dictionary in bytes
+ */
+void SecretStream_OpenCompressed(SecretStream_t* const Stream, LZStream_t* const Decompressor,
+                                 const uint8_t* const Data, const uint16_t Length,
+                                 const uint8_t* const Dictionary, const uint16_t DictionaryLength)
+{
+	ByteSource_Open(&Stream->Source, Data, Length);
+	LZStream_Open(Decompressor, Dictionary, DictionaryLength);
+	Stream->Decompressor = Decompressor;
+	SecretStream_Fetch(Stream);
+}
+
+/** Fetches the next key of the secret without advancing the stream, so that the caller can decide whether
+ *  the key fits into the report currently being built.
+ *
+ *  \param[in]  Stream  Stream to read from
+ *  \param[out] Key     Location where the key and its modifier are stored
+ *
+ *  \return Boolean \c true if a key was read, \c false if the end of the secret has been reached
+ */
+bool SecretStream_Peek(const SecretStream_t* const Stream, key_t* const Key)
+{
+	if (!(Stream->Next.key))
+	  return false;
+
+	*Key = Stream->Next;
+	return true;
+}
+
+/** Fetches the next key of the secret and advances the stream past it.
+ *
+ *  \param[in,out] Stream  Stream to read from
+ *  \param[out]    Key     Location where the key and its modifier are stored
+ *
+ *  \return Boolean \c true if a key was read, \c false if the end of the secret has been reached
+ */
+bool SecretStream_Read(SecretStream_t* const Stream, key_t* const Key)
+{
+	if (!(Stream->Next.key))
+	  return false;
+
+	*Key = Stream->Next;
+	SecretStream_Fetch(Stream);
+	return true;
+}
+
+/** Checks whether every key of the secret has been read.
+ *
+ *  \param[in] Stream  Stream to check
+ *
+ *  \return Boolean \c true if no keys remain in the stream
+ */
+bool SecretStream_IsEmpty(const SecretStream_t* const Stream)
+{
+	return !(Stream->Next.key);
+}
+
+/** Retries the lookahead of a stream which has run dry, so that keys queued since are read. Streams over stored
+ *  secrets stay at their end.
+ *
+ *  \param[in,out] Stream  Stream to refill
+ */
+void SecretStream_Refill(SecretStream_t* const Stream)
+{
+	if (!(Stream->Next.key))
+	  SecretStream_Fetch(Stream);
+}
@@ -0,0 +1,90 @@
+/** \file
+ *
+ *  Header file for SecretStream.c.
+ */
+
+#ifndef _SECRETSTREAM_H_
+#define _SECRETSTREAM_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+
+		#include "ByteSource.h"
+		#include "LZStream.h"
+
+	/* Macros: */
+		/** Modifier value for a key which is typed without any modifier keys held. */
+		#define HID_KEYBOARD_MODIFIER_NONE 0
+
+		/** Escape byte of the packed key encoding, followed by the modifier and the scancode of a key which does not
+		 *  fit into a single byte.
+		 */
+		#define SECRET_PACKED_ESCAPE        0x00
+
+		/** Bit of a single byte packed key which holds Left Shift down with the scancode in the lower seven bits. */
+		#define SECRET_PACKED_SHIFT         0x80
+
+		/** Modifier mask of a packed key with \ref SECRET_PACKED_SHIFT set, the Left Shift modifier. */
+		#define SECRET_PACKED_SHIFT_MODIFIER 0x02
+
+		/** Packs a key typed without modifiers, whose scancode must be below 0x80, into a single byte. */
+		#define SECRET_PACKED_KEY(key)      (key)
+
+		/** Packs a key typed with Left Shift, whose scancode must be below 0x80, into a single byte. */
+		#define SECRET_PACKED_SHIFTED(key)  (SECRET_PACKED_SHIFT | (key))
+
+		/** Packs any other key as an escape sequence of three bytes. */
+		#define SECRET_PACKED_ESCAPED(mod, key)  SECRET_PACKED_ESCAPE, (mod), (key)
+
+	/* Type Defines: */
+		/** Type define for a single stored keystroke, as a HID scancode and the modifier mask it is typed with. */
+		typedef struct {
+			uint8_t key;
+			uint8_t mod;
+		} key_t;
+
+		/** Type define for a read cursor over a stored secret. Secrets are held in the packed key encoding, where a
+		 *  key typed alone or with Left Shift takes a single byte (\ref SECRET_PACKED_KEY() and
+		 *  \ref SECRET_PACKED_SHIFTED()) and any other key a three byte escape (\ref SECRET_PACKED_ESCAPED()). Keys
+		 *  are decoded one at a time as HID reports are built, one key ahead of the reader so that peeking costs
+		 *  nothing. The packed bytes are read straight from their \ref ByteSource_t, or for a compressed secret through
+		 *  a decompressor lent by the opener, so that only compressed secrets pay for the decompressor window.
+		 */
+		typedef struct
+		{
+			ByteSource_t Source;       /**< Packed bytes of the secret, compressed if \c Decompressor is set */
+			LZStream_t*  Decompressor; /**< Decompressor the bytes of \c Source are read through, or \c NULL */
+			key_t        Next;         /**< Next key to be returned, with a zero scancode at the end of the secret */
+		} SecretStream_t;
+
+	/* Inline Functions: */
+		/** Reads a single key from a secret table located in FLASH memory. Each \ref key_t is two bytes wide, so
+		 *  the scancode and its modifier are fetched together with a single \c pgm_read_word().
+		 *
+		 *  \param[in] Keys   Secret table in FLASH memory
+		 *  \param[in] Index  Index of the key to read
+		 *
+		 *  \return The key at the given index of the table
+		 */
+		static inline key_t Secret_ReadKey_P(const key_t* const Keys, const uint16_t Index)
+		{
+			uint16_t Word = pgm_read_word(&Keys[Index]);
+			key_t    Key  = {.key = (Word & 0xFF), .mod = (Word >> 8)};
+
+			return Key;
+		}
+
+	/* Function Prototypes: */
+		void SecretStream_Open(SecretStream_t* const Stream, const uint8_t* const Data, const uint16_t Length);
+		void SecretStream_OpenEEPROM(SecretStream_t* const Stream, const uint8_t* const Data, const uint16_t Length);
+		void SecretStream_OpenQueue(SecretStream_t* const Stream, RingBuffer_t* const Queue);
+		void SecretStream_OpenCompressed(SecretStream_t* const Stream, LZStream_t* const Decompressor,
+		                                 const uint8_t* const Data, const uint16_t Length,
+		                                 const uint8_t* const Dictionary, const uint16_t DictionaryLength);
+		bool SecretStream_Peek(const SecretStream_t* const Stream, key_t* const Key);
+		bool SecretStream_Read(SecretStream_t* const Stream, key_t* const Key);
+		bool SecretStream_IsEmpty(const SecretStream_t* const Stream);
+		void SecretStream_Refill(SecretStream_t* const Stream);
+#endif
@@ -40,31 +40,151 @@
 #define LED_EN      (DDRD  |= 0b01100000) // enable leds as output
 #define HWBIN_EN    (DDRD  &= 0b01111111) // make hwb an input
 
-extern void led_blue(char);
-extern void led_red(char);
-extern char hwb_is_pressed(void);
-
 /** Circular buffer to hold data from the host before it is REPL. */
 static RingBuffer_t USBtoREPL_Buffer;
 
-/** Underlying data buffer for \ref USBtoREPL_Buffer, where the stored bytes are located. */
-static uint8_t      USBtoREPL_Buffer_Data[16];
+/** Underlying data buffer for \ref USBtoREPL_Buffer, where the stored bytes are located. Two packets are held so
+ *  that a whole packet can be drained from the endpoint while the previous one is still being processed.
+ */
+static uint8_t      USBtoREPL_Buffer_Data[CDC_TXRX_EPSIZE * 2];
 
 /** Circular buffer to hold data from the REPL before it is sent to the host. */
 static RingBuffer_t REPLtoUSB_Buffer;
 
-/** Underlying data buffer for \ref REPLtoUSB_Buffer, where the stored bytes are located. */
-static uint8_t      REPLtoUSB_Buffer_Data[16];
+/** Underlying data buffer for \ref REPLtoUSB_Buffer, where the stored bytes are located. Besides the echo, this
+ *  holds the status messages queued from the HID report callback, so it is sized for a whole typing report.
+ */
+static uint8_t      REPLtoUSB_Buffer_Data[CDC_TXRX_EPSIZE * 4];
+
+/** State of the data path of the virtual serial port, kept with \ref VirtualSerial_CDC_Interface. */
+static CDCPipe_t    VirtualSerial_Pipe;
+
+/** Flag set while the host has the virtual serial port open, as indicated by the DTR control line. Data is only
+ *  sent while it is set, so that nothing waits on the CDC endpoint while no terminal is reading it.
+ */
+static volatile bool HostReady;
+
+/** Read cursor over the slot being typed, advanced as keys are typed via the HID interface. */
+static SecretStream_t SecretStream;
+
+/** Encoder packing the keys of \ref SecretStream into keyboard reports. */
+static ReportEncoder_t SecretEncoder;
+
+/** Minimum time in milliseconds between two changes of the keyboard report while typing. The host never takes
+ *  reports faster than it polls the keyboard endpoint, so values up to \ref KEYBOARD_POLLING_INTERVAL_MS leave
+ *  typing running at the full polling rate.
+ */
+static uint8_t KeyboardReportIntervalMS = KEYBOARD_POLLING_INTERVAL_MS;
+
+/** Milliseconds since the keyboard report last changed, counted by the SOF event and saturating at 255. */
+static volatile uint8_t KeyboardReportElapsedMS;
+
+/** Milliseconds spent typing the current secret so far, counted by the SOF event while \ref TypingTimed is set. */
+static volatile uint16_t TypingDurationMS;
+
+/** Flag set from the first keystroke of the secret until its typing statistics have been sent. */
+static volatile bool TypingTimed;
+
+/** Flag set once the typing statistics of the current secret have been sent to the host. */
+static bool TypingStatsSent;
+
+/** Flag set from a press of HWB until the secret has been typed to the end and the keys released. */
+static bool TypingActive;
+
+/** Time at which the gesture which started typing completed, on the millisecond clock of the HWB driver. */
+static uint16_t TypingStartTime;
+
+/** Milliseconds from the completion of the gesture to the first keyboard report of the secret. */
+static uint16_t TypingLatencyMS;
+
+/** Decoder turning the presses of HWB into gestures. */
+static GestureDecoder_t HWBGestures;
+
+/** Secret slot typed for each gesture of HWB, or \ref GESTURE_NO_SLOT for gestures which do nothing. A gesture
+ *  whose slot is in none of the stores does nothing either.
+ */
+static const uint8_t GestureSlots[GESTURE_COUNT] PROGMEM =
+	{
+		[GESTURE_NONE]   = GESTURE_NO_SLOT,
+		[GESTURE_SHORT]  = 0,
+		[GESTURE_DOUBLE] = 1,
+		[GESTURE_TRIPLE] = 2,
+		[GESTURE_LONG]   = 3,
+	};
+
+/** Command console run over the virtual serial port. */
+static Console_t SecureKeyConsole;
+
+/** Commands of \ref SecureKeyConsole, besides the built in \c help. */
+static const ConsoleCommand_t ConsoleCommands[] PROGMEM =
+	{
+		{ .Name = "list",    .Help = "List the secret slots",          .Run = ListCommand        },
+		{ .Name = "type",    .Help = "Type a slot: type <slot|name>",  .Run = TypeCommand        },
+		{ .Name = "store",   .Help = "Store a slot: store <n> <hex>",  .Run = StoreCommand       },
+		{ .Name = "erase",   .Help = "Erase a stored slot: erase <n>", .Run = EraseCommand       },
+		{ .Name = "fbegin",  .Help = "Flash slot: fbegin <n> <len>",   .Run = FlashBeginCommand  },
+		{ .Name = "fdata",   .Help = "Flash slot data: fdata <hex>",   .Run = FlashDataCommand   },
+		{ .Name = "ferase",  .Help = "Erase flash slot: ferase <n>",   .Run = FlashEraseCommand  },
+		{ .Name = "fformat", .Help = "Erase every flash slot",         .Run = FlashFormatCommand },
+		{ .Name = "prov",    .Help = "Binary provisioning session",    .Run = ProvisionCommand   },
+		{ .Name = "paste",   .Help = "Type text until Ctrl-D",         .Run = PasteCommand       },
+		{ .Name = "loop",    .Help = "Echo data until port closes",    .Run = LoopCommand        },
+		{ .Name = "layout",  .Help = "Host layout: layout [us|de|..]", .Run = LayoutCommand      },
+		{ .Name = "delay",   .Help = "Key report gap: delay [ms]",     .Run = DelayCommand       },
+	#if defined(CYCLE_PROBES)
+		{ .Name = "stats",   .Help = "Probe cycles: stats [clear]",    .Run = StatsCommand       },
+	#endif
+	#if defined(PC_PROFILER)
+		{ .Name = "prof",    .Help = "Profile: prof [clear|hex sh]",   .Run = ProfileCommand     },
+	#endif
+	};
 
-/** Circular buffer to hold data from the keystorage before it is sent to the device via the HID. */
-static RingBuffer_t Secret2USB_Buffer;
+/** Paste of host text run by the \c paste command. */
+static Paste_t PastePipe;
 
-/** Underlying data buffer for \ref Secret2USB_Buffer, where the stored bytes are located. */
-static uint8_t      Secret2USB_Buffer_Data[32];
+/** Binary provisioning session run by the \c prov command. */
+static Provision_t Provisioner;
+
+/** Number of bytes decoded from the hex of the running \c fdata command. */
+static uint8_t FlashDataLength;
+
+/** Number of bytes of the running \c fdata command taken by the FLASH store so far. */
+static uint8_t FlashDataTaken;
 
 /** Buffer to hold the previously generated Keyboard HID report, for comparison purposes inside the HID class driver. */
 static uint8_t PrevKeyboardHIDReportBuffer[sizeof(USB_KeyboardReport_Data_t)];
 
+/** Flag set while the HID class driver handles a control request. With \c INTERRUPT_CONTROL_ENDPOINT this runs from
+ *  the USB interrupt, which can break into the keyboard task anywhere, so a GET_REPORT request is only answered with
+ *  the report last sent and typing is advanced by the keyboard task alone.
+ */
+static volatile bool HIDControlRequest;
+
+/** Task table of the main loop, in priority order. The USB management and the virtual serial data path run on every
+ *  pass so that control requests and CDC throughput are never held up; the class driver tasks only have work once per
+ *  USB frame, so they run on the millisecond tick. Gestures are decoded ahead of the keyboard, so that typing starts
+ *  on the same tick as the gesture completes. The EEPROM store also runs on every pass, so that each byte of a record
+ *  is started as soon as the previous one has been programmed, and the FLASH store takes one page
+ *  operation per pass, during which interrupts are held off.
+ */
+static const SchedulerTask_t SecureKeyTasks[] PROGMEM =
+	{
+		{ .Run = USBManagement_Task,   .PeriodMS = 0                      },
+		{ .Run = Gesture_Task,         .PeriodMS = 1,    .DeadlineMS = 1  },
+		{ .Run = Keyboard_Task,        .PeriodMS = 1,    .DeadlineMS = 1  },
+		{ .Run = VirtualSerial_Task,   .PeriodMS = 1,    .DeadlineMS = 1  },
+		{ .Run = REPL_Task,            .PeriodMS = 0                      },
+		{ .Run = StatusLED_Task,       .PeriodMS = 1,    .DeadlineMS = 10 },
+		{ .Run = EEPROMStore_Task,     .PeriodMS = 0                      },
+		{ .Run = FlashStore_Task,      .PeriodMS = 0                      },
+	#if defined(SCHEDULER_REPORT)
+		{ .Run = SchedulerReport_Task, .PeriodMS = SCHEDULER_REPORT_PERIOD_MS, .DeadlineMS = SCHEDULER_REPORT_PERIOD_MS },
+	#endif
+	};
+
+_Static_assert((sizeof(SecureKeyTasks) / sizeof(SecureKeyTasks[0])) <= SCHEDULER_MAX_TASKS,
+               "SecureKeyTasks has more tasks than SCHEDULER_MAX_TASKS");
+
 /** LUFA HID Class driver interface configuration and state information. This structure is
  *  passed to all HID Class driver functions, so that multiple instances of the same class
  *  within a device can be differentiated from one another.
@@ -78,7 +198,7 @@ USB_ClassInfo_HID_Device_t Keyboard_HID_Interface =
 					{
 						.Address              = KEYBOARD_EPADDR,
 						.Size                 = KEYBOARD_EPSIZE,
-						.Banks                = 1,
+						.Banks                = KEYBOARD_EPBANKS,
 					},
 				.PrevReportINBuffer           = PrevKeyboardHIDReportBuffer,
 				.PrevReportINBufferSize       = sizeof(PrevKeyboardHIDReportBuffer),
@@ -98,19 +218,19 @@ USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
 					{
 						.Address          = CDC_TX_EPADDR,
 						.Size             = CDC_TXRX_EPSIZE,
-						.Banks            = 1,
+						.Banks            = CDC_TXRX_EPBANKS,
 					},
 				.DataOUTEndpoint =
 					{
 						.Address          = CDC_RX_EPADDR,
 						.Size             = CDC_TXRX_EPSIZE,
-						.Banks            = 1,
+						.Banks            = CDC_TXRX_EPBANKS,
 					},
 				.NotificationEndpoint =
 					{
 						.Address          = CDC_NOTIFICATION_EPADDR,
 						.Size             = CDC_NOTIFICATION_EPSIZE,
-						.Banks            = 1,
+						.Banks            = CDC_NOTIFICATION_EPBANKS,
 					},
 			},
 	};
@@ -121,32 +241,189 @@ USB_ClassInfo_CDC_Device_t VirtualSerial_CDC_Interface =
 int main(void)
 {
 	SetupHardware();
+	EEPROMStore_Init();
+	FlashStore_Init();
 
 	RingBuffer_InitBuffer(&USBtoREPL_Buffer, USBtoREPL_Buffer_Data, sizeof(USBtoREPL_Buffer_Data));
 	RingBuffer_InitBuffer(&REPLtoUSB_Buffer, REPLtoUSB_Buffer_Data, sizeof(REPLtoUSB_Buffer_Data));
 
-	RingBuffer_InitBuffer(&Secret2USB_Buffer, Secret2USB_Buffer_Data, sizeof(Secret2USB_Buffer_Data));
-	uint16_t SecLen = sizeof(secret) / sizeof(secret[0]);
-	uint16_t SecCnt = SecLen;
+	Console_Init(&SecureKeyConsole, ConsoleCommands, (sizeof(ConsoleCommands) / sizeof(ConsoleCommands[0])));
+
+	Scheduler_Init(SecureKeyTasks, (sizeof(SecureKeyTasks) / sizeof(SecureKeyTasks[0])));
+
+#if defined(PC_PROFILER)
+	Profiler_Init();
+#endif
 
-	while (SecCnt--) {
-		key_t currentKey = (key_t)secret[SecLen-SecCnt];
-		RingBuffer_Insert(&Secret2USB_Buffer, currentKey.key);
-    }
 	GlobalInterruptEnable();
 
 	for (;;)
+	  Scheduler_RunTasks();
+}
+
+/** Task to manage the USB device state and service control requests on the default control endpoint. */
+void USBManagement_Task(void)
+{
+	PROBE_BEGIN(PROBE_USBTask);
+	USB_USBTask();
+	PROBE_END(PROBE_USBTask);
+}
+
+/** Task to decode the gestures of HWB from its queued events and the passing of time, starting to type the slot
+ *  mapped to each completed gesture.
+ */
+void Gesture_Task(void)
+{
+	hwb_event_t Event;
+
+	while (hwb_get_event(&Event))
+	  TypeGesture(Gesture_ProcessEvent(&HWBGestures, &Event));
+
+	TypeGesture(Gesture_ProcessTimeout(&HWBGestures, hwb_millis()));
+}
+
+/** Starts typing the secret slot mapped to a gesture, if there is one.
+ *
+ *  \param[in] Gesture  Gesture completed by HWB, a value from \ref Gesture_t
+ */
+void TypeGesture(const uint8_t Gesture)
+{
+	if (Gesture == GESTURE_NONE)
+	  return;
+
+	uint8_t Slot = pgm_read_byte(&GestureSlots[Gesture]);
+
+	if (Slot != GESTURE_NO_SLOT)
+	  TypeSlot(Slot);
+}
+
+/** Starts typing a secret slot from the start, unless a secret is still being typed, in which case it runs on to the
+ *  end, or a record is being written to the EEPROM or FLASH store. A slot held in the EEPROM store takes the place of
+ *  the FLASH and vault slots of the same index, and a slot held in the FLASH store that of the vault. In benchmark builds the benchmark corpus is typed instead, one run per call.
+ *
+ *  \param[in] Slot  Index of the slot to type
+ *
+ *  \return Boolean \c true if typing was started, \c false if the slot does not exist or typing is in progress
+ */
+bool TypeSlot(const uint8_t Slot)
+{
+	/* Reads of the EEPROM stall until a write has finished, and page operations of the FLASH store hold off interrupts,
+	   so typing waits for both stores */
+	if (TypingActive || EEPROMStore_IsBusy() || FlashStore_IsBusy() || Provision_IsActive(&Provisioner))
+	  return false;
+
+#if defined(TYPING_BENCHMARK)
+	if (TypingStatsSent)
+	  NextBenchmarkRun();
+
+	SecretStream_Open(&SecretStream, BenchmarkCorpus, BENCHMARK_CORPUS_LENGTH);
+#else
+	if (!(EEPROMStore_OpenSlot(&SecretStream, Slot)) && !(FlashStore_OpenSlot(&SecretStream, Slot)) &&
+	    !(Vault_OpenSlot(&SecretStream, Slot)))
+	{
+		return false;
+	}
+#endif
+
+	StartTyping();
+
+	char Message[24];
+
+	/* Only queued here; the main loop sends it once the host is listening, so typing never waits on CDC */
+	snprintf_P(Message, sizeof(Message), PSTR("Typing slot %u\r\n"), Slot);
+	CDCPipe_QueueString(&REPLtoUSB_Buffer, Message);
+
+	return true;
+}
+
+/** Starts typing from \ref SecretStream, once it has been opened, clearing the typing statistics. */
+void StartTyping(void)
+{
+	ReportEncoder_ClearCounters(&SecretEncoder);
+	TypingDurationMS = 0;
+	TypingStatsSent  = false;
+	TypingActive     = true;
+	TypingStartTime  = hwb_millis();
+	TypingLatencyMS  = 0;
+
+	led_blue_fast_heartbeat();
+}
+
+/** Gives the number of secret slots, those of the vault and any stored in EEPROM or FLASH beyond them.
+ *
+ *  \return Number of slots, some of which may be missing if the EEPROM store has gaps past the vault
+ */
+uint8_t GetSlotCount(void)
+{
+	uint8_t SlotCount = Vault_GetSlotCount();
+
+	for (uint8_t Slot = SlotCount; Slot < EEPROM_STORE_MAX_SLOTS; Slot++)
 	{
-		/* Echo all received data on the second CDC interface */
-		int16_t ReceivedByte = CDC_Device_ReceiveByte(&VirtualSerial_CDC_Interface);
-		if (!(ReceivedByte < 0))
-			CDC_Device_SendByte(&VirtualSerial_CDC_Interface, (uint8_t)ReceivedByte);
+		if (EEPROMStore_HasSlot(Slot) || FlashStore_HasSlot(Slot))
+		  SlotCount = (Slot + 1);
+	}
+
+	return SlotCount;
+}
+
+/** Task to run the HID class driver, which collects a new keyboard report from the report callback each frame. */
+void Keyboard_Task(void)
+{
+	PROBE_BEGIN(PROBE_HIDTask);
+	HID_Device_USBTask(&Keyboard_HID_Interface);
+	PROBE_END(PROBE_HIDTask);
+}
+
+/** Task to run the CDC class driver for the virtual serial port. */
+void VirtualSerial_Task(void)
+{
+	PROBE_BEGIN(PROBE_CDCTask);
+	CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
+	PROBE_END(PROBE_CDCTask);
+}
+
+/** Task to move data between the virtual serial port and the REPL, which runs the command console. */
+void REPL_Task(void)
+{
+	CDCPipe_Receive(&VirtualSerial_CDC_Interface, &USBtoREPL_Buffer);
+
+	Console_Task(&SecureKeyConsole, &USBtoREPL_Buffer, &REPLtoUSB_Buffer);
+
+	if (HostReady)
+	  CDCPipe_Send(&VirtualSerial_CDC_Interface, &VirtualSerial_Pipe, &REPLtoUSB_Buffer);
+}
+
+/** Task to play the patterns of the status LEDs, which advance by a millisecond on each run. */
+void StatusLED_Task(void)
+{
+	led_tick();
+}
+
+#if defined(SCHEDULER_REPORT)
+/** Task to queue the run-time accounting of the scheduler tasks for the host, one task per run so that a report
+ *  never needs more room in \ref REPLtoUSB_Buffer than a single line.
+ */
+void SchedulerReport_Task(void)
+{
+	static uint8_t Task;
+
+	const SchedulerTaskStats_t* Stats = Scheduler_GetTaskStats(Task);
+	char     Message[80];
+	uint16_t MeanCycles = (Stats->Runs ? (uint16_t)(Stats->TotalCycles / Stats->Runs) : 0);
+
+	snprintf_P(Message, sizeof(Message), PSTR("Task %u: %u runs, %u late, %u mean / %u max cycles\r\n"),
+	           Task, Stats->Runs, Stats->LateRuns, MeanCycles, Stats->MaxCycles);
 
-		CDC_Device_USBTask(&VirtualSerial_CDC_Interface);
-		HID_Device_USBTask(&Keyboard_HID_Interface);
-		USB_USBTask();
+	if (!(CDCPipe_QueueString(&REPLtoUSB_Buffer, Message)))
+	  return;
+
+	if (++Task == (sizeof(SecureKeyTasks) / sizeof(SecureKeyTasks[0])))
+	{
+		Task = 0;
+		Scheduler_ClearTaskStats();
 	}
 }
+#endif
 
 /** Configures the board hardware and chip peripherals for the demo's functionality. */
 void SetupHardware()
@@ -164,6 +441,7 @@ void SetupHardware()
 	ALL_OFF;
 	LED_EN;
 	HWBIN_EN;
+	hwb_init();
 	USB_Init();
 }
 
@@ -194,21 +472,737 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 		led_red(0);
 		led_blue(1);
 	}
+	else
+	{
+		led_red_heartbeat();
+	}
 }
 
 /** Event handler for the library USB Control Request reception event. */
 void EVENT_USB_Device_ControlRequest(void)
 {
 	CDC_Device_ProcessControlRequest(&VirtualSerial_CDC_Interface);
+
+	HIDControlRequest = true;
 	HID_Device_ProcessControlRequest(&Keyboard_HID_Interface);
+	HIDControlRequest = false;
 }
 
 /** Event handler for the USB device Start Of Frame event. */
 void EVENT_USB_Device_StartOfFrame(void)
 {
+	PROBE_BEGIN(PROBE_SOF);
+
+	Scheduler_Tick();
+	hwb_tick();
 	HID_Device_MillisecondElapsed(&Keyboard_HID_Interface);
+
+	if (KeyboardReportElapsedMS != 0xFF)
+	  KeyboardReportElapsedMS++;
+
+	if (TypingTimed)
+	  TypingDurationMS++;
+
+	PROBE_END(PROBE_SOF);
+}
+
+#if defined(TYPING_BENCHMARK)
+/** Prepares the next benchmark run once the previous one has been reported, lengthening the interval between
+ *  keyboard reports by a millisecond each run so that a sweep of runs shows the fastest rate a host keeps up with.
+ */
+void NextBenchmarkRun(void)
+{
+	if (KeyboardReportIntervalMS < TYPING_BENCHMARK_MAX_INTERVAL_MS)
+	  KeyboardReportIntervalMS++;
+	else
+	  KeyboardReportIntervalMS = KEYBOARD_POLLING_INTERVAL_MS;
+}
+#endif
+
+/** Queues the typing throughput counters of \ref SecretEncoder for the host on the CDC interface, along with
+ *  the two reports per key that typing costs when every keystroke is followed by a release, and the achieved
+ *  typing rate at the current report interval and the time from the gesture on HWB to the first report.
+ */
+void QueueTypingStats(void)
+{
+	char     Message[112];
+	uint16_t Keys       = SecretEncoder.TypedKeys;
+	uint16_t Reports    = SecretEncoder.TypedReports;
+	uint16_t DurationMS = TypingDurationMS;
+	uint16_t PerKey     = (uint16_t)(((uint32_t)Reports * 100) / (Keys ? Keys : 1));
+	uint16_t KeysPerSec = (uint16_t)(((uint32_t)Keys * 1000) / (DurationMS ? DurationMS : 1));
+
+	snprintf_P(Message, sizeof(Message),
+	           PSTR("Typed %u keys in %u reports, %u ms at %u ms/report: %u.%02u reports/key (2.00 unelided), %u keys/s\r\n"),
+	           Keys, Reports, DurationMS, KeyboardReportIntervalMS, (PerKey / 100), (PerKey % 100), KeysPerSec);
+	CDCPipe_QueueString(&REPLtoUSB_Buffer, Message);
+
+	snprintf_P(Message, sizeof(Message), PSTR("First report %u ms after gesture\r\n"), TypingLatencyMS);
+	CDCPipe_QueueString(&REPLtoUSB_Buffer, Message);
+}
+
+/** Console command handler listing the secret slots, one slot per step. Slots held in the EEPROM or FLASH store are
+ *  marked with the store they are typed from, and slots with no name in the vault are listed as \c -.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once every slot has been listed
+ */
+bool ListCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	uint8_t SlotCount = GetSlotCount();
+	char    Name[VAULT_NAME_MAX + 1];
+	char    Message[CONSOLE_OUTPUT_RESERVE];
+
+	if (!(SlotCount))
+	  return Console_QueueMessage_P(Output, PSTR("No slots"));
+
+	if (!(Vault_GetSlotName(Console->Step, Name, sizeof(Name))))
+	  strcpy_P(Name, PSTR("-"));
+
+	const char* Store = PSTR("");
+
+	if (EEPROMStore_HasSlot(Console->Step))
+	  Store = PSTR(" (eeprom)");
+	else if (FlashStore_HasSlot(Console->Step))
+	  Store = PSTR(" (flash)");
+
+	snprintf_P(Message, sizeof(Message), PSTR("%3u %s%S\r\n"), Console->Step, Name, Store);
+	CDCPipe_QueueString(Output, Message);
+
+	return ((Console->Step + 1) >= SlotCount);
+}
+
+/** Console command handler typing a secret slot given by its index or name.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the command
+ *
+ *  \return Boolean \c true, as the command completes in a single step
+ */
+bool TypeCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	const char* Args = Console->Args;
+	uint16_t    Slot;
+
+	if ((*Args >= '0') && (*Args <= '9'))
+	{
+		const char* Next = Console_ParseNumber(Args, &Slot);
+
+		if (!(Next) || *Next)
+		{
+			Console_QueueMessage_P(Output, PSTR("Usage: type <slot|name>"));
+			return true;
+		}
+	}
+	else
+	{
+		Slot = Vault_FindSlot(Args);
+
+		/* A name missing from the vault must not be taken as the slot after the last vault slot */
+		if (Slot == Vault_GetSlotCount())
+		  Slot = UINT16_MAX;
+	}
+
+	if (TypingActive || EEPROMStore_IsBusy() || FlashStore_IsBusy())
+	  Console_QueueMessage_P(Output, PSTR("Busy"));
+	else if ((Slot > UINT8_MAX) || !(TypeSlot(Slot)))
+	  Console_QueueMessage_P(Output, PSTR("No such slot"));
+
+	return true;
+}
+
+/** Starts writing a record to the EEPROM store for the \c store and \c erase commands, reporting why if it could not
+ *  be started.
+ *
+ *  \param[in,out] Output  Ring buffer for the output of the command
+ *  \param[in]     Slot    Slot of the record
+ *  \param[in]     Data    Packed secret of the record, which must stay in place until the write has finished
+ *  \param[in]     Length  Length of the packed secret in bytes, or zero to erase the slot
+ *
+ *  \return Boolean \c true if the write was started, \c false if the command has failed
+ */
+bool StartStoreWrite(RingBuffer_t* const Output, const uint8_t Slot, const uint8_t* const Data, const uint8_t Length)
+{
+	/* A slot being typed must not have its blocks freed and reused under the reader */
+	if (TypingActive)
+	{
+		Console_QueueMessage_P(Output, PSTR("Busy typing"));
+		return false;
+	}
+
+	switch (EEPROMStore_Write(Slot, Data, Length))
+	{
+		case EEPROM_STORE_WRITE_Started:
+			return true;
+		case EEPROM_STORE_WRITE_Busy:
+			Console_QueueMessage_P(Output, PSTR("Busy"));
+			break;
+		case EEPROM_STORE_WRITE_BadSlot:
+			Console_QueueMessage_P(Output, PSTR("No such slot"));
+			break;
+		case EEPROM_STORE_WRITE_Full:
+			Console_QueueMessage_P(Output, PSTR("EEPROM full"));
+			break;
+	}
+
+	return false;
+}
+
+/** Waits, a step at a time, for the write started by the \c store and \c erase commands to finish, then reports the
+ *  space left in the EEPROM store.
+ *
+ *  \param[in,out] Output  Ring buffer for the output of the command
+ *
+ *  \return Boolean \c true once the write has finished
+ */
+bool FinishStoreWrite(RingBuffer_t* const Output)
+{
+	if (EEPROMStore_IsBusy())
+	  return false;
+
+	char Message[CONSOLE_OUTPUT_RESERVE];
+
+	snprintf_P(Message, sizeof(Message), PSTR("Done, %u of %u blocks free\r\n"),
+	           EEPROMStore_GetFreeBlocks(), EEPROM_STORE_BLOCKS);
+	CDCPipe_QueueString(Output, Message);
+	return true;
+}
+
+/** Console command handler storing a packed secret, given in hex, to a slot of the EEPROM store. The hex digits are
+ *  decoded in place in the console line, which is left alone while the command runs, and written from there in the
+ *  background over the following steps.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once the record has been written or the command has failed
+ */
+bool StoreCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	if (Console->Step)
+	  return FinishStoreWrite(Output);
+
+	uint16_t Slot;
+	uint8_t  Length;
+
+	/* The hex digits are within the console line, which is left alone while the command runs */
+	char*    Hex = (char*)Console_ParseNumber(Console->Args, &Slot);
+
+	if (!(Hex) || !(*Hex) || !(Console_DecodeHex(Hex, &Length)))
+	{
+		Console_QueueMessage_P(Output, PSTR("Usage: store <slot> <hex>"));
+		return true;
+	}
+
+	if (Slot >= EEPROM_STORE_MAX_SLOTS)
+	{
+		Console_QueueMessage_P(Output, PSTR("No such slot"));
+		return true;
+	}
+
+	return !(StartStoreWrite(Output, Slot, (const uint8_t*)Hex, Length));
+}
+
+/** Console command handler erasing a slot of the EEPROM store, so that the vault slot of the same index, if any, is
+ *  typed again.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once the erasure has been written or the command has failed
+ */
+bool EraseCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	if (Console->Step)
+	  return FinishStoreWrite(Output);
+
+	uint16_t    Slot;
+	const char* Next = Console_ParseNumber(Console->Args, &Slot);
+
+	if (!(Next) || *Next)
+	  Console_QueueMessage_P(Output, PSTR("Usage: erase <slot>"));
+	else if (Slot >= EEPROM_STORE_MAX_SLOTS)
+	  Console_QueueMessage_P(Output, PSTR("No such slot"));
+	else if (!(EEPROMStore_HasSlot(Slot)))
+	  Console_QueueMessage_P(Output, PSTR("Not stored"));
+	else
+	  return !(StartStoreWrite(Output, Slot, NULL, 0));
+
+	return true;
+}
+
+/** Reports why an operation of the FLASH store could not be started, for the FLASH store commands.
+ *
+ *  \param[in,out] Output  Ring buffer for the output of the command
+ *  \param[in]     Result  Result of the operation, a value from \ref FlashStoreResults_t
+ *
+ *  \return Boolean \c true if the operation was started, \c false if the command has failed
+ */
+bool CheckFlashResult(RingBuffer_t* const Output, const uint8_t Result)
+{
+	switch (Result)
+	{
+		case FLASH_STORE_Started:
+			return true;
+		case FLASH_STORE_Busy:
+			Console_QueueMessage_P(Output, PSTR("Busy"));
+			break;
+		case FLASH_STORE_BadSlot:
+			Console_QueueMessage_P(Output, PSTR("No such slot"));
+			break;
+		case FLASH_STORE_Full:
+			Console_QueueMessage_P(Output, PSTR("Flash full, fformat to reclaim"));
+			break;
+		case FLASH_STORE_NoBootloader:
+			Console_QueueMessage_P(Output, PSTR("Bootloader cannot write flash"));
+			break;
+	}
+
+	return false;
+}
+
+/** Waits, a step at a time, for the FLASH store to finish a record or a format, then reports the space left in it.
+ *
+ *  \param[in,out] Output  Ring buffer for the output of the command
+ *
+ *  \return Boolean \c true once the FLASH store is idle
+ */
+bool FinishFlashWrite(RingBuffer_t* const Output)
+{
+	if (FlashStore_IsOpen() || FlashStore_IsBusy())
+	  return false;
+
+	char Message[CONSOLE_OUTPUT_RESERVE];
+
+	snprintf_P(Message, sizeof(Message), PSTR("Done, %u of %u pages free\r\n"),
+	           FlashStore_GetFreePages(), FLASH_STORE_PAGES);
+	CDCPipe_QueueString(Output, Message);
+	return true;
+}
+
+/** Console command handler starting a record of the FLASH store, whose packed secret then follows in as many
+ *  \c fdata commands as it needs.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the command
+ *
+ *  \return Boolean \c true, as the command completes in a single step
+ */
+bool FlashBeginCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	uint16_t    Slot;
+	uint16_t    Length = 0;
+	const char* Next   = Console_ParseNumber(Console->Args, &Slot);
+
+	if (Next)
+	  Next = Console_ParseNumber(Next, &Length);
+
+	/* Page operations hold off interrupts, which would stall the keyboard reports */
+	if (TypingActive)
+	  Console_QueueMessage_P(Output, PSTR("Busy typing"));
+	else if (!(Next) || *Next || !(Length))
+	  Console_QueueMessage_P(Output, PSTR("Usage: fbegin <slot> <length>"));
+	else if (Slot >= FLASH_STORE_MAX_SLOTS)
+	  Console_QueueMessage_P(Output, PSTR("No such slot"));
+	else if (Length > FLASH_STORE_MAX_LENGTH)
+	  Console_QueueMessage_P(Output, PSTR("Too long for the flash store"));
+	else
+	  CheckFlashResult(Output, FlashStore_Begin(Slot, Length));
+
+	return true;
+}
+
+/** Console command handler giving the next part of the packed secret of a FLASH store record, in hex. The hex digits
+ *  are decoded in place in the console line, and handed to the store over as many steps as it takes to program the
+ *  pages they fill. After the last part, the command waits for the record to be complete.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once the store has taken all of the data or the command has failed
+ */
+bool FlashDataCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	/* The arguments are within the console line, which is left alone while the command runs */
+	char* Hex = (char*)Console->Args;
+
+	if (!(Console->Step))
+	{
+		if (TypingActive)
+		{
+			Console_QueueMessage_P(Output, PSTR("Busy typing"));
+			return true;
+		}
+
+		if (!(FlashStore_GetRemaining()))
+		{
+			Console_QueueMessage_P(Output, PSTR("No flash slot started"));
+			return true;
+		}
+
+		if (!(*Hex) || !(Console_DecodeHex(Hex, &FlashDataLength)) || (FlashDataLength > FlashStore_GetRemaining()))
+		{
+			Console_QueueMessage_P(Output, PSTR("Usage: fdata <hex>"));
+			return true;
+		}
+
+		FlashDataTaken = 0;
+	}
+
+	if (FlashDataTaken < FlashDataLength)
+	{
+		FlashDataTaken += FlashStore_Write((const uint8_t*)&Hex[FlashDataTaken], (FlashDataLength - FlashDataTaken));
+		return false;
+	}
+
+	return (FlashStore_GetRemaining() || FinishFlashWrite(Output));
+}
+
+/** Console command handler erasing a slot of the FLASH store, so that the vault slot of the same index, if any, is
+ *  typed again.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once the erasure has been programmed or the command has failed
+ */
+bool FlashEraseCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	if (Console->Step)
+	  return FinishFlashWrite(Output);
+
+	uint16_t    Slot;
+	const char* Next = Console_ParseNumber(Console->Args, &Slot);
+
+	if (!(Next) || *Next)
+	{
+		Console_QueueMessage_P(Output, PSTR("Usage: ferase <slot>"));
+		return true;
+	}
+
+	if (Slot >= FLASH_STORE_MAX_SLOTS)
+	{
+		Console_QueueMessage_P(Output, PSTR("No such slot"));
+		return true;
+	}
+
+	if (!(FlashStore_HasSlot(Slot)))
+	{
+		Console_QueueMessage_P(Output, PSTR("Not stored"));
+		return true;
+	}
+
+	if (TypingActive)
+	{
+		Console_QueueMessage_P(Output, PSTR("Busy typing"));
+		return true;
+	}
+
+	return !(CheckFlashResult(Output, FlashStore_Begin(Slot, 0)));
+}
+
+/** Console command handler erasing the whole FLASH store, to give back the space of superseded records.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once the store has been erased or the command has failed
+ */
+bool FlashFormatCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	if (Console->Step)
+	  return FinishFlashWrite(Output);
+
+	if (TypingActive)
+	{
+		Console_QueueMessage_P(Output, PSTR("Busy typing"));
+		return true;
+	}
+
+	return !(CheckFlashResult(Output, FlashStore_Format()));
+}
+
+/** Console command handler running a binary provisioning session, which takes over the virtual serial port until
+ *  the host ends it or closes the port. Frames are decoded into the console line, which is left alone while the
+ *  command runs, and written from there to the stores.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once the session has ended
+ */
+bool ProvisionCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	if (!(Console->Step))
+	{
+		if (TypingActive)
+		{
+			Console_QueueMessage_P(Output, PSTR("Busy typing"));
+			return true;
+		}
+
+		Provision_Begin(&Provisioner, (uint8_t*)Console->Line, sizeof(Console->Line));
+	}
+
+	/* With the port closed there is no host left to end the session */
+	if (!(HostReady))
+	{
+		Provision_Abort(&Provisioner);
+		return true;
+	}
+
+	return Provision_Task(&Provisioner, &USBtoREPL_Buffer, Output);
+}
+
+/** Console command handler typing the text the host sends next over the virtual serial port, until Ctrl-D or the
+ *  closing of the port. Characters are turned into keys as they arrive and queued in the console line, which is left
+ *  alone while the command runs, and the host is held off while the queue is full.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once the pasted text has been typed
+ */
+bool PasteCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	if (!(Console->Step))
+	{
+		if (TypingActive)
+		{
+			Console_QueueMessage_P(Output, PSTR("Busy typing"));
+			return true;
+		}
+
+		Paste_Begin(&PastePipe, (uint8_t*)Console->Line, sizeof(Console->Line), &SecretStream);
+		StartTyping();
+
+		Console_QueueMessage_P(Output, PSTR("Pasting, Ctrl-D ends"));
+		return false;
+	}
+
+	/* With the port closed there is no host left to end the paste, so what was queued is typed out */
+	if (!(HostReady))
+	  Paste_End(&PastePipe);
+
+	Paste_Task(&PastePipe, &USBtoREPL_Buffer);
+
+	return !(TypingActive);
+}
+
+/** Console command handler echoing everything the host sends back to it unchanged, until the port is closed, for
+ *  Tools/cdc-loopback.py to measure the throughput of the virtual serial port. Each step moves as much as the output
+ *  buffer has room for, so the host is held off by the receive path while the echo is not read.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the step
+ *
+ *  \return Boolean \c true once the port has been closed
+ */
+bool LoopCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	if (!(Console->Step))
+	{
+		Console_QueueMessage_P(Output, PSTR("Echoing until the port closes"));
+		return false;
+	}
+
+	/* Whatever is left of the data is dropped rather than run as commands once the port is opened again */
+	if (!(HostReady))
+	{
+		RingBuffer_InitBuffer(&USBtoREPL_Buffer, USBtoREPL_Buffer_Data, sizeof(USBtoREPL_Buffer_Data));
+		return true;
+	}
+
+	uint16_t Count     = RingBuffer_GetCount(&USBtoREPL_Buffer);
+	uint16_t FreeCount = RingBuffer_GetFreeCount(Output);
+
+	while (Count && FreeCount)
+	{
+		RingBuffer_Insert(Output, RingBuffer_Remove(&USBtoREPL_Buffer));
+
+		Count--;
+		FreeCount--;
+	}
+
+	return false;
 }
 
+/** Console command handler selecting the keyboard layout of the host, which pasted text is translated for, or
+ *  showing the selected layout when given none. Secrets are packed for a layout on the host, and are not affected.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the command
+ *
+ *  \return Boolean \c true, as the command completes in a single step
+ */
+bool LayoutCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	char    Message[CONSOLE_OUTPUT_RESERVE];
+	uint8_t Layout;
+
+	if (*Console->Args)
+	{
+		if (!(Keymap_FindLayout(Console->Args, &Layout)))
+		  return Console_QueueMessage_P(Output, PSTR("Layouts: us uk de fr"));
+
+		Keymap_SetLayout(Layout);
+	}
+
+	snprintf_P(Message, sizeof(Message), PSTR("Layout %S\r\n"), Keymap_GetLayoutName(Keymap_GetLayout()));
+	CDCPipe_QueueString(Output, Message);
+
+	return true;
+}
+
+/** Console command handler setting the minimum time between two changes of the keyboard report while typing, or
+ *  showing it when given none. A fast polling build types a key change per frame, which some hosts and KVM switches
+ *  drop keys at, so it can be slowed down here without a rebuild. The interval is not changed while typing.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the command
+ *
+ *  \return Boolean \c true, as the command completes in a single step
+ */
+bool DelayCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	char Message[CONSOLE_OUTPUT_RESERVE];
+
+	if (*Console->Args)
+	{
+		uint16_t    IntervalMS;
+		const char* Next = Console_ParseNumber(Console->Args, &IntervalMS);
+
+		if (!(Next) || *Next || (IntervalMS > TYPING_BENCHMARK_MAX_INTERVAL_MS))
+		{
+			snprintf_P(Message, sizeof(Message), PSTR("Usage: delay [0-%u]\r\n"), TYPING_BENCHMARK_MAX_INTERVAL_MS);
+			CDCPipe_QueueString(Output, Message);
+			return true;
+		}
+
+		if (TypingActive)
+		  return Console_QueueMessage_P(Output, PSTR("Busy typing"));
+
+		KeyboardReportIntervalMS = IntervalMS;
+	}
+
+	snprintf_P(Message, sizeof(Message), PSTR("Report interval %u ms, polled every %u ms\r\n"),
+	           KeyboardReportIntervalMS, KEYBOARD_POLLING_INTERVAL_MS);
+	CDCPipe_QueueString(Output, Message);
+
+	return true;
+}
+
+#if defined(CYCLE_PROBES)
+/** Console command handler listing the shortest, mean and longest cycle counts of each probe point, a line per step,
+ *  and clearing them afterwards when given \c clear.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the command
+ *
+ *  \return Boolean \c true once every probe point has been listed
+ */
+bool StatsCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	char         Message[CONSOLE_OUTPUT_RESERVE];
+	ProbeStats_t Stats;
+
+	if (!(Console->Step))
+	{
+		Console_QueueMessage_P(Output, PSTR("      min  mean   max"));
+		return false;
+	}
+
+	uint8_t Point = (Console->Step - 1);
+
+	Probe_GetStats(Point, &Stats);
+
+	if (Stats.Runs)
+	{
+		snprintf_P(Message, sizeof(Message), PSTR("%-3S %5u %5u %5u\r\n"), Probe_GetName(Point), Stats.MinCycles,
+		           (uint16_t)(Stats.TotalCycles / Stats.Runs), Stats.MaxCycles);
+	}
+	else
+	{
+		snprintf_P(Message, sizeof(Message), PSTR("%-3S     -     -     -\r\n"), Probe_GetName(Point));
+	}
+
+	CDCPipe_QueueString(Output, Message);
+
+	if (Point < (PROBE_COUNT - 1))
+	  return false;
+
+	if (!(strcmp_P(Console->Args, PSTR("clear"))))
+	  Probe_ClearStats();
+
+	return true;
+}
+#endif
+
+#if defined(PC_PROFILER)
+/** Console command handler dumping the histogram of the sampling profiler for Tools/prof-symbols.py: a header line
+ *  with the first address and shift of the bins, the samples taken and those outside the bins, then a line with the
+ *  FLASH address and count of each bin holding samples. Sampling is paused while the histogram is dumped.
+ *
+ *  Given \c clear, the histogram is cleared once dumped; given a hex FLASH address and a shift, the bins are first
+ *  narrowed onto that range, which clears them.
+ *
+ *  \param[in,out] Console  Console running the command
+ *  \param[in,out] Output   Ring buffer for the output of the command
+ *
+ *  \return Boolean \c true once every bin has been dumped
+ */
+bool ProfileCommand(Console_t* const Console, RingBuffer_t* const Output)
+{
+	char            Message[CONSOLE_OUTPUT_RESERVE];
+	ProfilerState_t State;
+
+	if (!(Console->Step))
+	{
+		if (*Console->Args && strcmp_P(Console->Args, PSTR("clear")))
+		{
+			char*    Next;
+			uint16_t Base  = (uint16_t)strtoul(Console->Args, &Next, 16);
+			uint8_t  Shift = (uint8_t)strtoul(Next, NULL, 10);
+
+			if ((Next == Console->Args) || !(Profiler_SetRange(Base, Shift)))
+			  return Console_QueueMessage_P(Output, PSTR("Usage: prof [clear|<hex base> <shift>]"));
+		}
+
+		Profiler_Pause();
+		Profiler_GetState(&State);
+
+		snprintf_P(Message, sizeof(Message), PSTR("prof %04x %u %lu %u%S\r\n"), State.Base, State.Shift,
+		           (unsigned long)State.Samples, State.Other, (State.Full ? PSTR(" full") : PSTR("")));
+		CDCPipe_QueueString(Output, Message);
+
+		return false;
+	}
+
+	uint8_t  Bin   = (Console->Step - 1);
+	uint16_t Count = Profiler_GetBin(Bin);
+
+	if (Count)
+	{
+		Profiler_GetState(&State);
+
+		snprintf_P(Message, sizeof(Message), PSTR("%04x %u\r\n"), (uint16_t)(State.Base + ((uint16_t)Bin << State.Shift)),
+		           Count);
+		CDCPipe_QueueString(Output, Message);
+	}
+
+	if (Bin < (PROFILER_BINS - 1))
+	  return false;
+
+	if (!(strcmp_P(Console->Args, PSTR("clear"))))
+	  Profiler_ClearSamples();
+
+	Profiler_Resume();
+	return true;
+}
+#endif
+
 /** HID class driver callback function for the creation of HID reports to the host.
  *
  *  \param[in]     HIDInterfaceInfo  Pointer to the HID class interface configuration structure being referenced
@@ -225,25 +1219,63 @@ bool CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDIn
                                          void* ReportData,
                                          uint16_t* const ReportSize)
 {
+	PROBE_BEGIN(PROBE_Report);
+
 	USB_KeyboardReport_Data_t* KeyboardReport = (USB_KeyboardReport_Data_t*)ReportData;
 	*ReportSize = sizeof(USB_KeyboardReport_Data_t);
-	uint8_t UsedKeyCodes = 0;
-	char* ReportString = NULL;
-	static bool ActionSent = false;
 
-	if (hwb_is_pressed())
-		ReportString = "HWB Pressed\r\n";
-	else
-		ActionSent = false;
+	/* Keys taken for a GET_REPORT request would never reach the interrupt endpoint, and the typing state may be half
+	   way through an update by the interrupted keyboard task */
+	if (HIDControlRequest)
+	{
+		memcpy(KeyboardReport, PrevKeyboardHIDReportBuffer, sizeof(USB_KeyboardReport_Data_t));
+
+		PROBE_END(PROBE_Report);
+		return false;
+	}
 
-	if ((ReportString != NULL) && (ActionSent == false))
+	bool ReportChanged = false;
+
+	if (TypingActive)
 	{
-		ActionSent = true;
-		/* Alternatively, without the stream: */
-		CDC_Device_SendString(&VirtualSerial_CDC_Interface, ReportString);
+		/* Keys pasted since the stream last ran dry are only picked up here */
+		SecretStream_Refill(&SecretStream);
+
+		/* Hold the current keys until the report interval has passed, so that the host sees no change */
+		if (KeyboardReportElapsedMS < KeyboardReportIntervalMS)
+		{
+			memcpy(KeyboardReport, PrevKeyboardHIDReportBuffer, sizeof(USB_KeyboardReport_Data_t));
+		}
+		else
+		{
+			ReportChanged = ReportEncoder_CreateReport(&SecretEncoder, &SecretStream,
+			                                           (USB_KeyboardReport_Data_t*)PrevKeyboardHIDReportBuffer, KeyboardReport);
+		}
 	}
 
-	return false;
+	if (ReportChanged)
+	{
+		if (!(TypingTimed))
+		  TypingLatencyMS = (hwb_millis() - TypingStartTime);
+
+		KeyboardReportElapsedMS = 0;
+		TypingTimed = true;
+	}
+
+	if (TypingActive && !(Paste_IsOpen(&PastePipe)) && SecretStream_IsEmpty(&SecretStream) &&
+	    ReportEncoder_IsReleased(KeyboardReport))
+	{
+		TypingActive    = false;
+		TypingTimed     = false;
+		TypingStatsSent = true;
+		QueueTypingStats();
+		led_blue(1);
+	}
+
+	PROBE_END(PROBE_Report);
+
+	/* Only force a send when the keys changed; the class driver resends unchanged reports when the idle period expires */
+	return ReportChanged;
 }
 
 /** HID class driver callback function for the processing of HID reports from the host.
@@ -269,11 +1301,9 @@ void CALLBACK_HID_Device_ProcessHIDReport(USB_ClassInfo_HID_Device_t* const HIDI
  */
 void EVENT_CDC_Device_ControLineStateChanged(USB_ClassInfo_CDC_Device_t *const CDCInterfaceInfo)
 {
-	/* You can get changes to the virtual CDC lines in this callback; a common
-	   use-case is to use the Data Terminal Ready (DTR) flag to enable and
-	   disable CDC communications in your application when set to avoid the
-	   application blocking while waiting for a host to become ready and read
-	   in the pending data from the USB endpoints.
+	/* Use the Data Terminal Ready (DTR) flag to enable and disable CDC communications,
+	   so that queued data is only sent while a host application has the port open
+	   and will read in the pending data from the USB endpoints.
 	*/
-	bool HostReady = (CDCInterfaceInfo->State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR) != 0;
+	HostReady = (CDCInterfaceInfo->State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR) != 0;
 }
@@ -44,9 +44,27 @@
 		#include <stdbool.h>
 		#include <string.h>
 		#include <stdio.h>
+		#include <stdlib.h>
 
+		#include "CDCPipe.h"
+		#include "Console.h"
 		#include "Descriptors.h"
-		#include "Secret.h"
+		#include "EEPROMStore.h"
+		#include "FlashStore.h"
+		#include "Gesture.h"
+		#include "HWif.h"
+		#include "Keymap.h"
+		#include "Paste.h"
+		#include "Probe.h"
+		#include "Profiler.h"
+		#include "Provision.h"
+		#include "ReportEncoder.h"
+		#include "Scheduler.h"
+		#include "Vault.h"
+
+		#if defined(TYPING_BENCHMARK)
+			#include "BenchmarkCorpus.h"
+		#endif
 
 		#include <LUFA/Drivers/Board/LEDs.h>
 		#include <LUFA/Drivers/Board/Buttons.h>
@@ -67,8 +85,67 @@
 		/** LED mask for the library LED driver, to indicate that an error has occurred in the USB interface. */
 		#define LEDMASK_USB_ERROR        (LEDS_LED1 | LEDS_LED3)
 
+		/** Longest interval in milliseconds between keyboard reports, as set by the \c delay command and tried by
+		 *  the typing benchmark. Each press of HWB in a \c TYPING_BENCHMARK build types the benchmark corpus once,
+		 *  then moves to the next interval, wrapping back to \ref KEYBOARD_POLLING_INTERVAL_MS after this one.
+		 */
+		#define TYPING_BENCHMARK_MAX_INTERVAL_MS  8
+
+		/** Entry of the gesture slot table for a gesture which does not type a secret. */
+		#define GESTURE_NO_SLOT                   0xFF
+
+		/** Milliseconds between the lines of the task accounting report queued in a \c SCHEDULER_REPORT build. */
+		#define SCHEDULER_REPORT_PERIOD_MS        250
+
 	/* Function Prototypes: */
 		void SetupHardware(void);
+		void QueueTypingStats(void);
+
+		void TypeGesture(const uint8_t Gesture);
+		bool TypeSlot(const uint8_t Slot);
+		void StartTyping(void);
+		uint8_t GetSlotCount(void);
+
+		bool ListCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool TypeCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool StartStoreWrite(RingBuffer_t* const Output, const uint8_t Slot, const uint8_t* const Data, const uint8_t Length);
+		bool FinishStoreWrite(RingBuffer_t* const Output);
+		bool StoreCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool EraseCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool CheckFlashResult(RingBuffer_t* const Output, const uint8_t Result);
+		bool FinishFlashWrite(RingBuffer_t* const Output);
+		bool FlashBeginCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool FlashDataCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool FlashEraseCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool FlashFormatCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool ProvisionCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool PasteCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool LoopCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool LayoutCommand(Console_t* const Console, RingBuffer_t* const Output);
+		bool DelayCommand(Console_t* const Console, RingBuffer_t* const Output);
+
+		#if defined(CYCLE_PROBES)
+		bool StatsCommand(Console_t* const Console, RingBuffer_t* const Output);
+		#endif
+
+		#if defined(PC_PROFILER)
+		bool ProfileCommand(Console_t* const Console, RingBuffer_t* const Output);
+		#endif
+
+		void USBManagement_Task(void);
+		void Gesture_Task(void);
+		void Keyboard_Task(void);
+		void VirtualSerial_Task(void);
+		void REPL_Task(void);
+		void StatusLED_Task(void);
+
+		#if defined(SCHEDULER_REPORT)
+		void SchedulerReport_Task(void);
+		#endif
+
+		#if defined(TYPING_BENCHMARK)
+		void NextBenchmarkRun(void);
+		#endif
 
 		void EVENT_USB_Device_Connect(void);
 		void EVENT_USB_Device_Disconnect(void);
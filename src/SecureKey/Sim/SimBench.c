@@ -0,0 +1,240 @@
+/** \file
+ *
+ *  Cycle benchmark driver of the simulator build. The firmware is built by avr-gcc as for the device, but against the
+ *  LUFA stubs and the simulated USB host of ../Host, with the HID and CDC class drivers of LUFA itself built over the
+ *  endpoint API of that host, and runs its main loop unchanged under simavr with this driver playing the host: the
+ *  idle run leaves the virtual serial port open with nothing to do, the slot run types slot 0 from a press of HWB,
+ *  and the paste run pastes a text through the \c paste command.
+ *
+ *  The paths of interest are wrapped at link time (see the makefile), and each wrapper marks the entry to and exit
+ *  from its path for SimRun.c, which counts the cycles in between. The simulated host runs inside \c USB_USBTask(),
+ *  so its own cycles are marked as well, to be taken out of the main loop around it.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+/* Built in rather than linked, as in the host build, so that the driver can run the main loop of the firmware */
+#define main SecureKey_Main
+#include "../SecureKey.c"
+#undef main
+
+#include "HostUSB.h"
+#include "SimBench.h"
+
+/** Frames the idle run lasts. */
+#define SIM_BENCH_IDLE_MS          500
+
+/** Frames HWB is held down for a short press. */
+#define SIM_BENCH_PRESS_MS         50
+
+/** Frames a run may take before it is taken to have stalled. */
+#define SIM_BENCH_TIMEOUT_MS       30000
+
+/** Marks the entry to and the exit from a path, a value from \ref SimBenchPaths_t. */
+#define SIM_BENCH_ENTER(Path)      (_SFR_MEM8(SIM_BENCH_ENTER_REG) = (Path))
+#define SIM_BENCH_LEAVE(Path)      (_SFR_MEM8(SIM_BENCH_LEAVE_REG) = (Path))
+
+/** Sends a value from \ref SimBenchControls_t to the runner. */
+#define SIM_BENCH_CONTROL(Control) (_SFR_MEM8(SIM_BENCH_CONTROL_REG) = (Control))
+
+/** Enum for the phases of the benchmark. */
+enum SimBenchPhases_t
+{
+	SIM_BENCH_Open,    /**< Opening the virtual serial port */
+	SIM_BENCH_Idle,    /**< Waiting out the idle run */
+	SIM_BENCH_Press,   /**< Holding HWB down */
+	SIM_BENCH_Typing,  /**< Waiting for the typing statistics of the firmware */
+};
+
+/** Text pasted by the paste run, ended by Ctrl-D (\ref PASTE_END_CHARACTER). */
+static const char SimBench_Paste[] =
+	"paste\r"
+	"The quick brown fox jumps over the lazy dog. THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG!\r\n"
+	"\t~`!@#$%^&*()_+-={}[]|\\:;\"'<>,.?/ 0123456789 aabbccddeeff\r\n"
+	"\x04";
+
+/** HWB edge interrupt handler of HWif.c, raised here for the press of the slot run. */
+void INT7_vect(void);
+
+/** Behaviour of the simulated host. */
+static void SimBench_Frame(void);
+static void SimBench_Report(const USB_KeyboardReport_Data_t* Report);
+
+static const HostUSB_Host_t SimBench_Host =
+	{
+		.PollingIntervalMS = KEYBOARD_POLLING_INTERVAL_MS,
+		.Frame             = SimBench_Frame,
+		.Report            = SimBench_Report,
+	};
+
+/** Run in progress, a value from \ref SimBenchRuns_t. */
+static uint8_t  SimBench_Run;
+
+/** Phase of the benchmark, a value from \ref SimBenchPhases_t. */
+static uint8_t  SimBench_Phase;
+
+/** Frames spent in the current phase. */
+static uint16_t SimBench_PhaseMS;
+
+/** Keyboard reports taken by the host in the current run. */
+static uint16_t SimBench_Reports;
+
+void __real_Scheduler_RunTasks(void);
+void __real_USB_USBTask(void);
+void __real_HID_Device_USBTask(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo);
+void __real_CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo);
+void __real_EVENT_USB_Device_StartOfFrame(void);
+bool __real_CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo,
+                                                uint8_t* const ReportID,
+                                                const uint8_t ReportType,
+                                                void* ReportData,
+                                                uint16_t* const ReportSize);
+
+void __wrap_Scheduler_RunTasks(void)
+{
+	SIM_BENCH_ENTER(SIM_BENCH_PATH_Loop);
+	__real_Scheduler_RunTasks();
+	SIM_BENCH_LEAVE(SIM_BENCH_PATH_Loop);
+}
+
+void __wrap_USB_USBTask(void)
+{
+	SIM_BENCH_ENTER(SIM_BENCH_PATH_Host);
+	__real_USB_USBTask();
+	SIM_BENCH_LEAVE(SIM_BENCH_PATH_Host);
+}
+
+void __wrap_HID_Device_USBTask(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo)
+{
+	SIM_BENCH_ENTER(SIM_BENCH_PATH_HIDTask);
+	__real_HID_Device_USBTask(HIDInterfaceInfo);
+	SIM_BENCH_LEAVE(SIM_BENCH_PATH_HIDTask);
+}
+
+void __wrap_CDC_Device_USBTask(USB_ClassInfo_CDC_Device_t* const CDCInterfaceInfo)
+{
+	SIM_BENCH_ENTER(SIM_BENCH_PATH_CDCTask);
+	__real_CDC_Device_USBTask(CDCInterfaceInfo);
+	SIM_BENCH_LEAVE(SIM_BENCH_PATH_CDCTask);
+}
+
+void __wrap_EVENT_USB_Device_StartOfFrame(void)
+{
+	SIM_BENCH_ENTER(SIM_BENCH_PATH_SOF);
+	__real_EVENT_USB_Device_StartOfFrame();
+	SIM_BENCH_LEAVE(SIM_BENCH_PATH_SOF);
+}
+
+bool __wrap_CALLBACK_HID_Device_CreateHIDReport(USB_ClassInfo_HID_Device_t* const HIDInterfaceInfo,
+                                                uint8_t* const ReportID,
+                                                const uint8_t ReportType,
+                                                void* ReportData,
+                                                uint16_t* const ReportSize)
+{
+	SIM_BENCH_ENTER(SIM_BENCH_PATH_Report);
+	bool ForceSend = __real_CALLBACK_HID_Device_CreateHIDReport(HIDInterfaceInfo, ReportID, ReportType,
+	                                                            ReportData, ReportSize);
+	SIM_BENCH_LEAVE(SIM_BENCH_PATH_Report);
+
+	return ForceSend;
+}
+
+/** Counts the keyboard reports the host takes. */
+static void SimBench_Report(const USB_KeyboardReport_Data_t* Report)
+{
+	SimBench_Reports++;
+}
+
+/** Moves the benchmark to a new phase. */
+static void SimBench_SetPhase(const uint8_t Phase)
+{
+	SimBench_Phase   = Phase;
+	SimBench_PhaseMS = 0;
+	HostUSB_ClearReceived();
+}
+
+/** Starts the next run, or ends the simulation after the last one by sleeping with interrupts disabled. */
+static void SimBench_NextRun(void)
+{
+	SIM_BENCH_CONTROL(SIM_BENCH_CONTROL_NextRun);
+
+	if (SimBench_Phase != SIM_BENCH_Open)
+	  SimBench_Run++;
+
+	SimBench_Reports = 0;
+
+	switch (SimBench_Run)
+	{
+		case SIM_BENCH_RUN_Idle:
+			SimBench_SetPhase(SIM_BENCH_Idle);
+			break;
+		case SIM_BENCH_RUN_Slot:
+			SimBench_SetPhase(SIM_BENCH_Press);
+
+			SIM_BENCH_CONTROL(SIM_BENCH_CONTROL_Press);
+			INT7_vect();
+			break;
+		case SIM_BENCH_RUN_Paste:
+			SimBench_SetPhase(SIM_BENCH_Typing);
+
+			HostUSB_Send(SimBench_Paste, (sizeof(SimBench_Paste) - 1));
+			break;
+		default:
+			cli();
+			sleep_mode();
+			break;
+	}
+}
+
+/** Steps the runs of the benchmark at the end of every frame of the simulated host. */
+static void SimBench_Frame(void)
+{
+	SimBench_PhaseMS++;
+
+	switch (SimBench_Phase)
+	{
+		case SIM_BENCH_Open:
+			HostUSB_OpenPort(true);
+			SimBench_NextRun();
+			break;
+		case SIM_BENCH_Idle:
+			if (SimBench_PhaseMS == SIM_BENCH_IDLE_MS)
+			  SimBench_NextRun();
+
+			break;
+		case SIM_BENCH_Press:
+			if (SimBench_PhaseMS == SIM_BENCH_PRESS_MS)
+			{
+				SIM_BENCH_CONTROL(SIM_BENCH_CONTROL_Release);
+				INT7_vect();
+
+				SimBench_Phase = SIM_BENCH_Typing;
+			}
+
+			break;
+		case SIM_BENCH_Typing:
+			if (strstr(HostUSB_Received(), "Typed ") != NULL)
+			{
+				if (!(SimBench_Reports))
+				  SIM_BENCH_CONTROL(SIM_BENCH_CONTROL_Fail);
+
+				SimBench_NextRun();
+			}
+
+			break;
+	}
+
+	if (SimBench_PhaseMS > SIM_BENCH_TIMEOUT_MS)
+	{
+		SIM_BENCH_CONTROL(SIM_BENCH_CONTROL_Fail);
+		SimBench_NextRun();
+	}
+}
+
+int main(void)
+{
+	HostUSB_Attach(&SimBench_Host);
+	SecureKey_Main();
+}
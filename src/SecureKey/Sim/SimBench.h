@@ -0,0 +1,61 @@
+/** \file
+ *
+ *  Interface between the benchmark driver of SimBench.c, built for the AVR and run under simavr, and the runner of
+ *  SimRun.c which hosts the simulation. The driver marks the paths it measures, and the progress of its runs, by
+ *  writes to the general purpose I/O registers, which no other code of the firmware uses and which the runner
+ *  watches to count the cycles between the marks.
+ */
+
+#ifndef _SIM_BENCH_H_
+#define _SIM_BENCH_H_
+
+	/* Macros: */
+		/** Data space address of GPIOR0, written with a value from \ref SimBenchPaths_t as a path is entered. */
+		#define SIM_BENCH_ENTER_REG        0x3E
+
+		/** Data space address of GPIOR1, written with a value from \ref SimBenchPaths_t as a path is left. */
+		#define SIM_BENCH_LEAVE_REG        0x4A
+
+		/** Data space address of GPIOR2, written with a value from \ref SimBenchControls_t. */
+		#define SIM_BENCH_CONTROL_REG      0x4B
+
+		/** Port and pin of HWB, which the runner drives for the presses of the driver. */
+		#define SIM_BENCH_HWB_PORT         'D'
+		#define SIM_BENCH_HWB_PIN          7
+
+		/** Deepest nesting of marked paths. */
+		#define SIM_BENCH_MAX_DEPTH        8
+
+	/* Enums: */
+		/** Enum for the paths measured by the benchmark. */
+		enum SimBenchPaths_t
+		{
+			SIM_BENCH_PATH_Loop,    /**< A pass of the main loop, \c Scheduler_RunTasks() */
+			SIM_BENCH_PATH_HIDTask, /**< \c HID_Device_USBTask() of the LUFA class driver, report callback included */
+			SIM_BENCH_PATH_Report,  /**< \c CALLBACK_HID_Device_CreateHIDReport() */
+			SIM_BENCH_PATH_CDCTask, /**< \c CDC_Device_USBTask() of the LUFA class driver */
+			SIM_BENCH_PATH_SOF,     /**< \c EVENT_USB_Device_StartOfFrame() */
+			SIM_BENCH_PATH_Host,    /**< \c USB_USBTask(), the simulated host, whose own cycles are taken out of the
+			                         *   paths around it and not reported
+			                         */
+			SIM_BENCH_PATH_COUNT,   /**< Number of paths */
+		};
+
+		/** Enum for the runs of the benchmark, in order. */
+		enum SimBenchRuns_t
+		{
+			SIM_BENCH_RUN_Idle,     /**< Virtual serial port open, nothing typed */
+			SIM_BENCH_RUN_Slot,     /**< Slot 0 typed from a press of HWB */
+			SIM_BENCH_RUN_Paste,    /**< A text pasted through the \c paste command */
+			SIM_BENCH_RUN_COUNT,    /**< Number of runs */
+		};
+
+		/** Enum for the values written to \ref SIM_BENCH_CONTROL_REG. */
+		enum SimBenchControls_t
+		{
+			SIM_BENCH_CONTROL_NextRun = 1, /**< Ends the current run, if any, and starts the next */
+			SIM_BENCH_CONTROL_Press,       /**< Drives HWB low */
+			SIM_BENCH_CONTROL_Release,     /**< Lets HWB go high */
+			SIM_BENCH_CONTROL_Fail,        /**< The current run typed nothing or stalled */
+		};
+#endif
@@ -0,0 +1,416 @@
+/** \file
+ *
+ *  Runner of the simulator benchmark: loads the AVR build of SimBench.c into simavr and counts the cycles of the
+ *  paths the driver marks, per run. Cycles the simulated host spends inside a path, outside any path nested in
+ *  it, are taken out of that path, so that each count is the cost of the firmware code alone.
+ *
+ *  The average and the longest count of every path are compared with a baseline file, and a path which got slower
+ *  than its baseline by more than the tolerance is flagged as a regression. A path the baseline has no count for
+ *  fails the check as well, so that an empty baseline cannot pass as a clean run. The exit status is non-zero if any
+ *  path regressed or went unrecorded, or any run failed.
+ *
+ *  Usage: SimRun [-c core] [-b baseline] [-w baseline] [-t percent] SimBench.elf
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "avr_ioport.h"
+
+#include "SimBench.h"
+
+/** Clock of the simulated part, in Hz, as F_CPU of the firmware. */
+#if !defined(SIM_RUN_F_CPU)
+	#define SIM_RUN_F_CPU          16000000
+#endif
+
+/** Type define for the cycle counts of a path in a run. */
+typedef struct
+{
+	uint32_t Calls;       /**< Times the path was run */
+	uint64_t TotalCycles; /**< Cycles spent in the path */
+	uint32_t MaxCycles;   /**< Longest single run of the path, in cycles */
+	uint32_t BaseAverage; /**< Average cycles of the baseline, or zero when the baseline has none */
+	uint32_t BaseMax;     /**< Longest run of the baseline, in cycles */
+} SimRunPath_t;
+
+/** Type define for a path entered and not yet left. */
+typedef struct
+{
+	uint8_t  Path;        /**< Path, a value from \ref SimBenchPaths_t */
+	uint64_t Entered;     /**< Cycle at which the path was entered */
+	uint64_t HostCycles;  /**< Value of \ref SimRun_HostCycles when the path was entered */
+} SimRunFrame_t;
+
+/** Names of the runs and paths, as printed and as written to the baseline. */
+static const char* const SimRun_RunNames[SIM_BENCH_RUN_COUNT] =
+	{
+		[SIM_BENCH_RUN_Idle]  = "idle",
+		[SIM_BENCH_RUN_Slot]  = "slot",
+		[SIM_BENCH_RUN_Paste] = "paste",
+	};
+
+static const char* const SimRun_PathNames[SIM_BENCH_PATH_COUNT] =
+	{
+		[SIM_BENCH_PATH_Loop]    = "loop",
+		[SIM_BENCH_PATH_HIDTask] = "hid-task",
+		[SIM_BENCH_PATH_Report]  = "report",
+		[SIM_BENCH_PATH_CDCTask] = "cdc-task",
+		[SIM_BENCH_PATH_SOF]     = "sof",
+		[SIM_BENCH_PATH_Host]    = "host",
+	};
+
+/** Simulated part. */
+static avr_t* SimRun_AVR;
+
+/** Cycle counts by run and path. */
+static SimRunPath_t SimRun_Paths[SIM_BENCH_RUN_COUNT][SIM_BENCH_PATH_COUNT];
+
+/** Flags set for the runs the driver failed. */
+static bool SimRun_Failed[SIM_BENCH_RUN_COUNT];
+
+/** Run in progress, or -1 before the first and after the last. */
+static int SimRun_Run = -1;
+
+/** Runs started so far. */
+static int SimRun_Started;
+
+/** Paths entered and not yet left, innermost last. */
+static SimRunFrame_t SimRun_Stack[SIM_BENCH_MAX_DEPTH];
+static uint8_t       SimRun_Depth;
+
+/** Cycles spent by the simulated host outside any path nested in it, and the cycle from which the innermost open
+ *  path has been innermost.
+ */
+static uint64_t SimRun_HostCycles;
+static uint64_t SimRun_InnermostSince;
+
+/** Adds the cycles since the last mark to \ref SimRun_HostCycles if the simulated host was running its own code. */
+static void SimRun_Account(void)
+{
+	if (SimRun_Depth && (SimRun_Stack[SimRun_Depth - 1].Path == SIM_BENCH_PATH_Host))
+	  SimRun_HostCycles += (SimRun_AVR->cycle - SimRun_InnermostSince);
+
+	SimRun_InnermostSince = SimRun_AVR->cycle;
+}
+
+/** Watches GPIOR0 for the entry to a path. */
+static void SimRun_Enter(struct avr_t* AVR, avr_io_addr_t Address, uint8_t Value, void* Param)
+{
+	SimRun_Account();
+
+	if ((Value >= SIM_BENCH_PATH_COUNT) || (SimRun_Depth == SIM_BENCH_MAX_DEPTH))
+	{
+		fprintf(stderr, "bad entry to path %u at depth %u\n", Value, SimRun_Depth);
+		exit(2);
+	}
+
+	SimRun_Stack[SimRun_Depth++] = (SimRunFrame_t){.Path = Value, .Entered = AVR->cycle, .HostCycles = SimRun_HostCycles};
+}
+
+/** Watches GPIOR1 for the exit from a path, adding its cycles to the run in progress. */
+static void SimRun_Leave(struct avr_t* AVR, avr_io_addr_t Address, uint8_t Value, void* Param)
+{
+	SimRun_Account();
+
+	if (!(SimRun_Depth) || (SimRun_Stack[SimRun_Depth - 1].Path != Value))
+	{
+		fprintf(stderr, "bad exit from path %u at depth %u\n", Value, SimRun_Depth);
+		exit(2);
+	}
+
+	SimRunFrame_t* Frame  = &SimRun_Stack[--SimRun_Depth];
+	uint32_t       Cycles = (uint32_t)((AVR->cycle - Frame->Entered) - (SimRun_HostCycles - Frame->HostCycles));
+
+	if ((SimRun_Run < 0) || (Value == SIM_BENCH_PATH_Host))
+	  return;
+
+	SimRunPath_t* Path = &SimRun_Paths[SimRun_Run][Value];
+
+	Path->Calls++;
+	Path->TotalCycles += Cycles;
+
+	if (Cycles > Path->MaxCycles)
+	  Path->MaxCycles = Cycles;
+}
+
+/** Watches GPIOR2 for the commands of the driver. */
+static void SimRun_Control(struct avr_t* AVR, avr_io_addr_t Address, uint8_t Value, void* Param)
+{
+	avr_irq_t* HWB = avr_io_getirq(AVR, AVR_IOCTL_IOPORT_GETIRQ(SIM_BENCH_HWB_PORT), SIM_BENCH_HWB_PIN);
+
+	switch (Value)
+	{
+		case SIM_BENCH_CONTROL_NextRun:
+			SimRun_Run = ((SimRun_Started < SIM_BENCH_RUN_COUNT) ? SimRun_Started++ : -1);
+			break;
+		case SIM_BENCH_CONTROL_Press:
+			avr_raise_irq(HWB, 0);
+			break;
+		case SIM_BENCH_CONTROL_Release:
+			avr_raise_irq(HWB, 1);
+			break;
+		case SIM_BENCH_CONTROL_Fail:
+			if (SimRun_Run >= 0)
+			  SimRun_Failed[SimRun_Run] = true;
+
+			break;
+	}
+}
+
+/** Looks up a run or a path by name, returning -1 if there is none. */
+static int SimRun_Find(const char* const* Names, const int Count, const char* Name)
+{
+	for (int Index = 0; Index < Count; Index++)
+	{
+		if (!(strcmp(Names[Index], Name)))
+		  return Index;
+	}
+
+	return -1;
+}
+
+/** Reads the average and longest counts of a baseline file: a line of run, path, average and maximum per path, with
+ *  lines starting with # ignored. Counts recorded on another core than the one simulated are refused.
+ */
+static bool SimRun_ReadBaseline(const char* FileName, const char* Core)
+{
+	FILE* Baseline = fopen(FileName, "r");
+	char  Line[128];
+
+	if (Baseline == NULL)
+	{
+		perror(FileName);
+		return false;
+	}
+
+	while (fgets(Line, sizeof(Line), Baseline))
+	{
+		char     Run[16], Path[16];
+		unsigned Average, Max;
+
+		if ((sscanf(Line, "# Cycle counts of the simulator benchmark on the %15s core", Run) == 1) && strcmp(Run, Core))
+		{
+			fprintf(stderr, "%s: recorded on the %s core, not %s\n", FileName, Run, Core);
+			fclose(Baseline);
+			return false;
+		}
+
+		if ((Line[0] == '#') || (sscanf(Line, "%15s %15s %u %u", Run, Path, &Average, &Max) != 4))
+		  continue;
+
+		int RunIndex  = SimRun_Find(SimRun_RunNames, SIM_BENCH_RUN_COUNT, Run);
+		int PathIndex = SimRun_Find(SimRun_PathNames, SIM_BENCH_PATH_COUNT, Path);
+
+		if ((RunIndex < 0) || (PathIndex < 0))
+		  continue;
+
+		SimRun_Paths[RunIndex][PathIndex].BaseAverage = Average;
+		SimRun_Paths[RunIndex][PathIndex].BaseMax     = Max;
+	}
+
+	fclose(Baseline);
+	return true;
+}
+
+/** Writes the counts of this simulation as a new baseline file. */
+static bool SimRun_WriteBaseline(const char* FileName, const char* Core)
+{
+	FILE* Baseline = fopen(FileName, "w");
+
+	if (Baseline == NULL)
+	{
+		perror(FileName);
+		return false;
+	}
+
+	fprintf(Baseline, "# Cycle counts of the simulator benchmark on the %s core, written by \"make baseline\"\n", Core);
+	fprintf(Baseline, "# run path average maximum\n");
+
+	for (int Run = 0; Run < SIM_BENCH_RUN_COUNT; Run++)
+	{
+		for (int Index = 0; Index < SIM_BENCH_PATH_COUNT; Index++)
+		{
+			const SimRunPath_t* Path = &SimRun_Paths[Run][Index];
+
+			if (Path->Calls)
+			{
+				fprintf(Baseline, "%s %s %u %u\n", SimRun_RunNames[Run], SimRun_PathNames[Index],
+				        (unsigned)(Path->TotalCycles / Path->Calls), Path->MaxCycles);
+			}
+		}
+	}
+
+	fclose(Baseline);
+	return true;
+}
+
+/** Checks a count against its baseline, giving the flag printed beside it. A missing count only marks the path as
+ *  unrecorded when a baseline file was given, \c Unrecorded being \c NULL otherwise.
+ */
+static const char* SimRun_Compare(const uint32_t Cycles, const uint32_t Baseline, const unsigned Tolerance,
+                                  bool* const Regressed, bool* const Unrecorded)
+{
+	if (!(Baseline))
+	{
+		if (Unrecorded == NULL)
+		  return "new";
+
+		*Unrecorded = true;
+		return "NONE";
+	}
+
+	if (((uint64_t)Cycles * 100) > ((uint64_t)Baseline * (100 + Tolerance)))
+	{
+		*Regressed = true;
+		return "SLOWER";
+	}
+
+	if (((uint64_t)Cycles * (100 + Tolerance)) < ((uint64_t)Baseline * 100))
+	  return "faster";
+
+	return "ok";
+}
+
+int main(int argc, char* argv[])
+{
+	const char* Core         = "atmega1280";
+	const char* BaselineFile = NULL;
+	const char* WriteFile    = NULL;
+	unsigned    Tolerance    = 5;
+	int         Option;
+
+	while ((Option = getopt(argc, argv, "c:b:w:t:")) != -1)
+	{
+		switch (Option)
+		{
+			case 'c':
+				Core = optarg;
+				break;
+			case 'b':
+				BaselineFile = optarg;
+				break;
+			case 'w':
+				WriteFile = optarg;
+				break;
+			case 't':
+				Tolerance = (unsigned)atoi(optarg);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-c core] [-b baseline] [-w baseline] [-t percent] SimBench.elf\n", argv[0]);
+				return 2;
+		}
+	}
+
+	if (optind != (argc - 1))
+	{
+		fprintf(stderr, "Usage: %s [-c core] [-b baseline] [-w baseline] [-t percent] SimBench.elf\n", argv[0]);
+		return 2;
+	}
+
+	elf_firmware_t Firmware;
+
+	memset(&Firmware, 0, sizeof(Firmware));
+
+	if (elf_read_firmware(argv[optind], &Firmware))
+	{
+		fprintf(stderr, "%s: cannot load\n", argv[optind]);
+		return 2;
+	}
+
+	if ((SimRun_AVR = avr_make_mcu_by_name(Core)) == NULL)
+	{
+		fprintf(stderr, "%s: no such simavr core\n", Core);
+		return 2;
+	}
+
+	avr_init(SimRun_AVR);
+	avr_load_firmware(SimRun_AVR, &Firmware);
+	SimRun_AVR->frequency = SIM_RUN_F_CPU;
+
+	avr_register_io_write(SimRun_AVR, SIM_BENCH_ENTER_REG,   SimRun_Enter,   NULL);
+	avr_register_io_write(SimRun_AVR, SIM_BENCH_LEAVE_REG,   SimRun_Leave,   NULL);
+	avr_register_io_write(SimRun_AVR, SIM_BENCH_CONTROL_REG, SimRun_Control, NULL);
+
+	/* HWB idles high, so it reads as released until the driver presses it */
+	avr_raise_irq(avr_io_getirq(SimRun_AVR, AVR_IOCTL_IOPORT_GETIRQ(SIM_BENCH_HWB_PORT), SIM_BENCH_HWB_PIN), 1);
+
+	int State;
+
+	do
+	  State = avr_run(SimRun_AVR);
+	while ((State != cpu_Done) && (State != cpu_Crashed));
+
+	if ((State == cpu_Crashed) || (SimRun_Started < SIM_BENCH_RUN_COUNT))
+	{
+		fprintf(stderr, "simulation ended after %d of %d runs\n", SimRun_Started, SIM_BENCH_RUN_COUNT);
+		return 2;
+	}
+
+	if (WriteFile != NULL)
+	{
+		/* A run which stalled or typed nothing has no counts worth comparing against */
+		for (int Run = 0; Run < SIM_BENCH_RUN_COUNT; Run++)
+		{
+			if (SimRun_Failed[Run])
+			{
+				fprintf(stderr, "%s run failed: typed nothing or stalled; no baseline written\n", SimRun_RunNames[Run]);
+				return 1;
+			}
+		}
+
+		return (SimRun_WriteBaseline(WriteFile, Core) ? 0 : 2);
+	}
+
+	if ((BaselineFile != NULL) && !(SimRun_ReadBaseline(BaselineFile, Core)))
+	  return 2;
+
+	bool  Regressed     = false;
+	bool  Unrecorded    = false;
+	bool* CheckRecorded = ((BaselineFile != NULL) ? &Unrecorded : NULL);
+	bool  Failed        = false;
+
+	printf("%s core at %u MHz, %llu cycles simulated, tolerance %u%%\n\n", Core, (SIM_RUN_F_CPU / 1000000),
+	       (unsigned long long)SimRun_AVR->cycle, Tolerance);
+	printf("%-6s %-9s %8s %9s %9s %8s %9s %9s %-7s %-7s\n",
+	       "run", "path", "calls", "avg cyc", "max cyc", "avg us", "base avg", "base max", "avg", "max");
+
+	for (int Run = 0; Run < SIM_BENCH_RUN_COUNT; Run++)
+	{
+		for (int Index = 0; Index < SIM_BENCH_PATH_COUNT; Index++)
+		{
+			const SimRunPath_t* Path = &SimRun_Paths[Run][Index];
+
+			if (!(Path->Calls))
+			  continue;
+
+			uint32_t Average = (uint32_t)(Path->TotalCycles / Path->Calls);
+
+			printf("%-6s %-9s %8u %9u %9u %8.1f %9u %9u %-7s %-7s\n",
+			       SimRun_RunNames[Run], SimRun_PathNames[Index], Path->Calls, Average, Path->MaxCycles,
+			       (Average * 1000000.0) / SIM_RUN_F_CPU, Path->BaseAverage, Path->BaseMax,
+			       SimRun_Compare(Average, Path->BaseAverage, Tolerance, &Regressed, CheckRecorded),
+			       SimRun_Compare(Path->MaxCycles, Path->BaseMax, Tolerance, &Regressed, CheckRecorded));
+		}
+
+		if (SimRun_Failed[Run])
+		{
+			printf("%-6s failed: typed nothing or stalled\n", SimRun_RunNames[Run]);
+			Failed = true;
+		}
+	}
+
+	if (Regressed)
+	  printf("\nPaths marked SLOWER regressed by more than %u%% against the baseline\n", Tolerance);
+
+	if (Unrecorded)
+	  printf("\nPaths marked NONE have no count in %s; record one with \"make baseline\"\n", BaselineFile);
+
+	return ((Regressed || Unrecorded || Failed) ? 1 : 0);
+}
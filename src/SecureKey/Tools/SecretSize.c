@@ -0,0 +1,40 @@
+/** \file
+ *
+ *  Stand-alone image used by the \c secret-size makefile target to measure the SRAM cost of a secret table.
+ *  It is built once per table length, with the table either left in SRAM (as a plain \c const array is by
+ *  avr-gcc, through the .data section) or placed in FLASH and read through \ref Secret_ReadKey_P().
+ *
+ *  \c SECRET_SIZE_KEYS sets the number of keystrokes in the table, and \c SECRET_SIZE_IN_FLASH selects
+ *  the FLASH placement.
+ */
+
+#include "../SecretStream.h"
+
+#if defined(SECRET_SIZE_IN_FLASH)
+	#define SECRET_SIZE_PLACEMENT PROGMEM
+#else
+	#define SECRET_SIZE_PLACEMENT
+#endif
+
+/** Secret table under measurement; only the first entry is set, which is enough to keep it out of .bss. */
+static const key_t SizeTable[SECRET_SIZE_KEYS] SECRET_SIZE_PLACEMENT =
+{
+	{0x04 /* HID_KEYBOARD_SC_A */, HID_KEYBOARD_MODIFIER_NONE},
+};
+
+/** Index read through a volatile so that the table cannot be optimized away. */
+static volatile uint16_t SizeIndex;
+
+/** Sink for the keys read from the table. */
+volatile key_t SizeKey;
+
+int main(void)
+{
+#if defined(SECRET_SIZE_IN_FLASH)
+	SizeKey = Secret_ReadKey_P(SizeTable, SizeIndex);
+#else
+	SizeKey = SizeTable[SizeIndex];
+#endif
+
+	for (;;);
+}
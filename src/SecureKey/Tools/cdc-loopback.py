@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Measures sustained CDC throughput through the SecureKey echo loop.
+
+Usage: cdc-loopback.py [port] [kilobytes]
+
+Starts the echo with the console 'loop' command, writes a block of random
+bytes to the virtual serial port from one thread, reads the echo back in
+another, checks that every byte came back in order, and reports the
+round-trip rate in KB/s. Closing the port ends the echo. Defaults to
+/dev/ttyACM0 and 256 KB.
+"""
+
+import os
+import sys
+import termios
+import threading
+import time
+import tty
+
+
+def open_port(path):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = termios.B115200  # any non-zero rate; CDC ignores it
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 10
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else "/dev/ttyACM0"
+    size = (int(sys.argv[2]) if len(sys.argv) > 2 else 256) * 1024
+    payload = os.urandom(size)
+    fd = open_port(path)
+
+    os.write(fd, b"\rloop\r")
+    banner = b""
+    while not banner.endswith(b"Echoing until the port closes\r\n"):
+        chunk = os.read(fd, 1)
+        if not chunk:
+            sys.exit("no echo started; is the console running on %s?" % path)
+        banner += chunk
+
+    def writer():
+        view = memoryview(payload)
+        while view:
+            written = os.write(fd, view[:4096])
+            view = view[written:]
+
+    received = bytearray()
+    start = time.monotonic()
+    thread = threading.Thread(target=writer, daemon=True)
+    thread.start()
+    while len(received) < size:
+        chunk = os.read(fd, 4096)
+        if not chunk:
+            sys.exit("timed out after %d of %d bytes" % (len(received), size))
+        received += chunk
+    elapsed = time.monotonic() - start
+    os.close(fd)
+
+    if bytes(received) != payload:
+        first = next(i for i in range(size) if received[i] != payload[i])
+        sys.exit("echo mismatch at byte %d" % first)
+
+    print("%d KB echoed in %.2f s: %.1f KB/s each way" % (size // 1024, elapsed, size / 1024 / elapsed))
+
+
+if __name__ == "__main__":
+    main()
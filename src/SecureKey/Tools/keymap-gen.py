@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""Builds the SecureKey keyboard layout tables, translating ASCII to keys.
+
+Usage: keymap-gen.py > KeymapTables.h
+
+Each layout maps the characters it can type to the HID scancode, named here
+by its position on a US keyboard, and the modifiers which type them. A dead
+key, which only types its accent once followed by another key, is marked
+and typed followed by Space. The firmware indexes the table of the selected
+layout by the character, so each entry is one key_t: the scancode, with
+KEYMAP_DEAD_KEY set for a dead key, and the modifier mask.
+
+The layouts are those of the usual Windows and X11 keymaps of each country:
+US, UK, DE (QWERTZ) and FR (AZERTY). Characters outside 7-bit
+ASCII are left out. vault-pack.py and provision.py load this file to pack
+text for the same layouts on the host.
+"""
+
+import sys
+
+# Must match Keymap.h
+KEYMAP_CHARACTERS = 128
+KEYMAP_DEAD_KEY = 0x80
+LAYOUT_NAMES = ["us", "uk", "de", "fr"]
+
+MODIFIER_NONE = 0x00
+MODIFIER_LEFTSHIFT = 0x02
+MODIFIER_RIGHTALT = 0x40
+
+# Scancodes by their position on a US keyboard
+SC = {ch: 0x04 + i for i, ch in enumerate("abcdefghijklmnopqrstuvwxyz")}
+SC.update({ch: 0x1E + i for i, ch in enumerate("1234567890")})
+SC.update({"enter": 0x28, "escape": 0x29, "backspace": 0x2A, "tab": 0x2B, "space": 0x2C, "-": 0x2D, "=": 0x2E,
+           "[": 0x2F, "]": 0x30, "\\": 0x31, "non-us #": 0x32, ";": 0x33, "'": 0x34, "`": 0x35, ",": 0x36,
+           ".": 0x37, "/": 0x38, "non-us \\": 0x64})
+
+
+def layout(rows, shifted_rows, altgr=(), dead=""):
+    """Builds a layout from the characters on each key, unshifted and shifted, as (US key, characters) pairs,
+    plus those typed with AltGr. Characters listed in 'dead' are on dead keys."""
+    keys = {"\b": (SC["backspace"], MODIFIER_NONE), "\t": (SC["tab"], MODIFIER_NONE),
+            "\n": (SC["enter"], MODIFIER_NONE), "\x1b": (SC["escape"], MODIFIER_NONE),
+            " ": (SC["space"], MODIFIER_NONE)}
+    for modifier, table in ((MODIFIER_NONE, rows), (MODIFIER_LEFTSHIFT, shifted_rows),
+                            (MODIFIER_RIGHTALT, altgr)):
+        for positions, chars in table:
+            for position, ch in zip(positions, chars):
+                if ch != " " and ch not in keys:
+                    keys[ch] = (SC[position], modifier)
+    return {ch: (code | (KEYMAP_DEAD_KEY if ch in dead else 0), mod) for ch, (code, mod) in keys.items()}
+
+
+LETTERS = "abcdefghijklmnopqrstuvwxyz"
+
+
+def moved(positions, moves):
+    """Gives the US key positions of a row whose layout moves some of its characters to other keys."""
+    return [moves.get(position, position) for position in positions]
+
+
+QWERTZ = moved(LETTERS, {"y": "z", "z": "y"})
+AZERTY = moved(LETTERS, {"a": "q", "q": "a", "w": "z", "z": "w", "m": ";"})
+US_PUNCTUATION = ["-", "=", "[", "]", "\\", ";", "'", "`", ",", ".", "/"]
+
+LAYOUTS = {
+    "us": layout(
+        [(LETTERS, LETTERS), ("1234567890", "1234567890"), (US_PUNCTUATION, "-=[]\\;'`,./")],
+        [(LETTERS, LETTERS.upper()), ("1234567890", "!@#$%^&*()"), (US_PUNCTUATION, "_+{}|:\"~<>?")]),
+    "uk": layout(
+        [(LETTERS, LETTERS), ("1234567890", "1234567890"),
+         (["-", "=", "[", "]", "non-us #", ";", "'", "`", ",", ".", "/", "non-us \\"], "-=[]#;'`,./\\")],
+        [(LETTERS, LETTERS.upper()), ("1234567890", "!\" $%^&*()"),
+         (["-", "=", "[", "]", "non-us #", ";", "'", ",", ".", "/", "non-us \\"], "_+{}~:@<>?|")]),
+    "de": layout(
+        [(QWERTZ, LETTERS), ("1234567890", "1234567890"),
+         (["]", "non-us #", ",", ".", "/", "non-us \\", "`"], "+#,.-<^")],
+        [(QWERTZ, LETTERS.upper()), ("1234567890", "!\" $%&/()="),
+         (["-", "=", "]", "non-us #", ",", ".", "/", "non-us \\"], "?`*';:_>")],
+        altgr=[(["q", "7", "8", "9", "0", "-", "]", "non-us \\"], "@{[]}\\~|")],
+        dead="^`"),
+    "fr": layout(
+        [(AZERTY, LETTERS), ("1234567890", "& \"'(- _  "),
+         (["-", "=", "]", "non-us #", "m", ",", ".", "/", "non-us \\"], ")=$*,;:!<")],
+        [(AZERTY, LETTERS.upper()), ("1234567890", "1234567890"),
+         (["=", "m", ",", ".", "'", "non-us \\"], "+?./%>")],
+        altgr=[("234567890-=", "~#{[|`\\^@]}")],
+        dead="~`"),
+}
+
+
+def c_char(ch):
+    names = {"\b": "'\\b'", "\t": "'\\t'", "\n": "'\\n'", "\x1b": "0x1B", "'": "'\\''", "\\": "'\\\\'"}
+    return names.get(ch, "'%s'" % ch)
+
+
+def main():
+    out = sys.stdout
+    out.write("/** \\file\n *\n *  Keyboard layout tables, generated by Tools/keymap-gen.py; do not edit.\n */\n\n")
+    out.write("#ifndef _KEYMAP_TABLES_H_\n#define _KEYMAP_TABLES_H_\n\n")
+    out.write("#include <avr/pgmspace.h>\n#include <stdint.h>\n\n#include \"Keymap.h\"\n\n")
+    out.write("static const key_t KeymapTables[KEYMAP_LAYOUT_COUNT][KEYMAP_CHARACTERS] PROGMEM =\n{\n")
+    for name in LAYOUT_NAMES:
+        keys = LAYOUTS[name]
+        out.write("  {  /* %s, %d characters */\n" % (name, len(keys)))
+        for ch in sorted(keys):
+            code, mod = keys[ch]
+            out.write("    [%-6s] = { .key = 0x%02X, .mod = 0x%02X },\n" % (c_char(ch), code, mod))
+        out.write("  },\n")
+    out.write("};\n\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Types a text file on the host SecureKey is plugged into, through its paste pipe.
+
+Usage: paste.py [port] <file|->
+
+Starts the console 'paste' command, writes the text to the virtual serial
+port and ends it with Ctrl-D, then waits for the typing statistics the
+firmware prints once the last key has been released. The firmware only takes
+text from the port as fast as it types it, so the write simply blocks while
+the keyboard lags behind. LF types Enter and CR is dropped; characters with
+no key on the layout selected by the console 'layout' command are skipped.
+The port defaults to /dev/ttyACM0.
+"""
+
+import os
+import sys
+import termios
+import time
+import tty
+
+PASTE_END = b"\x04"
+
+
+def open_port(path):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = termios.B115200  # any non-zero rate; CDC ignores it
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 10
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+class Lines:
+    """Line reader over the console output, keeping what follows a line for the next one."""
+
+    def __init__(self, fd):
+        self.fd = fd
+        self.pending = b""
+
+    def wait_for(self, markers, timeout):
+        """Returns the next line holding one of the markers, skipping the others."""
+        deadline = time.monotonic() + timeout
+        while True:
+            while b"\n" not in self.pending:
+                if time.monotonic() > deadline:
+                    sys.exit("timed out waiting for the device")
+                self.pending += os.read(self.fd, 256)
+            line, self.pending = self.pending.split(b"\n", 1)
+            line = line.decode(errors="replace").strip()
+            if any(marker in line for marker in markers):
+                return line
+
+
+def write_all(fd, data):
+    view = memoryview(data)
+    while view:
+        view = view[os.write(fd, view):]
+
+
+def main():
+    args = sys.argv[1:]
+    path = args.pop(0) if len(args) == 2 else "/dev/ttyACM0"
+    if len(args) != 1:
+        sys.exit(__doc__)
+    text = sys.stdin.buffer.read() if args[0] == "-" else open(args[0], "rb").read()
+    text = text.replace(PASTE_END, b"")
+
+    fd = open_port(path)
+    lines = Lines(fd)
+    write_all(fd, b"\rpaste\r")
+    reply = lines.wait_for(("Pasting", "Busy"), 2)
+    if "Busy" in reply:
+        sys.exit(reply)
+
+    start = time.monotonic()
+    write_all(fd, text + PASTE_END)
+    stats = lines.wait_for(("Typed",), 60 + len(text) / 100)
+    elapsed = time.monotonic() - start
+    os.close(fd)
+
+    print(stats)
+    print("%d bytes pasted in %.2f s: %.0f chars/s" % (len(text), elapsed, len(text) / elapsed))
+
+
+if __name__ == "__main__":
+    main()
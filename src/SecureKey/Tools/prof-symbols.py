@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""Resolves the sampling profile of a SecureKey PC_PROFILER build to symbols.
+
+Usage: prof-symbols.py <elf> [port|dump-file|-] [clear|<hex base> <shift>]
+
+Build the firmware with 'make PROFILE=Y', run the workload to profile (typing,
+pasting, provisioning), then run this script with the ELF the makefile built.
+With a port (by default /dev/ttyACM0) it runs the console 'prof' command and
+reads the histogram back, passing on 'clear' or a range to narrow the bins
+onto; a dump captured from the console earlier can be given as a file instead,
+or on standard input as '-'.
+
+Each bin covers a range of FLASH addresses, so its samples are shared out
+between the functions overlapping it by the bytes each has in the bin. The
+bins holding most samples are listed with their functions, followed by the
+estimated share of the samples of each function. A narrower range, such as
+'prof-symbols.py SecureKey.elf /dev/ttyACM0 1a00 4', gives 16 byte bins from
+0x1a00 for a finer second pass over the hottest code.
+"""
+
+import collections
+import os
+import re
+import subprocess
+import sys
+import termios
+import time
+import tty
+
+HEADER = re.compile(r"^prof ([0-9a-f]{4}) (\d+) (\d+) (\d+)( full)?$")
+BIN = re.compile(r"^([0-9a-f]{4}) (\d+)$")
+
+
+def open_port(path):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = termios.B115200  # any non-zero rate; CDC ignores it
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 10
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+def read_device(path, args):
+    """Runs the 'prof' command on the device and returns its output, up to the prompt which follows it."""
+    fd = open_port(path)
+    os.write(fd, b"\r" + " ".join(["prof"] + args).encode() + b"\r")
+    output = b""
+    deadline = time.monotonic() + 5
+    while not re.search(rb"\nprof [0-9a-f]{4} .*?\n> ", output, re.S):
+        if time.monotonic() > deadline:
+            sys.exit("timed out waiting for the device; is it a PROFILE=Y build?")
+        output += os.read(fd, 256)
+    os.close(fd)
+    return output.decode(errors="replace")
+
+
+def parse_dump(text):
+    """Returns the base, shift, sample counts and flag of the header, and the count of each bin by address."""
+    header = None
+    bins = {}
+    for line in text.splitlines():
+        line = line.strip()
+        match = HEADER.match(line)
+        if match:
+            header = match
+            bins = {}
+            continue
+        match = BIN.match(line)
+        if header and match:
+            bins[int(match.group(1), 16)] = int(match.group(2))
+    if header is None:
+        sys.exit("no profile in the dump")
+    base, shift, samples, other = (int(header.group(1), 16), int(header.group(2)),
+                                   int(header.group(3)), int(header.group(4)))
+    return base, shift, samples, other, bool(header.group(5)), bins
+
+
+def load_symbols(elf):
+    """Returns the functions of the ELF as (start, end, name), FLASH byte addresses, sorted by start."""
+    nm = os.environ.get("AVR_NM", "avr-nm")
+    listing = subprocess.run([nm, "--numeric-sort", "--print-size", "--defined-only", elf],
+                             check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in listing.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[2] in "tTwW":
+            start = int(fields[0], 16)
+            symbols.append((start, start + int(fields[1], 16), fields[3]))
+        elif len(fields) == 3 and fields[1] in "tTwW":
+            # Labels of assembler code have no size, and are taken to run up to the next symbol
+            symbols.append((int(fields[0], 16), None, fields[2]))
+    symbols.sort(key=lambda symbol: symbol[0])
+    for index, (start, end, name) in enumerate(symbols):
+        if end is None:
+            # A label at the same address as the next symbol is only another name for it, and is dropped
+            following = symbols[index + 1][0] if index + 1 < len(symbols) else start + 2
+            symbols[index] = (start, following, name)
+    return [symbol for symbol in symbols if symbol[1] > symbol[0]]
+
+
+def share_bin(symbols, start, end, count):
+    """Shares the samples of a bin out between the functions overlapping it, by their bytes in the bin."""
+    overlaps = [(min(end, sym_end) - max(start, sym_start), name)
+                for sym_start, sym_end, name in symbols if sym_start < end and sym_end > start]
+    covered = sum(size for size, _ in overlaps)
+    if not covered:
+        return [("(no symbol)", float(count))]
+    return sorted(((name, count * size / covered) for size, name in overlaps), key=lambda share: -share[1])
+
+
+def main():
+    args = sys.argv[1:]
+    if not args:
+        sys.exit(__doc__)
+    elf = args.pop(0)
+    source = args.pop(0) if args and (args[0] == "-" or "/" in args[0] or os.path.exists(args[0])) else "/dev/ttyACM0"
+
+    if source == "-":
+        text = sys.stdin.read()
+    elif source.startswith("/dev/"):
+        text = read_device(source, args)
+    else:
+        text = open(source).read()
+
+    base, shift, samples, other, full, bins = parse_dump(text)
+    symbols = load_symbols(elf)
+    size = 1 << shift
+    counted = sum(bins.values())
+
+    print("%d samples, %d outside %04x-%04x, %d bytes per bin%s"
+          % (samples, other, base, base + 64 * size - 1, size, ", stopped on a full bin" if full else ""))
+    if not counted:
+        return
+
+    print("\n%6s %8s  %-9s  %s" % ("share", "samples", "bin", "functions"))
+    functions = collections.Counter()
+    for start, count in sorted(bins.items(), key=lambda item: -item[1]):
+        shares = share_bin(symbols, start, start + size, count)
+        for name, share in shares:
+            functions[name] += share
+        names = ", ".join("%s %.0f%%" % (name, 100 * share / count) for name, share in shares[:4])
+        print("%5.1f%% %8d  %04x-%04x  %s" % (100.0 * count / counted, count, start, start + size - 1, names))
+
+    print("\n%6s %8s  %s" % ("share", "samples", "function"))
+    for name, share in functions.most_common(20):
+        print("%5.1f%% %8.0f  %s" % (100.0 * share / counted, share, name))
+
+
+if __name__ == "__main__":
+    main()
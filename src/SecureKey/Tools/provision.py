@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+"""Host side of the SecureKey binary provisioning protocol.
+
+Usage: provision.py [port] [--layout us|uk|de|fr] eeprom|flash <slot> <text>
+       provision.py [port] erase-eeprom|erase-flash <slot>
+       provision.py [port] bench [kilobytes]
+
+Writes a slot of the EEPROM or FLASH store with the given text, packed for the
+keyboard layout as by vault-pack.py ('\\n' types Enter, '\\t' Tab), or erases it.
+'bench' streams random data to the null store, which drops it, and reports
+the provisioning rate in KB/s; this measures the framing, CRC and windowed
+acknowledgements over CDC without any store in the way. The port defaults to
+/dev/ttyACM0.
+
+The session is started with the console 'prov' command. Frames are COBS
+encoded and delimited by a zero byte, and hold a type, a sequence number, the
+payload and a CRC-16 (CCITT, initial 0xFFFF, little endian) of the rest. The
+device opens with a hello frame giving the largest payload and the window,
+acknowledges each frame once its data is stored, and asks for a damaged or
+missing frame with a NAK, after which the host resends from that frame on. A
+frame lost with nothing behind it to draw a NAK is resent once the device has
+been quiet for half a second.
+"""
+
+import importlib.util
+import os
+import sys
+import termios
+import time
+import tty
+
+# Must match Provision.h
+FRAME_BEGIN = 0x01
+FRAME_DATA = 0x02
+FRAME_END = 0x03
+FRAME_HELLO = 0x80
+FRAME_ACK = 0x81
+FRAME_NAK = 0x82
+
+STORES = {"eeprom": 0, "flash": 1, "null": 2}
+
+STATUS = ["ok", "busy", "no such slot", "store full", "bootloader cannot write flash", "bad frame",
+          "no record open"]
+
+RECORD_MAX = 0xFFFF
+
+# Times in a row the device may stay silent before a resend from the oldest unacknowledged frame gives up
+RETRIES = 10
+
+
+def crc16(data):
+    """CRC-16/CCITT as computed by avr-libc's _crc_ccitt_update(), from an initial 0xFFFF."""
+    crc = 0xFFFF
+    for byte in data:
+        byte ^= crc & 0xFF
+        byte = (byte ^ (byte << 4)) & 0xFF
+        crc = ((byte << 8) | (crc >> 8)) ^ (byte >> 4) ^ (byte << 3)
+        crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for byte in data:
+        if byte:
+            block.append(byte)
+            if len(block) == 254:
+                out += bytes([255]) + block
+                block = bytearray()
+        else:
+            out += bytes([len(block) + 1]) + block
+            block = bytearray()
+    out += bytes([len(block) + 1]) + block
+    return bytes(out) + b"\x00"
+
+
+def cobs_decode(data):
+    out = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        if code == 0 or index + code > len(data):
+            return None
+        out += data[index + 1:index + code]
+        index += code
+        if code != 255 and index < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def make_frame(kind, seq, payload=b""):
+    body = bytes([kind, seq & 0xFF]) + payload
+    crc = crc16(body)
+    return cobs_encode(body + bytes([crc & 0xFF, crc >> 8]))
+
+
+def open_port(path):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    attrs[4] = attrs[5] = termios.B115200  # any non-zero rate; CDC ignores it
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 5
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+class Link:
+    """Frame reader over the port, keeping the bytes that follow a delimiter for the next frame."""
+
+    def __init__(self, fd):
+        self.fd = fd
+        self.pending = bytearray()
+
+    def read_frame(self):
+        """Returns the (type, first, second) of the next intact device frame, skipping anything else, or None if
+        the device sends nothing for the port timeout."""
+        while True:
+            end = self.pending.find(b"\x00")
+            while end < 0:
+                chunk = os.read(self.fd, 4096)
+                if not chunk:
+                    return None
+                self.pending += chunk
+                end = self.pending.find(b"\x00")
+            raw, self.pending = bytes(self.pending[:end]), self.pending[end + 1:]
+            body = cobs_decode(raw) if raw else None
+            if body and len(body) == 5 and crc16(body[:3]) == body[3] | (body[4] << 8):
+                return body[0], body[1], body[2]
+
+    def write(self, data):
+        view = memoryview(data)
+        while view:
+            view = view[os.write(self.fd, view):]
+
+
+def start_session(link):
+    link.write(b"\rprov\r")
+    while True:
+        frame = link.read_frame()
+        if frame is None:
+            sys.exit("timed out waiting for the device")
+        kind, payload, window = frame
+        if kind == FRAME_HELLO:
+            return payload, window
+
+
+def send_frames(link, frames, window):
+    """Sends the frames with up to 'window' of them unacknowledged, going back to the frame the device NAKs, or to
+    the oldest unacknowledged one if the device goes quiet. Sequence numbers in the responses are cumulative, so a
+    lost acknowledgement is made up for by the next."""
+    encoded = [make_frame(kind, seq, payload) for seq, (kind, payload) in enumerate(frames)]
+    base = sent = 0
+    silent = 0
+    while base < len(encoded):
+        while sent < len(encoded) and sent - base < window:
+            link.write(encoded[sent])
+            sent += 1
+        frame = link.read_frame()
+        if frame is None:
+            silent += 1
+            if silent > RETRIES:
+                sys.exit("timed out waiting for the device")
+            sent = base
+            continue
+        silent = 0
+        kind, seq, status = frame
+        ahead = (seq - base) & 0xFF
+        if kind == FRAME_ACK and 0 < ahead <= sent - base:
+            if status:
+                failed = base + ahead - 1
+                kind_name = {FRAME_BEGIN: "begin", FRAME_DATA: "data", FRAME_END: "end"}[frames[failed][0]]
+                sys.exit("%s frame %d failed: %s" % (kind_name, failed, STATUS[status] if status < len(STATUS) else status))
+            base += ahead
+        elif kind == FRAME_NAK and ahead <= sent - base:
+            base = sent = base + ahead
+
+
+def record_frames(store, slot, data, payload):
+    frames = [(FRAME_BEGIN, bytes([store, slot, len(data) & 0xFF, len(data) >> 8]))]
+    for start in range(0, len(data), payload):
+        frames.append((FRAME_DATA, data[start:start + payload]))
+    return frames
+
+
+def load_vault_pack():
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "vault-pack.py")
+    spec = importlib.util.spec_from_file_location("vault_pack", path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+def main():
+    args = sys.argv[1:]
+    path = args.pop(0) if args and args[0].startswith("/") else "/dev/ttyACM0"
+    layout = "us"
+    if args[:1] == ["--layout"] and len(args) > 1:
+        layout = args[1]
+        del args[:2]
+    if not args:
+        sys.exit(__doc__)
+    command = args.pop(0)
+
+    if command in ("eeprom", "flash") and len(args) == 2:
+        pack = load_vault_pack()
+        if layout not in pack.KEYMAPS.LAYOUTS:
+            sys.exit("unknown layout '%s'" % layout)
+        data = pack.encode_keys(pack.unescape(args[1], "text"), "text", layout)
+        records = [(STORES[command], int(args[0]), data)]
+    elif command in ("erase-eeprom", "erase-flash") and len(args) == 1:
+        records = [(STORES[command[6:]], int(args[0]), b"")]
+    elif command == "bench" and len(args) <= 1:
+        size = (int(args[0]) if args else 64) * 1024
+        data = os.urandom(size)
+        records = [(STORES["null"], 0, data[start:start + RECORD_MAX]) for start in range(0, size, RECORD_MAX)]
+    else:
+        sys.exit(__doc__)
+
+    link = Link(open_port(path))
+    payload, window = start_session(link)
+    frames = []
+    for store, slot, data in records:
+        frames += record_frames(store, slot, data, payload)
+    frames.append((FRAME_END, b""))
+
+    start = time.monotonic()
+    send_frames(link, frames, window)
+    elapsed = time.monotonic() - start
+    os.close(link.fd)
+
+    total = sum(len(data) for _, _, data in records)
+    if command == "bench":
+        print("%d KB provisioned in %.2f s: %.1f KB/s (%d byte payloads, window %d)"
+              % (total // 1024, elapsed, total / 1024 / elapsed, payload, window))
+    else:
+        print("%s slot %s: %d bytes written" % (command, records[0][1], total))
+
+
+if __name__ == "__main__":
+    main()
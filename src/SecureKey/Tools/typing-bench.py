@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""Host side of the SecureKey typing benchmark.
+
+Build the firmware with 'make TYPING_BENCHMARK=Y' (optionally FAST_POLLING=Y),
+run this script in a terminal with keyboard focus and press HWB. Each press
+types the benchmark corpus once; the script times the keystrokes as they
+arrive and counts the keys that went missing or came out wrong. The firmware
+prints its own side of each run (report interval, reports per key, keys/s)
+on the CDC port, and lengthens the report interval by 1 ms after every run.
+
+Press Ctrl-C to stop.
+"""
+
+import difflib
+import sys
+import termios
+import time
+import tty
+
+# Must match BenchmarkCorpus.h
+CORPUS = "The quick brown fox jumps over the lazy dog 1234567890"
+
+
+def read_run(stdin):
+    """Reads one typed corpus up to Enter, returning the text and the seconds between first and last key."""
+    text = []
+    first = last = None
+    while True:
+        ch = stdin.read(1)
+        now = time.monotonic()
+        if ch == "\x03":
+            raise KeyboardInterrupt
+        if first is None:
+            first = now
+        last = now
+        if ch in ("\r", "\n"):
+            return "".join(text), last - first
+        text.append(ch)
+
+
+def dropped_keys(typed):
+    """Counts corpus characters that are missing from, or were replaced in, the typed text."""
+    matcher = difflib.SequenceMatcher(None, CORPUS, typed, autojunk=False)
+    matched = sum(block.size for block in matcher.get_matching_blocks())
+    return len(CORPUS) - matched
+
+
+def main():
+    fd = sys.stdin.fileno()
+    saved = termios.tcgetattr(fd)
+    print("Focus this terminal and press HWB to type the corpus; Ctrl-C to stop.\r")
+    tty.setraw(fd)
+    run = 0
+    try:
+        while True:
+            typed, seconds = read_run(sys.stdin)
+            run += 1
+            keys = len(typed) + 1
+            rate = keys / seconds if seconds > 0 else float("inf")
+            print("run %d: %d keys in %.1f ms, %.0f keys/s, %d dropped\r"
+                  % (run, keys, seconds * 1000, rate, dropped_keys(typed)))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        termios.tcsetattr(fd, termios.TCSADRAIN, saved)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,330 @@
+#!/usr/bin/env python3
+"""Builds the SecureKey secret vault image from a text description.
+
+Each non-empty line of the input that does not start with '#' describes one
+slot, as its name and the text to type, separated by the first ':'. A single
+space after the ':' is ignored. In the text, '\\n' types Enter, '\\t' types Tab
+and '\\\\' types a backslash. Slots are numbered from 0 in file order.
+
+Usage: vault-pack.py [--stored] [--layout us|uk|de|fr] Vault.txt > VaultImage.h
+
+The text is packed into the keys which type it on the keyboard layout of the
+host the key will be used with, US by default (see keymap-gen.py); a
+character on a dead key is typed followed by Space.
+
+The image starts with a header (magic, version, key encoding, slot count,
+dictionary length), followed by a table of SlotCount + 1 record offsets, so
+that the firmware finds the start and length of any slot from two table
+entries. Then comes the preset dictionary, and the records follow back to
+back, each holding its name length, its name and its keys in the packed
+encoding: one byte per key typed alone or with Left Shift (the scancode,
+with bit 7 set for Shift), and a 0x00 escape followed by the modifier and
+scancode bytes for any other key.
+
+The packed keys of each record are compressed (see LZStream.c) against a
+32 byte window of the record's own output and a preset dictionary built from
+the byte strings the records share. The image is left uncompressed when that
+comes out smaller, which is the case for a handful of short slots, or when
+--stored is given. A summary of the sizes is printed on stderr.
+"""
+
+import importlib.util
+import os
+import struct
+import sys
+
+# Must match Vault.h
+VAULT_MAGIC = 0x5356
+VAULT_VERSION = 2
+VAULT_ENCODING_PACKED = 1
+VAULT_ENCODING_PACKED_LZ = 2
+VAULT_NAME_MAX = 15
+VAULT_HEADER_SIZE = 7
+
+# Must match LZStream.h
+LZ_WINDOW_SIZE = 32
+LZ_MIN_MATCH = 3
+LZ_MAX_MATCH = LZ_MIN_MATCH + 0x3F
+LZ_MAX_LITERALS = 0x80
+LZ_TOKEN_MATCH = 0x80
+LZ_TOKEN_DICTIONARY = 0x40
+
+# Longest string considered for the dictionary, and the largest dictionary built
+DICTIONARY_MAX_STRING = 32
+DICTIONARY_LIMIT = 4096
+
+MODIFIER_NONE = 0x00
+MODIFIER_LEFTSHIFT = 0x02
+
+# Must match SecretStream.h
+PACKED_ESCAPE = 0x00
+PACKED_SHIFT = 0x80
+
+
+def load_keymaps():
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "keymap-gen.py")
+    spec = importlib.util.spec_from_file_location("keymap_gen", path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+# Keyboard layouts: ASCII character to (HID scancode, modifier), as typed by the firmware
+KEYMAPS = load_keymaps()
+
+ESCAPES = {"n": "\n", "t": "\t", "\\": "\\"}
+
+
+def unescape(text, where):
+    out = []
+    chars = iter(text)
+    for ch in chars:
+        if ch == "\\":
+            esc = next(chars, None)
+            if esc not in ESCAPES:
+                sys.exit("%s: unknown escape '\\%s'" % (where, esc or ""))
+            ch = ESCAPES[esc]
+        out.append(ch)
+    return "".join(out)
+
+
+def pack_key(key, mod):
+    """Packs a key into one byte when it is typed alone or with Left Shift, and into a 3 byte escape otherwise."""
+    if key < 0x80 and mod == MODIFIER_NONE:
+        return bytes([key])
+    if key < 0x80 and mod == MODIFIER_LEFTSHIFT:
+        return bytes([PACKED_SHIFT | key])
+    return bytes([PACKED_ESCAPE, mod, key])
+
+
+def encode_keys(text, where, layout="us"):
+    keymap = KEYMAPS.LAYOUTS[layout]
+    space = keymap[" "]
+    keys = bytearray()
+    for ch in text:
+        if ch not in keymap:
+            sys.exit("%s: character %r cannot be typed on the %s layout" % (where, ch, layout))
+        code, mod = keymap[ch]
+        keys += pack_key(code & ~KEYMAPS.KEYMAP_DEAD_KEY, mod)
+        if code & KEYMAPS.KEYMAP_DEAD_KEY:
+            keys += pack_key(*space)
+    return bytes(keys)
+
+
+def parse(path):
+    slots = []
+    with open(path) as spec:
+        for number, line in enumerate(spec, 1):
+            line = line.rstrip("\r\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            where = "%s:%d" % (path, number)
+            name, sep, text = line.partition(":")
+            name = name.strip()
+            if not sep or not name:
+                sys.exit("%s: expected 'name: text'" % where)
+            if len(name) > VAULT_NAME_MAX:
+                sys.exit("%s: name longer than %d characters" % (where, VAULT_NAME_MAX))
+            if text.startswith(" "):
+                text = text[1:]
+            slots.append((name, unescape(text, where)))
+    if not slots or len(slots) > 254:
+        sys.exit("%s: between 1 and 254 slots are needed" % path)
+    return slots
+
+
+def build_dictionary(blobs):
+    """Greedily collects the byte strings which save the most when copied from a shared dictionary.
+
+    Each round counts every string of 4 to DICTIONARY_MAX_STRING bytes over the parts of the records not yet
+    covered, and moves the one with the largest saving (3 bytes per copy instead of the string, less the cost
+    of storing it once) into the dictionary.
+    """
+    dictionary = bytearray()
+    work = [list(blob) for blob in blobs]
+
+    while len(dictionary) < DICTIONARY_LIMIT:
+        counts = {}
+        for blob in work:
+            for start in range(len(blob)):
+                for end in range(start + 1, min(start + DICTIONARY_MAX_STRING, len(blob)) + 1):
+                    if blob[end - 1] < 0:
+                        break
+                    if end - start >= 4:
+                        key = tuple(blob[start:end])
+                        counts[key] = counts.get(key, 0) + 1
+
+        best, best_gain = None, 0
+        for key, count in counts.items():
+            gain = count * (len(key) - 3) - len(key)
+            if count > 1 and gain > best_gain:
+                best, best_gain = key, gain
+        if best is None:
+            break
+
+        dictionary += bytes(best)
+        for blob in work:
+            start = 0
+            while start + len(best) <= len(blob):
+                if tuple(blob[start:start + len(best)]) == best:
+                    blob[start:start + len(best)] = [-1] * len(best)
+                    start += len(best)
+                else:
+                    start += 1
+
+    return bytes(dictionary[:DICTIONARY_LIMIT])
+
+
+def compress(data, dictionary):
+    """Compresses a record greedily, taking at each byte the match which saves the most over literals."""
+    out = bytearray()
+    literals = bytearray()
+
+    def flush():
+        while literals:
+            run = literals[:LZ_MAX_LITERALS]
+            out.append(len(run) - 1)
+            out.extend(run)
+            del literals[:len(run)]
+
+    pos = 0
+    while pos < len(data):
+        best_saving, best_token = 0, None
+
+        for distance in range(1, min(LZ_WINDOW_SIZE, pos) + 1):
+            length = 0
+            while (pos + length < len(data) and length < LZ_MAX_MATCH and
+                   data[pos + length] == data[pos - distance + length]):
+                length += 1
+            if length >= LZ_MIN_MATCH and length - 2 > best_saving:
+                best_saving = length - 2
+                best_token = (length, bytes([LZ_TOKEN_MATCH | (length - LZ_MIN_MATCH), distance]))
+
+        prefix = data[pos:pos + LZ_MIN_MATCH]
+        start = dictionary.find(prefix) if len(prefix) == LZ_MIN_MATCH else -1
+        while start >= 0:
+            length = 0
+            while (pos + length < len(data) and start + length < len(dictionary) and length < LZ_MAX_MATCH and
+                   data[pos + length] == dictionary[start + length]):
+                length += 1
+            if length - 3 > best_saving:
+                best_saving = length - 3
+                best_token = (length, bytes([LZ_TOKEN_MATCH | LZ_TOKEN_DICTIONARY | (length - LZ_MIN_MATCH)]) +
+                              struct.pack("<H", start))
+            start = dictionary.find(prefix, start + 1)
+
+        if best_token is None:
+            literals.append(data[pos])
+            pos += 1
+        else:
+            flush()
+            out += best_token[1]
+            pos += best_token[0]
+
+    flush()
+    return bytes(out)
+
+
+def decompress(data, dictionary):
+    """Reference decompressor, used to check every compressed record."""
+    out = bytearray()
+    base = len(out)
+    pos = 0
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        if not token & LZ_TOKEN_MATCH:
+            out += data[pos:pos + token + 1]
+            pos += token + 1
+        elif not token & LZ_TOKEN_DICTIONARY:
+            length, distance = (token & 0x3F) + LZ_MIN_MATCH, data[pos]
+            pos += 1
+            for _ in range(length):
+                out.append(out[len(out) - distance])
+        else:
+            length, start = (token & 0x3F) + LZ_MIN_MATCH, struct.unpack_from("<H", data, pos)[0]
+            pos += 2
+            out += dictionary[start:start + length]
+    return bytes(out[base:])
+
+
+def pack(slots, stored, layout):
+    names = []
+    keys = []
+    for name, text in slots:
+        names.append(name.encode("ascii"))
+        keys.append(encode_keys(text, name, layout))
+
+    encoding, dictionary = VAULT_ENCODING_PACKED, b""
+    if not stored:
+        candidate = build_dictionary(keys)
+        compressed = [compress(blob, candidate) for blob in keys]
+        for blob, packed in zip(keys, compressed):
+            assert decompress(packed, candidate) == blob
+        if len(candidate) + sum(map(len, compressed)) < sum(map(len, keys)):
+            encoding, dictionary, keys = VAULT_ENCODING_PACKED_LZ, candidate, compressed
+
+    records = [bytes([len(name)]) + name + blob for name, blob in zip(names, keys)]
+
+    offsets = []
+    offset = VAULT_HEADER_SIZE + 2 * (len(records) + 1) + len(dictionary)
+    for record in records:
+        offsets.append(offset)
+        offset += len(record)
+    offsets.append(offset)
+    if offset > 0xFFFF:
+        sys.exit("vault image larger than 64 KB")
+
+    image = struct.pack("<HBBBH", VAULT_MAGIC, VAULT_VERSION, encoding, len(records), len(dictionary))
+    image += b"".join(struct.pack("<H", o) for o in offsets)
+    return image + dictionary + b"".join(records), offsets, encoding
+
+
+def main():
+    args = sys.argv[1:]
+    stored = "--stored" in args
+    if stored:
+        args.remove("--stored")
+    layout = "us"
+    if "--layout" in args:
+        index = args.index("--layout")
+        layout = args[index + 1] if index + 1 < len(args) else ""
+        del args[index:index + 2]
+        if layout not in KEYMAPS.LAYOUTS:
+            sys.exit("unknown layout '%s', expected one of %s" % (layout, ", ".join(KEYMAPS.LAYOUT_NAMES)))
+    if len(args) != 1:
+        sys.exit(__doc__)
+
+    slots = parse(args[0])
+    image, offsets, encoding = pack(slots, stored, layout)
+    table_end = VAULT_HEADER_SIZE + 2 * len(offsets)
+    key_bytes = sum(len(encode_keys(text, name, layout)) for name, text in slots)
+    sys.stderr.write("%d slots, %d key bytes packed, %d byte image (%s, %d byte dictionary)\n"
+                     % (len(slots), key_bytes, len(image),
+                        "compressed" if encoding == VAULT_ENCODING_PACKED_LZ else "stored", offsets[0] - table_end))
+
+    out = sys.stdout
+    out.write("/** \\file\n *\n *  Secret vault image, generated by Tools/vault-pack.py from %s; do not edit.\n */\n\n"
+              % args[0].split("/")[-1])
+    out.write("#ifndef _VAULT_IMAGE_H_\n#define _VAULT_IMAGE_H_\n\n")
+    out.write("#include <avr/pgmspace.h>\n#include <stdint.h>\n\n")
+    out.write("/* %d slots, %d bytes */\n" % (len(slots), len(image)))
+    out.write("static const uint8_t VaultImage[] PROGMEM =\n{\n")
+
+    def row(data, comment=None):
+        out.write("  " + " ".join("0x%02X," % b for b in data))
+        out.write("  /* %s */\n" % comment if comment else "\n")
+
+    row(image[:VAULT_HEADER_SIZE], "header")
+    row(image[VAULT_HEADER_SIZE:table_end], "offsets")
+    for start in range(table_end, offsets[0], 16):
+        row(image[start:min(start + 16, offsets[0])], "dictionary" if start == table_end else None)
+    for slot, (name, _) in enumerate(slots):
+        record = image[offsets[slot]:offsets[slot + 1]]
+        for start in range(0, len(record), 16):
+            row(record[start:start + 16], "%d: %s" % (slot, name) if start == 0 else None)
+    out.write("};\n\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()
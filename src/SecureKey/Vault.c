@@ -0,0 +1,143 @@
+/** \file
+ *
+ *  Secret vault, holding many named secrets in a single image in FLASH memory. The offset table after the image
+ *  header gives the bounds of every record, so a slot is located from two table entries and its name length
+ *  whatever its position, without walking the records before it. The image itself is generated from Vault.txt by
+ *  Tools/vault-pack.py, which normally compresses the records against a preset dictionary of the strings they share,
+ *  placed right after the offset table.
+ */
+
+#include "Vault.h"
+#include "VaultImage.h"
+
+/** Header of the vault image. */
+#define VAULT_HEADER         ((const VaultHeader_t*)VaultImage)
+
+/** Offset table of the vault image, following the header. */
+#define VAULT_OFFSETS        ((const uint16_t*)&VaultImage[VAULT_HEADER_SIZE])
+
+/** Decompressor of the slots of a compressed vault image. Only a single secret is typed at a time, so the streams
+ *  opened over vault slots share it, and streams over the other stores need none.
+ */
+static LZStream_t Vault_Decompressor;
+
+/** Checks the header of the vault image, which must match the format and key encoding of this firmware.
+ *
+ *  \return Boolean \c true if the vault image can be read, \c false otherwise
+ */
+bool Vault_IsValid(void)
+{
+	uint8_t Encoding = pgm_read_byte(&VAULT_HEADER->Encoding);
+
+	return ((pgm_read_word(&VAULT_HEADER->Magic) == VAULT_MAGIC) &&
+	        (pgm_read_byte(&VAULT_HEADER->Version) == VAULT_VERSION) &&
+	        ((Encoding == VAULT_ENCODING_PACKED) || (Encoding == VAULT_ENCODING_PACKED_LZ)));
+}
+
+/** Retrieves the number of slots in the vault.
+ *
+ *  \return Number of slots, or zero if the vault image is not valid
+ */
+uint8_t Vault_GetSlotCount(void)
+{
+	if (!(Vault_IsValid()))
+	  return 0;
+
+	return pgm_read_byte(&VAULT_HEADER->SlotCount);
+}
+
+/** Locates the record of a slot in the vault image.
+ *
+ *  \param[in]  Slot  Index of the slot
+ *  \param[out] End   Offset of the end of the record
+ *
+ *  \return Offset of the start of the record, or zero if there is no such slot
+ */
+static uint16_t Vault_FindRecord(const uint8_t Slot, uint16_t* const End)
+{
+	if (Slot >= Vault_GetSlotCount())
+	  return 0;
+
+	*End = pgm_read_word(&VAULT_OFFSETS[Slot + 1]);
+	return pgm_read_word(&VAULT_OFFSETS[Slot]);
+}
+
+/** Opens a stream over the keys of a vault slot.
+ *
+ *  \param[out] Stream  Stream to open
+ *  \param[in]  Slot    Index of the slot to read
+ *
+ *  \return Boolean \c true if the slot exists, \c false otherwise
+ */
+bool Vault_OpenSlot(SecretStream_t* const Stream, const uint8_t Slot)
+{
+	uint16_t End;
+	uint16_t Start = Vault_FindRecord(Slot, &End);
+
+	if (!(Start))
+	  return false;
+
+	Start += 1 + pgm_read_byte(&VaultImage[Start]);
+
+	if (pgm_read_byte(&VAULT_HEADER->Encoding) == VAULT_ENCODING_PACKED_LZ)
+	{
+		uint8_t        SlotCount  = pgm_read_byte(&VAULT_HEADER->SlotCount);
+		const uint8_t* Dictionary = (const uint8_t*)&VAULT_OFFSETS[SlotCount + 1];
+
+		SecretStream_OpenCompressed(Stream, &Vault_Decompressor, &VaultImage[Start], (End - Start),
+		                            Dictionary, pgm_read_word(&VAULT_HEADER->DictionaryLength));
+	}
+	else
+	{
+		SecretStream_Open(Stream, &VaultImage[Start], (End - Start));
+	}
+	return true;
+}
+
+/** Copies the name of a vault slot into a buffer in RAM, truncating it if it does not fit.
+ *
+ *  \param[in]  Slot  Index of the slot
+ *  \param[out] Name  Buffer for the terminated name
+ *  \param[in]  Size  Size of the buffer, at least 1 byte
+ *
+ *  \return Boolean \c true if the slot exists, \c false otherwise
+ */
+bool Vault_GetSlotName(const uint8_t Slot, char* const Name, const uint8_t Size)
+{
+	uint16_t End;
+	uint16_t Start = Vault_FindRecord(Slot, &End);
+
+	if (!(Start))
+	  return false;
+
+	uint8_t Length = pgm_read_byte(&VaultImage[Start]);
+
+	if (Length >= Size)
+	  Length = (Size - 1);
+
+	memcpy_P(Name, &VaultImage[Start + 1], Length);
+	Name[Length] = '\0';
+	return true;
+}
+
+/** Finds a vault slot by name.
+ *
+ *  \param[in] Name  Terminated name of the slot
+ *
+ *  \return Index of the slot, or the slot count of the vault if no slot has the name
+ */
+uint8_t Vault_FindSlot(const char* const Name)
+{
+	uint8_t SlotCount = Vault_GetSlotCount();
+	size_t  Length    = strlen(Name);
+
+	for (uint8_t Slot = 0; Slot < SlotCount; Slot++)
+	{
+		uint16_t Start = pgm_read_word(&VAULT_OFFSETS[Slot]);
+
+		if ((pgm_read_byte(&VaultImage[Start]) == Length) && !(memcmp_P(Name, &VaultImage[Start + 1], Length)))
+		  return Slot;
+	}
+
+	return SlotCount;
+}
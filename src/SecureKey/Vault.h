@@ -0,0 +1,64 @@
+/** \file
+ *
+ *  Header file for Vault.c.
+ */
+
+#ifndef _VAULT_H_
+#define _VAULT_H_
+
+	/* Includes: */
+		#include <avr/io.h>
+		#include <avr/pgmspace.h>
+		#include <stdbool.h>
+		#include <stddef.h>
+		#include <string.h>
+
+		#include "SecretStream.h"
+
+	/* Macros: */
+		/** Magic number at the start of a vault image, "SV" in little endian byte order. */
+		#define VAULT_MAGIC               0x5356
+
+		/** Version of the vault image format. */
+		#define VAULT_VERSION             2
+
+		/** Key encoding of a vault image whose records hold \ref key_t entries, which this firmware no longer reads. */
+		#define VAULT_ENCODING_KEY_T      0
+
+		/** Key encoding of a vault image whose records hold keys in the packed encoding of \ref SecretStream_t. */
+		#define VAULT_ENCODING_PACKED     1
+
+		/** Key encoding of a vault image whose records hold packed keys compressed for \ref LZStream_t, against the
+		 *  preset dictionary of the image.
+		 */
+		#define VAULT_ENCODING_PACKED_LZ  2
+
+		/** Size in bytes of \ref VaultHeader_t as stored in the image, which does not depend on structure packing. */
+		#define VAULT_HEADER_SIZE         7
+
+		/** Maximum length of a slot name, not counting the terminator. */
+		#define VAULT_NAME_MAX            15
+
+	/* Type Defines: */
+		/** Type define for the header at the start of a vault image in FLASH memory. It is followed by a table of
+		 *  \c SlotCount + 1 little endian record offsets, measured from the start of the image, then by the preset
+		 *  dictionary shared by the compressed records, and then by the records themselves, packed back to back. Each
+		 *  record holds the length of the slot name, the name without a terminator and the packed (and possibly
+		 *  compressed) keys of the slot, which run up to the offset of the next record.
+		 */
+		typedef struct
+		{
+			uint16_t Magic;     /**< Magic number, \ref VAULT_MAGIC */
+			uint8_t  Version;   /**< Image format version, \ref VAULT_VERSION */
+			uint8_t  Encoding;  /**< Encoding of the keys in the records */
+			uint8_t  SlotCount; /**< Number of slots in the image */
+			uint16_t DictionaryLength; /**< Length of the preset dictionary in bytes, zero if there is none */
+		} VaultHeader_t;
+
+	/* Function Prototypes: */
+		bool    Vault_IsValid(void);
+		uint8_t Vault_GetSlotCount(void);
+		bool    Vault_OpenSlot(SecretStream_t* const Stream, const uint8_t Slot);
+		bool    Vault_GetSlotName(const uint8_t Slot, char* const Name, const uint8_t Size);
+		uint8_t Vault_FindSlot(const char* const Name);
+#endif
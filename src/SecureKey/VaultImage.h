@@ -0,0 +1,22 @@
+/** \file
+ *
+ *  Secret vault image, generated by Tools/vault-pack.py from Vault.txt; do not edit.
+ */
+
+#ifndef _VAULT_IMAGE_H_
+#define _VAULT_IMAGE_H_
+
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+/* 2 slots, 45 bytes */
+static const uint8_t VaultImage[] PROGMEM =
+{
+  0x56, 0x53, 0x02, 0x01, 0x02, 0x00, 0x00,  /* header */
+  0x0D, 0x00, 0x1A, 0x00, 0x2D, 0x00,  /* offsets */
+  0x06, 0x73, 0x65, 0x63, 0x72, 0x65, 0x74, 0x16, 0x08, 0x06, 0x15, 0x08, 0x17,  /* 0: secret */
+  0x05, 0x6C, 0x6F, 0x67, 0x69, 0x6E, 0x04, 0x07, 0x10, 0x0C, 0x11, 0x2B, 0x16, 0x08, 0x06, 0x15,  /* 1: login */
+  0x08, 0x17, 0x28,
+};
+
+#endif